@@ -0,0 +1,244 @@
+// Copyright 2024 Maria Surani
+#include <benchmark/benchmark.h>
+
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "CatalogGenerator.h"
+#include "Compression.h"
+#include "JsonWriter.h"
+#include "MyFileDatabase.h"
+#include "ResponseCache.h"
+
+// Measures the functions on the request and checkpoint paths that grow with
+// the catalog: rendering courses, departments and the whole catalog, serving
+// them from the response cache, compressing them or writing them as JSON,
+// walking a department's courses, finding a department in the mapping, and
+// writing and reading the whole data file. Catalogs come from
+// CatalogGenerator.
+
+namespace {
+
+const int kCoursesPerDepartment = 100;
+
+std::string dataPath(int courses) {
+  return "catalog_" + std::to_string(courses) + ".bin";
+}
+
+int64_t fileSize(const std::string& path) {
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  return static_cast<int64_t>(in.tellg());
+}
+
+}  // namespace
+
+static void BM_CourseDisplay(benchmark::State& state) {
+  auto mapping = CatalogGenerator(1, 1).generate();
+  const Course& course = mapping.begin()->second.getCourses().front();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(course.display());
+  }
+}
+BENCHMARK(BM_CourseDisplay);
+
+static void BM_DepartmentDisplay(benchmark::State& state) {
+  auto mapping =
+      CatalogGenerator(1, static_cast<int>(state.range(0))).generate();
+  const Department& department = mapping.begin()->second;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(department.display());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DepartmentDisplay)->Arg(10)->Arg(100)->Arg(1000);
+
+// Serves the same departments from ResponseCache: a lookup and a copy of the
+// stored body into the response, as /retrieveDept does on a hit.
+static void BM_DepartmentDisplayCached(benchmark::State& state) {
+  auto mapping =
+      CatalogGenerator(1, static_cast<int>(state.range(0))).generate();
+  const Department& department = mapping.begin()->second;
+  ResponseCache cache;
+  cache.storeDepartment("D0", department.display());
+  std::string response;
+  for (auto _ : state) {
+    response.clear();
+    response += *cache.findDepartment("D0");
+    benchmark::DoNotOptimize(response.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DepartmentDisplayCached)->Arg(10)->Arg(100)->Arg(1000);
+
+// Compresses the same departments with gzip, the work a compressed
+// /retrieveDept response would repeat on every request were the compressed
+// body not cached; a cached one costs the same as BM_DepartmentDisplayCached.
+static void BM_DepartmentCompress(benchmark::State& state) {
+  auto mapping =
+      CatalogGenerator(1, static_cast<int>(state.range(0))).generate();
+  const std::string body = mapping.begin()->second.display();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(compress(body, ContentEncoding::Gzip));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["ratio"] = static_cast<double>(body.size()) /
+                            compress(body, ContentEncoding::Gzip).size();
+}
+BENCHMARK(BM_DepartmentCompress)->Arg(10)->Arg(100)->Arg(1000);
+
+// Writes the same departments as JSON into a reused buffer, as
+// /retrieveDept does into its response body for Accept: application/json.
+static void BM_DepartmentWriteJson(benchmark::State& state) {
+  auto mapping =
+      CatalogGenerator(1, static_cast<int>(state.range(0))).generate();
+  const Department& department = mapping.begin()->second;
+  std::string response;
+  for (auto _ : state) {
+    response.clear();
+    JsonWriter writer(&response);
+    department.writeJson(writer);
+    benchmark::DoNotOptimize(response.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DepartmentWriteJson)->Arg(10)->Arg(100)->Arg(1000);
+
+// Renders a whole catalog into one string, as display() does, against
+// writing it to a stream one department at a time, as /catalog does into its
+// export file from a snapshot of the catalog in data-file form. The second
+// keeps only one department's text in memory.
+static void BM_CatalogDisplay(benchmark::State& state) {
+  MyFileDatabase database(1, "");
+  database.setMapping(CatalogGenerator(static_cast<int>(state.range(0)),
+                                       kCoursesPerDepartment)
+                          .generate());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(database.display());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) *
+                          kCoursesPerDepartment);
+}
+BENCHMARK(BM_CatalogDisplay)->Arg(10)->Arg(100)->Unit(benchmark::kMillisecond);
+
+static void BM_CatalogWriteCatalog(benchmark::State& state) {
+  MyFileDatabase database(1, "");
+  database.setMapping(CatalogGenerator(static_cast<int>(state.range(0)),
+                                       kCoursesPerDepartment)
+                          .generate());
+  std::ofstream out("/dev/null", std::ios::binary);
+  for (auto _ : state) {
+    MyFileDatabase::CatalogSnapshot snapshot;
+    {
+      auto locks = database.acquireAllReadLocks();
+      snapshot = database.snapshotCatalog();
+    }
+    MyFileDatabase::writeCatalog(out, snapshot, false);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) *
+                          kCoursesPerDepartment);
+}
+BENCHMARK(BM_CatalogWriteCatalog)
+    ->Arg(10)
+    ->Arg(100)
+    ->Unit(benchmark::kMillisecond);
+
+// The part of an export during which writers are blocked, before any
+// checkpoint and right after one, when every department shares the block
+// the checkpoint kept.
+static void BM_CatalogSnapshot(benchmark::State& state) {
+  int courses = static_cast<int>(state.range(0));
+  MyFileDatabase database(1, dataPath(courses));
+  database.setMapping(
+      CatalogGenerator(courses / kCoursesPerDepartment, kCoursesPerDepartment)
+          .generate());
+  if (state.range(1) != 0) database.saveContentsToFile();
+  for (auto _ : state) {
+    auto locks = database.acquireAllReadLocks();
+    benchmark::DoNotOptimize(database.snapshotCatalog());
+  }
+  state.SetItemsProcessed(state.iterations() * courses);
+}
+BENCHMARK(BM_CatalogSnapshot)
+    ->Args({1000, 0})
+    ->Args({10000, 0})
+    ->Args({1000, 1})
+    ->Args({10000, 1})
+    ->Unit(benchmark::kMillisecond);
+
+// Walks every course of a department, as the former getCourseSelection()
+// callers did, through the parallel number and course arrays.
+static void BM_DepartmentCourseSelection(benchmark::State& state) {
+  auto mapping =
+      CatalogGenerator(1, static_cast<int>(state.range(0))).generate();
+  const Department& department = mapping.begin()->second;
+  for (auto _ : state) {
+    const auto& numbers = department.getCourseNumbers();
+    const auto& courses = department.getCourses();
+    int64_t enrolled = 0;
+    for (size_t i = 0; i < numbers.size(); ++i) {
+      enrolled += numbers[i] + courses[i].getEnrolledStudentCount();
+    }
+    benchmark::DoNotOptimize(enrolled);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DepartmentCourseSelection)->Arg(10)->Arg(100)->Arg(1000);
+
+static void BM_GetDepartmentMapping(benchmark::State& state) {
+  int departments = static_cast<int>(state.range(0));
+  CatalogGenerator catalog(departments, 10);
+  MyFileDatabase database(1, "");
+  database.setMapping(catalog.generate());
+  std::mt19937 generator(4156);
+  for (auto _ : state) {
+    std::string deptCode =
+        catalog.getDeptCode(static_cast<int>(generator() % departments));
+    auto lock = database.acquireReadLock(deptCode);
+    const auto& mapping = database.getDepartmentMapping();
+    benchmark::DoNotOptimize(mapping.find(deptCode));
+  }
+}
+BENCHMARK(BM_GetDepartmentMapping)->Arg(5)->Arg(100)->Arg(10000);
+
+static void BM_SaveContentsToFile(benchmark::State& state) {
+  int courses = static_cast<int>(state.range(0));
+  MyFileDatabase database(1, dataPath(courses));
+  database.setMapping(
+      CatalogGenerator(courses / kCoursesPerDepartment, kCoursesPerDepartment)
+          .generate());
+  for (auto _ : state) {
+    database.saveContentsToFile();
+  }
+  state.SetItemsProcessed(state.iterations() * courses);
+  state.SetBytesProcessed(state.iterations() * fileSize(dataPath(courses)));
+}
+BENCHMARK(BM_SaveContentsToFile)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_DeSerializeObjectFromFile(benchmark::State& state) {
+  int courses = static_cast<int>(state.range(0));
+  {
+    MyFileDatabase writer(1, dataPath(courses));
+    writer.setMapping(CatalogGenerator(courses / kCoursesPerDepartment,
+                                       kCoursesPerDepartment)
+                          .generate());
+    writer.saveContentsToFile();
+  }
+  MyFileDatabase database(0, dataPath(courses));
+  for (auto _ : state) {
+    database.deSerializeObjectFromFile();
+  }
+  state.SetItemsProcessed(state.iterations() * courses);
+  state.SetBytesProcessed(state.iterations() * fileSize(dataPath(courses)));
+}
+BENCHMARK(BM_DeSerializeObjectFromFile)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
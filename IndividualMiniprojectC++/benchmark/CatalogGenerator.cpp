@@ -0,0 +1,113 @@
+// Copyright 2024 Maria Surani
+#include "CatalogGenerator.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+
+namespace {
+
+const int kCoursesPerRoom = 8;
+const char* const kBuildings[] = {"MUDD",  "HAV",   "IAB",      "NWC",
+                                  "PUPIN", "URIS",  "CHANDLER", "SCHERMERHORN",
+                                  "MATH",  "LEWISOHN"};
+const int kBuildingCount = sizeof(kBuildings) / sizeof(kBuildings[0]);
+const char* const kDays[] = {"MW ", "TR ", "MWF ", "F "};
+
+std::string clock(int minute) {
+  std::string minutes = std::to_string(minute % 60);
+  return std::to_string(minute / 60) + ":" +
+         (minutes.size() == 1 ? "0" + minutes : minutes);
+}
+
+}  // namespace
+
+/**
+ * Creates a generator for a catalog of the given size.
+ *
+ * @param departmentCount      the number of departments
+ * @param coursesPerDepartment the number of courses in each department
+ * @param seed                 the seed of the random attributes
+ */
+CatalogGenerator::CatalogGenerator(int departmentCount,
+                                   int coursesPerDepartment, unsigned seed)
+    : departmentCount(departmentCount),
+      coursesPerDepartment(coursesPerDepartment),
+      roomCount(std::max(1, departmentCount * coursesPerDepartment /
+                                kCoursesPerRoom)),
+      seed(seed) {}
+
+/**
+ * Builds the catalog.
+ *
+ * @return the departments, keyed by department code
+ */
+std::map<std::string, Department> CatalogGenerator::generate() const {
+  std::mt19937 generator(seed);
+  std::map<std::string, Department> mapping;
+  for (int d = 0; d < departmentCount; ++d) {
+    std::map<int, Course> courses;
+    for (int c = 0; c < coursesPerDepartment; ++c) {
+      int capacity = 50 + static_cast<int>(generator() % 201);
+      Course course(capacity,
+                    "Instructor " + std::to_string(d) + "-" +
+                        std::to_string(c % 20),
+                    getLocation(static_cast<int>(generator() % roomCount)),
+                    getTimeSlot(generator()));
+      course.setEnrolledStudentCount(
+          static_cast<int>(generator() % (capacity + 1)));
+      courses.emplace(getCourseNumber(c), course);
+    }
+    std::string deptCode = getDeptCode(d);
+    mapping.emplace(deptCode,
+                    Department(deptCode, courses, "Chair " + std::to_string(d),
+                               100 + static_cast<int>(generator() % 900)));
+  }
+  return mapping;
+}
+
+/**
+ * Gets the code of a department.
+ *
+ * @param department the department's index, from 0
+ * @return the department code, e.g. "D12"
+ */
+std::string CatalogGenerator::getDeptCode(int department) const {
+  return "D" + std::to_string(department);
+}
+
+/**
+ * Gets the number of a course within its department.
+ *
+ * @param course the course's index, from 0
+ * @return the course number
+ */
+int CatalogGenerator::getCourseNumber(int course) const {
+  return 1000 + course;
+}
+
+/**
+ * Gets the name of a room.
+ *
+ * @param room the room's index, from 0
+ * @return the location, e.g. "312 MUDD"
+ */
+std::string CatalogGenerator::getLocation(int room) const {
+  return std::to_string(100 + room / kBuildingCount) + " " +
+         kBuildings[room % kBuildingCount];
+}
+
+/**
+ * Picks a time slot. Start times are spread over the teaching day in
+ * five-minute steps, and courses last 50 to 150 minutes on one of the usual
+ * day patterns.
+ *
+ * @param random a random number that selects the slot
+ * @return the time slot, e.g. "TR 10:10-11:25"
+ */
+std::string CatalogGenerator::getTimeSlot(unsigned random) const {
+  int start = 8 * 60 + 5 * static_cast<int>(random % 144);
+  int end = start + 50 + 25 * static_cast<int>(random / 144 % 5);
+  return kDays[random / 720 % 4] + clock(start) + "-" + clock(end);
+}
@@ -0,0 +1,39 @@
+#ifndef CATALOGGENERATOR_H
+#define CATALOGGENERATOR_H
+
+#include <map>
+#include <string>
+
+#include "Department.h"
+
+/**
+ * Generates synthetic catalogs of any size for the benchmarks and the load
+ * test. Departments are named D0, D1, ... and number their courses from
+ * 1000. Capacities, enrollments, time slots and rooms are drawn from a seeded
+ * generator, so the same parameters always give the same catalog, and rooms
+ * are shared by about eight courses each so that the room and time slot
+ * indexes see realistic overlaps.
+ */
+class CatalogGenerator {
+ public:
+  CatalogGenerator(int departmentCount, int coursesPerDepartment,
+                   unsigned seed = 4156);
+
+  std::map<std::string, Department> generate() const;
+
+  std::string getDeptCode(int department) const;
+  int getCourseNumber(int course) const;
+  std::string getLocation(int room) const;
+  std::string getTimeSlot(unsigned random) const;
+  int getDepartmentCount() const { return departmentCount; }
+  int getCoursesPerDepartment() const { return coursesPerDepartment; }
+  int getRoomCount() const { return roomCount; }
+
+ private:
+  int departmentCount;
+  int coursesPerDepartment;
+  int roomCount;
+  unsigned seed;
+};
+
+#endif
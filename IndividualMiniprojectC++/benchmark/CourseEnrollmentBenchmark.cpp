@@ -0,0 +1,70 @@
+// Copyright 2024 Maria Surani
+#include <benchmark/benchmark.h>
+
+#include <climits>
+#include <mutex>
+
+#include "Course.h"
+
+// Measures enrollment throughput as more threads hammer the same course, the
+// way registration day traffic concentrates on a few popular sections.
+
+namespace {
+
+Course popularCourse(INT_MAX, "Adam Cannon", "417 IAB", "11:40-12:55");
+
+// Baseline: the same admission check guarded by a mutex instead of a CAS.
+std::mutex lockedMutex;
+int lockedCount = 0;
+const int lockedCapacity = INT_MAX;
+
+bool lockedEnroll() {
+  std::lock_guard<std::mutex> guard(lockedMutex);
+  if (lockedCount >= lockedCapacity) return false;
+  lockedCount++;
+  return true;
+}
+
+bool lockedDrop() {
+  std::lock_guard<std::mutex> guard(lockedMutex);
+  if (lockedCount <= 0) return false;
+  lockedCount--;
+  return true;
+}
+
+}  // namespace
+
+static void BM_LockFreeEnrollDrop(benchmark::State& state) {
+  if (state.thread_index() == 0) popularCourse.setEnrolledStudentCount(0);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(popularCourse.enrollStudent());
+    benchmark::DoNotOptimize(popularCourse.dropStudent());
+  }
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_LockFreeEnrollDrop)->ThreadRange(1, 64)->UseRealTime();
+
+static void BM_MutexEnrollDrop(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lockedEnroll());
+    benchmark::DoNotOptimize(lockedDrop());
+  }
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_MutexEnrollDrop)->ThreadRange(1, 64)->UseRealTime();
+
+// Many threads racing for the last seats of a nearly full course.
+static void BM_LockFreeEnrollUntilFull(benchmark::State& state) {
+  static Course nearlyFull(400, "Victor G. Moffat", "630 MUDD", "4:10-5:25");
+  for (auto _ : state) {
+    // Once the course fills up, the first thread reopens every seat
+    if (!nearlyFull.enrollStudent() && state.thread_index() == 0) {
+      nearlyFull.setEnrolledStudentCount(0);
+    }
+  }
+  if (nearlyFull.getEnrolledStudentCount() > 400) {
+    state.SkipWithError("enrollment capacity was exceeded");
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LockFreeEnrollUntilFull)->ThreadRange(1, 64)->UseRealTime();
@@ -0,0 +1,88 @@
+// Copyright 2024 Maria Surani
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "CatalogGenerator.h"
+#include "CourseIndex.h"
+
+// Measures how long it takes to find the courses an instructor teaches, for
+// catalogs of growing size, by scanning every course and through
+// CourseIndex, and how long building the index takes when a catalog is
+// loaded. Each generated instructor teaches five courses.
+
+namespace {
+
+const int kCoursesPerDepartment = 100;
+
+CatalogGenerator makeCatalog(const benchmark::State& state) {
+  return CatalogGenerator(
+      static_cast<int>(state.range(0)) / kCoursesPerDepartment,
+      kCoursesPerDepartment);
+}
+
+std::string randomInstructor(const CatalogGenerator& catalog,
+                             std::mt19937* generator) {
+  return "Instructor " +
+         std::to_string((*generator)() % catalog.getDepartmentCount()) + "-" +
+         std::to_string((*generator)() % 20);
+}
+
+}  // namespace
+
+static void BM_CoursesByInstructorScan(benchmark::State& state) {
+  CatalogGenerator catalog = makeCatalog(state);
+  auto mapping = catalog.generate();
+  std::mt19937 generator(1004);
+  for (auto _ : state) {
+    std::string instructor = randomInstructor(catalog, &generator);
+    std::vector<CourseIndex::Match> result;
+    for (const auto& it : mapping) {
+      const auto& numbers = it.second.getCourseNumbers();
+      const auto& courses = it.second.getCourses();
+      for (size_t i = 0; i < courses.size(); ++i) {
+        if (courses[i].getInstructorName() == instructor) {
+          result.push_back({it.first, numbers[i]});
+        }
+      }
+    }
+    benchmark::DoNotOptimize(result.data());
+  }
+}
+BENCHMARK(BM_CoursesByInstructorScan)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_CoursesByInstructorIndex(benchmark::State& state) {
+  CatalogGenerator catalog = makeCatalog(state);
+  CourseIndex index(&Course::getInstructorName);
+  index.rebuild(catalog.generate());
+  std::mt19937 generator(1004);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        index.findCourses(randomInstructor(catalog, &generator)));
+  }
+}
+BENCHMARK(BM_CoursesByInstructorIndex)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_CourseIndexRebuild(benchmark::State& state) {
+  auto mapping = makeCatalog(state).generate();
+  CourseIndex index(&Course::getInstructorName);
+  for (auto _ : state) {
+    index.rebuild(mapping);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CourseIndexRebuild)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
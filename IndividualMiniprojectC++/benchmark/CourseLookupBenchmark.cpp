@@ -0,0 +1,69 @@
+// Copyright 2024 Maria Surani
+#include <benchmark/benchmark.h>
+
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Department.h"
+
+// Measures the latency of looking up a course by the number a route parsed
+// from its query string, for departments of growing size. The baseline is
+// the former layout: a string-keyed std::map of individually allocated
+// courses, which needs std::to_string before every lookup.
+
+namespace {
+
+const int kFirstCourseNumber = 1000;
+const int kLookups = 4096;
+
+std::vector<int> randomCourseNumbers(int courses) {
+  std::mt19937 generator(4156);
+  std::uniform_int_distribution<int> pick(kFirstCourseNumber,
+                                          kFirstCourseNumber + courses - 1);
+  std::vector<int> numbers(kLookups);
+  for (int& number : numbers) number = pick(generator);
+  return numbers;
+}
+
+Course makeCourse(int i) {
+  return Course(100, "Instructor " + std::to_string(i % 50),
+                std::to_string(i % 30) + " MUDD", "10:10-11:25");
+}
+
+}  // namespace
+
+static void BM_LookupStringKeyedMap(benchmark::State& state) {
+  int courses = static_cast<int>(state.range(0));
+  std::map<std::string, std::shared_ptr<Course>> courseSelection;
+  for (int i = 0; i < courses; ++i) {
+    courseSelection[std::to_string(kFirstCourseNumber + i)] =
+        std::make_shared<Course>(makeCourse(i));
+  }
+  std::vector<int> numbers = randomCourseNumbers(courses);
+  size_t next = 0;
+  for (auto _ : state) {
+    int courseNumber = numbers[next++ % numbers.size()];
+    auto it = courseSelection.find(std::to_string(courseNumber));
+    benchmark::DoNotOptimize(it->second->getEnrolledStudentCount());
+  }
+}
+BENCHMARK(BM_LookupStringKeyedMap)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000);
+
+static void BM_LookupDepartment(benchmark::State& state) {
+  int courses = static_cast<int>(state.range(0));
+  Department department("COMS", {}, "Luca Carloni", 2700);
+  for (int i = 0; i < courses; ++i) {
+    department.addCourse(kFirstCourseNumber + i, makeCourse(i));
+  }
+  std::vector<int> numbers = randomCourseNumbers(courses);
+  size_t next = 0;
+  for (auto _ : state) {
+    int courseNumber = numbers[next++ % numbers.size()];
+    const Course* course = department.findCourse(courseNumber);
+    benchmark::DoNotOptimize(course->getEnrolledStudentCount());
+  }
+}
+BENCHMARK(BM_LookupDepartment)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000);
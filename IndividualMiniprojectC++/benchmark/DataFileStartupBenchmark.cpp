@@ -0,0 +1,114 @@
+// Copyright 2024 Maria Surani
+#include <benchmark/benchmark.h>
+
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+
+#include "MappedDataFile.h"
+#include "MyFileDatabase.h"
+
+// Compares how long the service takes to load its data file in the original
+// stream format and in the memory-mapped format, and how long it takes to
+// open a mapped file and read one course without loading the rest of it.
+
+namespace {
+
+const int kCoursesPerDepartment = 100;
+
+std::string legacyPath(int courses) {
+  return "startup_v1_" + std::to_string(courses) + ".bin";
+}
+
+std::string mappedPath(int courses) {
+  return "startup_v2_" + std::to_string(courses) + ".bin";
+}
+
+std::map<std::string, Department> makeCatalog(int courses) {
+  std::map<std::string, Department> mapping;
+  for (int d = 0; d * kCoursesPerDepartment < courses; ++d) {
+    std::map<int, Course> courseSelection;
+    for (int c = 0; c < kCoursesPerDepartment; ++c) {
+      Course course(150, "Instructor " + std::to_string(c),
+                    std::to_string(300 + c) + " MUDD", "10:10-11:25");
+      course.setEnrolledStudentCount(c);
+      courseSelection[1000 + c] = course;
+    }
+    std::string deptCode = "D" + std::to_string(d);
+    mapping.emplace(deptCode, Department(deptCode, courseSelection,
+                                         "Chair " + std::to_string(d), 500));
+  }
+  return mapping;
+}
+
+// Writes both files for a catalog size once per process.
+void prepareFiles(int courses) {
+  static std::set<int> prepared;
+  if (!prepared.insert(courses).second) return;
+  auto mapping = makeCatalog(courses);
+
+  std::ofstream out(legacyPath(courses), std::ios::binary | std::ios::trunc);
+  size_t mapSize = mapping.size();
+  out.write(reinterpret_cast<const char*>(&mapSize), sizeof(mapSize));
+  for (const auto& it : mapping) {
+    size_t keyLen = it.first.length();
+    out.write(reinterpret_cast<const char*>(&keyLen), sizeof(keyLen));
+    out.write(it.first.c_str(), keyLen);
+    it.second.serialize(out);
+  }
+  out.close();
+
+  MyFileDatabase mapped(1, mappedPath(courses));
+  mapped.setMapping(mapping);
+  mapped.saveContentsToFile();
+}
+
+}  // namespace
+
+static void BM_StartupLegacyFormat(benchmark::State& state) {
+  int courses = static_cast<int>(state.range(0));
+  prepareFiles(courses);
+  for (auto _ : state) {
+    MyFileDatabase database(0, legacyPath(courses));
+    benchmark::DoNotOptimize(database.findDepartment("D0"));
+  }
+  state.SetItemsProcessed(state.iterations() * courses);
+}
+BENCHMARK(BM_StartupLegacyFormat)
+    ->Arg(1000)
+    ->Arg(100000)
+    ->Arg(1000000)
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_StartupMappedFormat(benchmark::State& state) {
+  int courses = static_cast<int>(state.range(0));
+  prepareFiles(courses);
+  for (auto _ : state) {
+    MyFileDatabase database(0, mappedPath(courses));
+    benchmark::DoNotOptimize(database.findDepartment("D0"));
+  }
+  state.SetItemsProcessed(state.iterations() * courses);
+}
+BENCHMARK(BM_StartupMappedFormat)
+    ->Arg(1000)
+    ->Arg(100000)
+    ->Arg(1000000)
+    ->Unit(benchmark::kMillisecond);
+
+// Opening the mapping only checks the header and the department directory,
+// so this grows with the number of departments, not with the whole file.
+static void BM_OpenMappedFileAndReadCourse(benchmark::State& state) {
+  int courses = static_cast<int>(state.range(0));
+  prepareFiles(courses);
+  for (auto _ : state) {
+    MappedDataFile file(mappedPath(courses));
+    Course course;
+    benchmark::DoNotOptimize(file.readCourse("D0", 1042, course));
+  }
+}
+BENCHMARK(BM_OpenMappedFileAndReadCourse)
+    ->Arg(1000)
+    ->Arg(100000)
+    ->Arg(1000000)
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,77 @@
+// Copyright 2024 Maria Surani
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <map>
+#include <shared_mutex>
+#include <string>
+
+#include "Department.h"
+#include "MyFileDatabase.h"
+#include "ShardedCounter.h"
+
+// Measures the throughput of adding majors as more threads hammer the same
+// department, the way declaration day traffic concentrates on a few popular
+// ones.
+
+namespace {
+
+ShardedCounter shardedCount;
+std::atomic<int64_t> atomicCount(0);
+
+// Baseline: the single counter and department write lock that
+// /addMajorToDept used before.
+std::shared_timed_mutex lockedMutex;
+int lockedCount = 0;
+
+// An in-memory database with one department, so the mutation path is
+// measured without the write-ahead log's fsync.
+MyFileDatabase* popularDatabase() {
+  static MyFileDatabase* database = []() {
+    auto* db = new MyFileDatabase(1, "");
+    std::map<std::string, Department> mapping;
+    mapping["COMS"] = Department("COMS", {}, "Luca Carloni", 2700);
+    db->setMapping(mapping);
+    return db;
+  }();
+  return database;
+}
+
+}  // namespace
+
+static void BM_ShardedCounterAdd(benchmark::State& state) {
+  for (auto _ : state) {
+    shardedCount.add(1);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ShardedCounterAdd)->ThreadRange(1, 64)->UseRealTime();
+
+static void BM_AtomicCounterAdd(benchmark::State& state) {
+  for (auto _ : state) {
+    atomicCount.fetch_add(1, std::memory_order_relaxed);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AtomicCounterAdd)->ThreadRange(1, 64)->UseRealTime();
+
+static void BM_LockedCounterAdd(benchmark::State& state) {
+  for (auto _ : state) {
+    std::unique_lock<std::shared_timed_mutex> lock(lockedMutex);
+    lockedCount++;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LockedCounterAdd)->ThreadRange(1, 64)->UseRealTime();
+
+// The mutation /addMajorToDept applies, a shared department lock and an
+// add to the sharded major count.
+static void BM_AddMajorMutation(benchmark::State& state) {
+  MyFileDatabase* database = popularDatabase();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        database->applyMutation({MutationType::AddMajor, "COMS", "", ""}));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AddMajorMutation)->ThreadRange(1, 64)->UseRealTime();
@@ -0,0 +1,28 @@
+// Copyright 2024 Maria Surani
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+
+#include "Metrics.h"
+
+// Measures the cost that recording metrics adds to every request, from 1 to
+// 16 threads recording on the same route at once.
+
+namespace {
+
+Metrics& sharedMetrics() {
+  static Metrics metrics;
+  return metrics;
+}
+
+}  // namespace
+
+static void BM_MetricsRecord(benchmark::State& state) {
+  Metrics& metrics = sharedMetrics();
+  static const int route = metrics.addRoute("/retrieveCourse");
+  int status = 200;
+  for (auto _ : state) {
+    Metrics::Timer timer(&metrics, route, &status);
+  }
+}
+BENCHMARK(BM_MetricsRecord)->ThreadRange(1, 16)->UseRealTime();
@@ -0,0 +1,93 @@
+// Copyright 2024 Maria Surani
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Roster.h"
+#include "StudentIndex.h"
+
+// Measures the per-student rosters: checking membership in a roster of 100
+// to 50,000 students, against the std::set a roster could have been, their
+// size in memory and in the data file, and finding a student's courses
+// through StudentIndex. IDs are drawn from a university-sized range.
+
+namespace {
+
+const uint32_t kStudentIdRange = 1000000;
+
+std::vector<uint32_t> randomStudentIds(int count) {
+  std::mt19937 generator(4156);
+  std::set<uint32_t> ids;
+  while (static_cast<int>(ids.size()) < count) {
+    ids.insert(generator() % kStudentIdRange);
+  }
+  return std::vector<uint32_t>(ids.begin(), ids.end());
+}
+
+}  // namespace
+
+static void BM_RosterContains(benchmark::State& state) {
+  Roster roster;
+  for (uint32_t id : randomStudentIds(static_cast<int>(state.range(0)))) {
+    roster.add(id);
+  }
+  std::mt19937 generator(1004);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(roster.contains(generator() % kStudentIdRange));
+  }
+  // Four bytes per student in memory; the varint gaps in the data file
+  state.counters["encoded_bytes_per_student"] =
+      static_cast<double>(roster.encode().size()) / roster.size();
+}
+BENCHMARK(BM_RosterContains)->Arg(100)->Arg(1000)->Arg(50000);
+
+static void BM_SetContains(benchmark::State& state) {
+  auto ids = randomStudentIds(static_cast<int>(state.range(0)));
+  std::set<uint32_t> roster(ids.begin(), ids.end());
+  std::mt19937 generator(1004);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(roster.count(generator() % kStudentIdRange));
+  }
+}
+BENCHMARK(BM_SetContains)->Arg(100)->Arg(1000)->Arg(50000);
+
+// Enrolls and drops one student anywhere in a roster, as
+// /enrollStudentInCourse and /dropStudentFromCourse do with a student ID.
+static void BM_RosterAddRemove(benchmark::State& state) {
+  Roster roster;
+  for (uint32_t id : randomStudentIds(static_cast<int>(state.range(0)))) {
+    roster.add(id);
+  }
+  std::mt19937 generator(1004);
+  for (auto _ : state) {
+    uint32_t id = generator() % kStudentIdRange;
+    if (roster.add(id)) roster.remove(id);
+  }
+}
+BENCHMARK(BM_RosterAddRemove)->Arg(100)->Arg(1000)->Arg(50000);
+
+// Finds the courses of one of 50,000 students taking five courses each.
+static void BM_StudentIndexFindCourses(benchmark::State& state) {
+  const int kStudents = 50000;
+  const int kCoursesPerStudent = 5;
+  auto ids = randomStudentIds(kStudents);
+  std::vector<StudentIndex::Record> records;
+  std::mt19937 generator(4156);
+  for (uint32_t id : ids) {
+    for (int i = 0; i < kCoursesPerStudent; ++i) {
+      records.push_back({id,
+                         {"D" + std::to_string(generator() % 100),
+                          static_cast<int>(1000 + generator() % 100)}});
+    }
+  }
+  StudentIndex index;
+  index.rebuild(records);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(index.findCourses(ids[generator() % kStudents]));
+  }
+}
+BENCHMARK(BM_StudentIndexFindCourses);
@@ -0,0 +1,581 @@
+// Copyright 2024 Maria Surani
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CatalogGenerator.h"
+#include "MyFileDatabase.h"
+#include "RouteController.h"
+#include "crow.h"  // NOLINT
+
+// Load test for the HTTP service. Serves the routes of RouteController on a
+// local port over a synthetic catalog, sends a weighted mix of requests to
+// them from many client threads for a fixed time, and prints the throughput
+// and the latency percentiles of every route as JSON or CSV, so that the runs
+// of two releases can be diffed.
+//
+// Every client thread keeps one connection open, like a pooled client, and
+// sends its next request as soon as the last response arrives. Requests that
+// fail or get a 5xx response count as errors; 4xx responses are counted
+// separately and usually mean the mix asks for something the catalog lacks.
+
+namespace {
+
+struct Options {
+  int port = 18080;
+  int threads = 16;
+  int serverThreads = 0;
+  int duration = 10;
+  int warmup = 1;
+  int departments = 50;
+  int courses = 100;
+  unsigned seed = 4156;
+  std::string mix =
+      "retrieveCourse=30,isCourseFull=20,retrieveDept=2,"
+      "getMajorCountFromDept=3,idDeptChair=3,findCourseLocation=5,"
+      "findCourseInstructor=5,findCourseTime=5,findCoursesMeetingAt=2,"
+      "findCourseConflicts=2,findRoomConflicts=2,setEnrollmentCount=8,"
+      "enrollStudentInCourse=8,changeCourseLocation=1,changeCourseTeacher=1,"
+      "changeCourseTime=1,addMajorToDept=1,removeMajorFromDept=1";
+  std::string format = "json";
+  std::string dataFile;
+  std::string acceptEncoding;
+};
+
+// A route and how to build the query string of a random request to it.
+struct Route {
+  const char* name;
+  const char* path;
+  const char* method;
+  std::string (*query)(const CatalogGenerator&, std::mt19937*);
+};
+
+std::string escapeSpaces(const std::string& text) {
+  std::string escaped;
+  for (char c : text) {
+    if (c == ' ') {
+      escaped += "%20";
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+std::string noQuery(const CatalogGenerator&, std::mt19937*) { return ""; }
+
+std::string deptQuery(const CatalogGenerator& catalog,
+                      std::mt19937* generator) {
+  return "deptCode=" + catalog.getDeptCode(static_cast<int>(
+                           (*generator)() % catalog.getDepartmentCount()));
+}
+
+std::string courseQuery(const CatalogGenerator& catalog,
+                        std::mt19937* generator) {
+  int course =
+      static_cast<int>((*generator)() % catalog.getCoursesPerDepartment());
+  return deptQuery(catalog, generator) +
+         "&courseCode=" + std::to_string(catalog.getCourseNumber(course));
+}
+
+std::string locationQuery(const CatalogGenerator& catalog,
+                          std::mt19937* generator) {
+  return "location=" + escapeSpaces(catalog.getLocation(static_cast<int>(
+                           (*generator)() % catalog.getRoomCount())));
+}
+
+const Route kRoutes[] = {
+    {"index", "/", "GET", noQuery},
+    {"retrieveDept", "/retrieveDept", "GET", deptQuery},
+    {"retrieveCourse", "/retrieveCourse", "GET", courseQuery},
+    {"retrieveCourses", "/retrieveCourses", "GET",
+     [](const CatalogGenerator& catalog, std::mt19937* generator) {
+       // A schedule of five courses in one request
+       std::string query = "courses=";
+       for (int i = 0; i < 5; ++i) {
+         int course = static_cast<int>((*generator)() %
+                                       catalog.getCoursesPerDepartment());
+         query += (i == 0 ? "" : ",") +
+                  catalog.getDeptCode(static_cast<int>(
+                      (*generator)() % catalog.getDepartmentCount())) +
+                  ":" + std::to_string(catalog.getCourseNumber(course));
+       }
+       return query;
+     }},
+    {"isCourseFull", "/isCourseFull", "GET", courseQuery},
+    {"getMajorCountFromDept", "/getMajorCountFromDept", "GET", deptQuery},
+    {"idDeptChair", "/idDeptChair", "GET", deptQuery},
+    {"findCourseLocation", "/findCourseLocation", "GET", courseQuery},
+    {"findCourseInstructor", "/findCourseInstructor", "GET", courseQuery},
+    {"findCourseTime", "/findCourseTime", "GET", courseQuery},
+    {"findCoursesMeetingAt", "/findCoursesMeetingAt", "GET",
+     [](const CatalogGenerator&, std::mt19937* generator) {
+       static const char* const kDays[] = {"M", "T", "W", "R", "F"};
+       int minute = 8 * 60 + static_cast<int>((*generator)() % (12 * 60));
+       std::string minutes = std::to_string(minute % 60);
+       return "time=" + std::to_string(minute / 60) + ":" +
+              (minutes.size() == 1 ? "0" + minutes : minutes) +
+              "&day=" + kDays[(*generator)() % 5];
+     }},
+    {"findCourseConflicts", "/findCourseConflicts", "GET", courseQuery},
+    {"findRoomConflicts", "/findRoomConflicts", "GET", locationQuery},
+    {"addMajorToDept", "/addMajorToDept", "GET", deptQuery},
+    {"removeMajorFromDept", "/removeMajorFromDept", "GET", deptQuery},
+    {"changeCourseLocation", "/changeCourseLocation", "PATCH",
+     [](const CatalogGenerator& catalog, std::mt19937* generator) {
+       return courseQuery(catalog, generator) + "&" +
+              locationQuery(catalog, generator);
+     }},
+    {"changeCourseTeacher", "/changeCourseTeacher", "PATCH",
+     [](const CatalogGenerator& catalog, std::mt19937* generator) {
+       return courseQuery(catalog, generator) + "&instructor=Instructor%20" +
+              std::to_string((*generator)() % 1000);
+     }},
+    {"changeCourseTime", "/changeCourseTime", "PATCH",
+     [](const CatalogGenerator& catalog, std::mt19937* generator) {
+       return courseQuery(catalog, generator) +
+              "&time=" + escapeSpaces(catalog.getTimeSlot((*generator)()));
+     }},
+    {"setEnrollmentCount", "/setEnrollmentCount", "PATCH",
+     [](const CatalogGenerator& catalog, std::mt19937* generator) {
+       return courseQuery(catalog, generator) +
+              "&count=" + std::to_string((*generator)() % 100);
+     }},
+    {"enrollStudentInCourse", "/enrollStudentInCourse", "PATCH", courseQuery},
+};
+
+const int kRouteCount = sizeof(kRoutes) / sizeof(kRoutes[0]);
+
+/**
+ * A keep-alive HTTP/1.1 connection to the local server.
+ */
+class Connection {
+ public:
+  Connection(int port, const std::string& acceptEncoding)
+      : port(port), fd(-1) {
+    if (!acceptEncoding.empty()) {
+      extraHeaders = "Accept-Encoding: " + acceptEncoding + "\r\n";
+    }
+  }
+  ~Connection() { close(); }
+
+  Connection(const Connection&) = delete;
+  Connection& operator=(const Connection&) = delete;
+
+  /**
+   * Sends a request and reads the whole response, reconnecting first if the
+   * server closed the connection.
+   *
+   * @param method the HTTP method
+   * @param target the path and query string
+   * @return the status code, or 0 if the request failed
+   */
+  int send(const std::string& method, const std::string& target) {
+    if (fd < 0 && !connect()) return 0;
+    std::string request = method + " " + target +
+                          " HTTP/1.1\r\nHost: localhost\r\n" + extraHeaders +
+                          "Content-Length: 0\r\n\r\n";
+    if (!writeAll(request)) {
+      // The server may have dropped an idle connection; retry once.
+      close();
+      if (!connect() || !writeAll(request)) return 0;
+    }
+    int status = readResponse();
+    if (status == 0) close();
+    return status;
+  }
+
+ private:
+  bool connect() {
+    fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    int noDelay = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address),
+                  sizeof(address)) != 0) {
+      close();
+      return false;
+    }
+    buffer.clear();
+    return true;
+  }
+
+  void close() {
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+  }
+
+  bool writeAll(const std::string& data) {
+    size_t written = 0;
+    while (written < data.size()) {
+      ssize_t n = ::send(fd, data.data() + written, data.size() - written,
+                         MSG_NOSIGNAL);
+      if (n <= 0) return false;
+      written += static_cast<size_t>(n);
+    }
+    return true;
+  }
+
+  bool fill() {
+    char chunk[16384];
+    ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+    if (n <= 0) return false;
+    buffer.append(chunk, static_cast<size_t>(n));
+    return true;
+  }
+
+  // Reads one response into the buffer and consumes it.
+  int readResponse() {
+    size_t headerEnd;
+    while ((headerEnd = buffer.find("\r\n\r\n")) == std::string::npos) {
+      if (!fill()) return 0;
+    }
+    std::string headers = buffer.substr(0, headerEnd);
+    for (char& c : headers) {
+      c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    size_t space = headers.find(' ');
+    if (space == std::string::npos) return 0;
+    int status = std::atoi(headers.c_str() + space + 1);
+
+    size_t contentLength = 0;
+    size_t field = headers.find("\r\ncontent-length:");
+    if (field != std::string::npos) {
+      contentLength = std::strtoul(
+          headers.c_str() + field + sizeof("\r\ncontent-length:") - 1,
+          nullptr, 10);
+    }
+    size_t responseEnd = headerEnd + 4 + contentLength;
+    while (buffer.size() < responseEnd) {
+      if (!fill()) return 0;
+    }
+    buffer.erase(0, responseEnd);
+    if (headers.find("\r\nconnection: close") != std::string::npos) close();
+    return status;
+  }
+
+  int port;
+  int fd;
+  std::string buffer;
+  // Headers sent with every request, each ending in CRLF
+  std::string extraHeaders;
+};
+
+// What one client thread measured for one route.
+struct RouteResult {
+  std::vector<int64_t> latencies;  // nanoseconds
+  uint64_t errors = 0;
+  uint64_t clientErrors = 0;
+
+  void add(const RouteResult& other) {
+    latencies.insert(latencies.end(), other.latencies.begin(),
+                     other.latencies.end());
+    errors += other.errors;
+    clientErrors += other.clientErrors;
+  }
+};
+
+enum Phase { kWarmup, kMeasuring, kStopped };
+
+void runClient(const Options& options, const CatalogGenerator& catalog,
+               const std::vector<double>& weights, unsigned seed,
+               const std::atomic<int>* phase,
+               std::vector<RouteResult>* results) {
+  std::mt19937 generator(seed);
+  std::discrete_distribution<int> pick(weights.begin(), weights.end());
+  Connection connection(options.port, options.acceptEncoding);
+  while (phase->load(std::memory_order_relaxed) != kStopped) {
+    const Route& route = kRoutes[pick(generator)];
+    std::string target = route.path;
+    std::string query = route.query(catalog, &generator);
+    if (!query.empty()) target += "?" + query;
+
+    bool measured = phase->load(std::memory_order_relaxed) == kMeasuring;
+    auto start = std::chrono::steady_clock::now();
+    int status = connection.send(route.method, target);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    if (!measured) continue;
+
+    RouteResult& result = (*results)[&route - kRoutes];
+    result.latencies.push_back(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    if (status == 0 || status >= 500) {
+      ++result.errors;
+    } else if (status >= 400) {
+      ++result.clientErrors;
+    }
+  }
+}
+
+// Nearest-rank percentile of sorted latencies, in microseconds.
+double percentile(const std::vector<int64_t>& sorted, double fraction) {
+  if (sorted.empty()) return 0;
+  size_t rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+  return sorted[std::max<size_t>(rank, 1) - 1] / 1000.0;
+}
+
+struct Summary {
+  std::string route;
+  uint64_t requests;
+  uint64_t errors;
+  uint64_t clientErrors;
+  double throughput;
+  double mean;
+  double p50;
+  double p99;
+  double p999;
+  double max;
+};
+
+Summary summarize(const std::string& name, RouteResult result,
+                  double seconds) {
+  std::vector<int64_t>& latencies = result.latencies;
+  std::sort(latencies.begin(), latencies.end());
+  double total = 0;
+  for (int64_t latency : latencies) total += latency;
+  Summary summary;
+  summary.route = name;
+  summary.requests = latencies.size();
+  summary.errors = result.errors;
+  summary.clientErrors = result.clientErrors;
+  summary.throughput = latencies.size() / seconds;
+  summary.mean = latencies.empty() ? 0 : total / latencies.size() / 1000.0;
+  summary.p50 = percentile(latencies, 0.5);
+  summary.p99 = percentile(latencies, 0.99);
+  summary.p999 = percentile(latencies, 0.999);
+  summary.max = latencies.empty() ? 0 : latencies.back() / 1000.0;
+  return summary;
+}
+
+std::string fixed(double value) {
+  char text[32];
+  std::snprintf(text, sizeof(text), "%.1f", value);
+  return text;
+}
+
+void printJson(const Options& options, int serverThreads,
+               const std::vector<Summary>& routes, const Summary& total) {
+  auto fields = [](const Summary& s) {
+    return "\"requests\": " + std::to_string(s.requests) +
+           ", \"errors\": " + std::to_string(s.errors) +
+           ", \"client_errors\": " + std::to_string(s.clientErrors) +
+           ", \"throughput_rps\": " + fixed(s.throughput) +
+           ", \"mean_us\": " + fixed(s.mean) + ", \"p50_us\": " + fixed(s.p50) +
+           ", \"p99_us\": " + fixed(s.p99) + ", \"p999_us\": " + fixed(s.p999) +
+           ", \"max_us\": " + fixed(s.max);
+  };
+  std::cout << "{\n  \"config\": {\"threads\": " << options.threads
+            << ", \"server_threads\": " << serverThreads
+            << ", \"duration_s\": " << options.duration
+            << ", \"departments\": " << options.departments
+            << ", \"courses_per_department\": " << options.courses
+            << ", \"seed\": " << options.seed << ", \"wal\": "
+            << (options.dataFile.empty() ? "false" : "true") << "},\n"
+            << "  \"total\": {" << fields(total) << "},\n"
+            << "  \"routes\": [\n";
+  for (size_t i = 0; i < routes.size(); ++i) {
+    std::cout << "    {\"route\": \"" << routes[i].route << "\", "
+              << fields(routes[i]) << "}"
+              << (i + 1 < routes.size() ? ",\n" : "\n");
+  }
+  std::cout << "  ]\n}" << std::endl;
+}
+
+void printCsv(const std::vector<Summary>& routes, const Summary& total) {
+  std::cout << "route,requests,errors,client_errors,throughput_rps,mean_us,"
+               "p50_us,p99_us,p999_us,max_us\n";
+  std::vector<Summary> rows = routes;
+  rows.push_back(total);
+  for (const Summary& s : rows) {
+    std::cout << s.route << "," << s.requests << "," << s.errors << ","
+              << s.clientErrors << "," << fixed(s.throughput) << ","
+              << fixed(s.mean) << "," << fixed(s.p50) << "," << fixed(s.p99)
+              << "," << fixed(s.p999) << "," << fixed(s.max) << "\n";
+  }
+  std::cout << std::flush;
+}
+
+bool parseWeights(const std::string& mix, std::vector<double>* weights) {
+  weights->assign(kRouteCount, 0);
+  std::stringstream entries(mix);
+  std::string entry;
+  while (std::getline(entries, entry, ',')) {
+    size_t equals = entry.find('=');
+    std::string name = entry.substr(0, equals);
+    double weight =
+        equals == std::string::npos ? 1 : std::atof(entry.c_str() + equals + 1);
+    int route = 0;
+    while (route < kRouteCount && name != kRoutes[route].name) ++route;
+    if (route == kRouteCount || weight < 0) {
+      std::cerr << "Unknown route or weight in mix: " << entry << std::endl;
+      return false;
+    }
+    (*weights)[route] = weight;
+  }
+  for (double weight : *weights) {
+    if (weight > 0) return true;
+  }
+  std::cerr << "The mix selects no routes" << std::endl;
+  return false;
+}
+
+bool parseOptions(int argc, char* argv[], Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    size_t equals = arg.find('=');
+    if (arg.compare(0, 2, "--") != 0 || equals == std::string::npos) {
+      std::cerr << "Expected --option=value, got " << arg << std::endl;
+      return false;
+    }
+    std::string name = arg.substr(2, equals - 2);
+    std::string value = arg.substr(equals + 1);
+    if (name == "port") {
+      options->port = std::atoi(value.c_str());
+    } else if (name == "threads") {
+      options->threads = std::atoi(value.c_str());
+    } else if (name == "server-threads") {
+      options->serverThreads = std::atoi(value.c_str());
+    } else if (name == "duration") {
+      options->duration = std::atoi(value.c_str());
+    } else if (name == "warmup") {
+      options->warmup = std::atoi(value.c_str());
+    } else if (name == "departments") {
+      options->departments = std::atoi(value.c_str());
+    } else if (name == "courses") {
+      options->courses = std::atoi(value.c_str());
+    } else if (name == "seed") {
+      options->seed = static_cast<unsigned>(std::strtoul(value.c_str(),
+                                                         nullptr, 10));
+    } else if (name == "mix") {
+      options->mix = value;
+    } else if (name == "format" && (value == "json" || value == "csv")) {
+      options->format = value;
+    } else if (name == "data-file") {
+      options->dataFile = value;
+    } else if (name == "accept-encoding") {
+      options->acceptEncoding = value;
+    } else {
+      std::cerr << "Unknown option " << arg << std::endl;
+      return false;
+    }
+  }
+  if (options->threads < 1 || options->duration < 1 || options->warmup < 0 ||
+      options->departments < 1 || options->courses < 1) {
+    std::cerr << "Threads, duration, departments and courses must be positive"
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+/**
+ *  Runs the load test. Options are passed as --name=value:
+ *    --port=18080        the local port to serve on
+ *    --threads=16        client threads, each with one connection
+ *    --server-threads=0  Crow worker threads, 0 for one per core
+ *    --duration=10       seconds to measure for
+ *    --warmup=1          seconds to send requests before measuring
+ *    --departments=50    departments in the synthetic catalog
+ *    --courses=100       courses in each department
+ *    --seed=4156         seed of the catalog and of the requests
+ *    --mix=route=weight,...  relative frequency of each route
+ *    --format=json       json or csv
+ *    --data-file=PATH    log changes to PATH.wal instead of keeping them
+ *    --accept-encoding=gzip  Accept-Encoding header sent with every request
+ *                        only in memory
+ */
+int main(int argc, char* argv[]) {
+  Options options;
+  std::vector<double> weights;
+  if (!parseOptions(argc, argv, &options) ||
+      !parseWeights(options.mix, &weights)) {
+    return 2;
+  }
+  int serverThreads = options.serverThreads > 0
+                          ? options.serverThreads
+                          : std::max(1u, std::thread::hardware_concurrency());
+
+  // Progress messages go to stderr so that stdout only holds the report
+  std::streambuf* report = std::cout.rdbuf(std::cerr.rdbuf());
+  CatalogGenerator catalog(options.departments, options.courses,
+                           options.seed);
+  MyFileDatabase database(1, options.dataFile);
+  database.setMapping(catalog.generate());
+
+  crow::SimpleApp app;
+  app.loglevel(crow::LogLevel::Warning);
+  RouteController routeController;
+  routeController.initRoutes(app);
+  routeController.setDatabase(&database);
+  auto server = app.bindaddr("127.0.0.1")
+                    .port(static_cast<uint16_t>(options.port))
+                    .concurrency(static_cast<uint16_t>(serverThreads))
+                    .run_async();
+  app.wait_for_server_start();
+  std::cout.rdbuf(report);
+
+  std::atomic<int> phase(kWarmup);
+  std::vector<std::vector<RouteResult>> results(
+      options.threads, std::vector<RouteResult>(kRouteCount));
+  std::vector<std::thread> clients;
+  for (int i = 0; i < options.threads; ++i) {
+    clients.emplace_back(runClient, std::cref(options), std::cref(catalog),
+                         std::cref(weights), options.seed + 1 + i, &phase,
+                         &results[i]);
+  }
+  std::this_thread::sleep_for(std::chrono::seconds(options.warmup));
+  phase = kMeasuring;
+  auto start = std::chrono::steady_clock::now();
+  std::this_thread::sleep_for(std::chrono::seconds(options.duration));
+  phase = kStopped;
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  for (auto& client : clients) client.join();
+  app.stop();
+  server.wait();
+
+  std::vector<Summary> routes;
+  RouteResult all;
+  for (int route = 0; route < kRouteCount; ++route) {
+    if (weights[route] == 0) continue;
+    RouteResult merged;
+    for (const auto& threadResults : results) merged.add(threadResults[route]);
+    all.add(merged);
+    routes.push_back(summarize(kRoutes[route].name, std::move(merged),
+                               seconds));
+  }
+  std::sort(routes.begin(), routes.end(),
+            [](const Summary& a, const Summary& b) { return a.route < b.route; });
+  Summary total = summarize("total", std::move(all), seconds);
+
+  if (options.format == "csv") {
+    printCsv(routes, total);
+  } else {
+    printJson(options, serverThreads, routes, total);
+  }
+  return total.errors == 0 ? 0 : 1;
+}
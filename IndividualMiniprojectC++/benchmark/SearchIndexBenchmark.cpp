@@ -0,0 +1,146 @@
+// Copyright 2024 Maria Surani
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cctype>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "SearchIndex.h"
+
+// Measures type-ahead search over instructor names for catalogs of 10k to
+// 300k courses, through SearchIndex and by scanning every name for the
+// query as a substring. The scan is the cheapest possible one: it tolerates
+// no typos and leaves the matches unranked, and it still visits every name,
+// as ranking needs.
+
+namespace {
+
+const int kQueries = 1024;
+
+// Names made of random syllables, "Kozani Rebatumo", about four courses
+// each.
+std::string randomName(std::mt19937* generator) {
+  static const char* const kSyllables[] = {
+      "ka", "zo", "ni", "re", "ba", "tu", "mo", "li", "sha", "ven",
+      "dor", "pi", "ski", "an", "el", "wu", "chen", "ma", "ro", "ta"};
+  std::string name;
+  for (int word = 0; word < 2; ++word) {
+    if (word > 0) name += ' ';
+    size_t start = name.size();
+    int syllables = 2 + static_cast<int>((*generator)() % 3);
+    for (int i = 0; i < syllables; ++i) name += kSyllables[(*generator)() % 20];
+    name[start] = static_cast<char>(
+        std::toupper(static_cast<unsigned char>(name[start])));
+  }
+  return name;
+}
+
+std::vector<std::string> makeInstructors(int courses) {
+  std::mt19937 generator(4156);
+  std::vector<std::string> names;
+  for (int i = 0; i < courses / 4; ++i) names.push_back(randomName(&generator));
+  std::vector<std::string> instructors;
+  for (int i = 0; i < courses; ++i) {
+    instructors.push_back(names[i % names.size()]);
+  }
+  return instructors;
+}
+
+// What a user types: the start of a real name, with one letter dropped.
+std::vector<std::string> makeQueries(const std::vector<std::string>& names) {
+  std::mt19937 generator(1004);
+  std::vector<std::string> queries;
+  for (int i = 0; i < kQueries; ++i) {
+    std::string name = names[generator() % names.size()];
+    std::string query = name.substr(0, 4 + generator() % (name.size() - 4));
+    query.erase(1 + generator() % (query.size() - 1), 1);
+    queries.push_back(query);
+  }
+  return queries;
+}
+
+std::string lower(std::string text) {
+  std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) {
+    return static_cast<char>(std::tolower(c));
+  });
+  return text;
+}
+
+}  // namespace
+
+static void BM_SearchIndex(benchmark::State& state) {
+  std::vector<std::string> instructors =
+      makeInstructors(static_cast<int>(state.range(0)));
+  SearchIndex index;
+  index.rebuild(instructors);
+  std::vector<std::string> queries = makeQueries(instructors);
+  size_t next = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(index.search(queries[next++ % kQueries], 10));
+  }
+}
+BENCHMARK(BM_SearchIndex)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Arg(300000)
+    ->Unit(benchmark::kMicrosecond);
+
+// A name with letters the generated ones lack, whose trigrams are in few
+// postings, so that what is left is the cost every search pays whatever it
+// matches.
+static void BM_SearchIndexRareQuery(benchmark::State& state) {
+  SearchIndex index;
+  index.rebuild(makeInstructors(static_cast<int>(state.range(0))));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(index.search("Gygax Jefferyq", 10));
+  }
+}
+BENCHMARK(BM_SearchIndexRareQuery)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Arg(300000)
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_SearchLinearScan(benchmark::State& state) {
+  std::vector<std::string> instructors =
+      makeInstructors(static_cast<int>(state.range(0)));
+  std::vector<std::string> names = instructors;
+  std::sort(names.begin(), names.end());
+  names.erase(std::unique(names.begin(), names.end()), names.end());
+  std::vector<std::string> queries = makeQueries(instructors);
+  size_t next = 0;
+  for (auto _ : state) {
+    std::string query = lower(queries[next++ % kQueries]);
+    std::vector<const std::string*> matches;
+    for (const auto& name : names) {
+      if (lower(name).find(query) != std::string::npos) {
+        matches.push_back(&name);
+      }
+    }
+    benchmark::DoNotOptimize(matches.data());
+  }
+}
+BENCHMARK(BM_SearchLinearScan)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Arg(300000)
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_SearchIndexRebuild(benchmark::State& state) {
+  std::vector<std::string> instructors =
+      makeInstructors(static_cast<int>(state.range(0)));
+  SearchIndex index;
+  for (auto _ : state) {
+    // The index is built by the first call after rebuild()
+    index.rebuild(instructors);
+    benchmark::DoNotOptimize(index.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SearchIndexRebuild)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Arg(300000)
+    ->Unit(benchmark::kMillisecond);
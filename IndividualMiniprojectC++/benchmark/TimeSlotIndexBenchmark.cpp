@@ -0,0 +1,105 @@
+// Copyright 2024 Maria Surani
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "TimeSlotIndex.h"
+
+// Measures how long it takes to find the courses that conflict with one
+// course, for catalogs of growing size, by scanning every course and through
+// the interval tree in TimeSlotIndex.
+
+namespace {
+
+const int kQueries = 1024;
+
+std::string clock(int minute) {
+  std::string minutes = std::to_string(minute % 60);
+  return std::to_string(minute / 60) + ":" +
+         (minutes.size() == 1 ? "0" + minutes : minutes);
+}
+
+// Start times spread over the teaching day in five-minute steps, lasting
+// 50 to 150 minutes, on one of the usual day patterns.
+TimeSlot randomSlot(std::mt19937* generator) {
+  static const char* const kDays[] = {"MW ", "TR ", "MWF ", "F "};
+  int start = 8 * 60 + 5 * static_cast<int>((*generator)() % 144);
+  int end = start + 50 + 25 * static_cast<int>((*generator)() % 5);
+  return TimeSlot(kDays[(*generator)() % 4] + clock(start) + "-" + clock(end));
+}
+
+std::vector<ScheduledCourse> makeCatalog(int courses) {
+  std::mt19937 generator(4156);
+  std::vector<ScheduledCourse> catalog;
+  for (int i = 0; i < courses; ++i) {
+    catalog.push_back(
+        {"D" + std::to_string(i / 100), 1000 + i % 100, randomSlot(&generator)});
+  }
+  return catalog;
+}
+
+std::vector<TimeSlot> makeQueries() {
+  std::mt19937 generator(1004);
+  std::vector<TimeSlot> queries;
+  for (int i = 0; i < kQueries; ++i) queries.push_back(randomSlot(&generator));
+  return queries;
+}
+
+}  // namespace
+
+static void BM_FindConflictsFullScan(benchmark::State& state) {
+  std::vector<ScheduledCourse> catalog =
+      makeCatalog(static_cast<int>(state.range(0)));
+  std::vector<TimeSlot> queries = makeQueries();
+  size_t next = 0;
+  for (auto _ : state) {
+    const TimeSlot& slot = queries[next++ % queries.size()];
+    std::vector<ScheduledCourse> conflicts;
+    for (const auto& course : catalog) {
+      if (course.timeSlot.overlaps(slot)) conflicts.push_back(course);
+    }
+    benchmark::DoNotOptimize(conflicts.data());
+  }
+}
+BENCHMARK(BM_FindConflictsFullScan)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_FindConflictsIndex(benchmark::State& state) {
+  TimeSlotIndex index;
+  index.rebuild(makeCatalog(static_cast<int>(state.range(0))));
+  std::vector<TimeSlot> queries = makeQueries();
+  size_t next = 0;
+  for (auto _ : state) {
+    std::vector<ScheduledCourse> conflicts =
+        index.findOverlapping(queries[next++ % queries.size()]);
+    benchmark::DoNotOptimize(conflicts.data());
+  }
+}
+BENCHMARK(BM_FindConflictsIndex)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMicrosecond);
+
+// A point query returns few courses, so it shows the cost of the tree walk.
+static void BM_FindMeetingAtIndex(benchmark::State& state) {
+  TimeSlotIndex index;
+  index.rebuild(makeCatalog(static_cast<int>(state.range(0))));
+  uint8_t friday;
+  TimeSlot::parseDays("F", &friday);
+  int minute = 7 * 60;
+  for (auto _ : state) {
+    minute = minute % (22 * 60) + 7;
+    benchmark::DoNotOptimize(index.findMeetingAt(minute, friday).data());
+  }
+}
+BENCHMARK(BM_FindMeetingAtIndex)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,65 @@
+#ifndef COMPRESSION_H
+#define COMPRESSION_H
+
+#include <cstddef>
+#include <memory>
+#include <streambuf>
+#include <string>
+
+struct z_stream_s;
+
+/**
+ * The HTTP content codings a response body may be sent in. Identity is the
+ * body as it is; gzip and deflate are its zlib compressions.
+ */
+enum class ContentEncoding { Identity, Gzip, Deflate };
+
+// The number of ContentEncoding values
+const size_t kContentEncodings = 3;
+
+/**
+ * Gets the name of a content coding as used in Accept-Encoding and
+ * Content-Encoding headers.
+ *
+ * @param encoding the coding
+ * @return its name, e.g. "gzip"
+ */
+const char* contentEncodingName(ContentEncoding encoding);
+
+/**
+ * Compresses a whole body at once.
+ *
+ * @param data     the body
+ * @param encoding the coding to compress it with
+ * @return the compressed body, or the body itself for Identity
+ */
+std::string compress(const std::string& data, ContentEncoding encoding);
+
+/**
+ * A stream buffer that compresses everything written to it into another
+ * stream buffer, such as a file's, holding only a fixed-size block of
+ * compressed output at a time. finish() must be called after the last write
+ * to flush the end of the compressed stream.
+ */
+class CompressingStreamBuf : public std::streambuf {
+ public:
+  CompressingStreamBuf(std::streambuf* sink, ContentEncoding encoding);
+  ~CompressingStreamBuf();
+
+  bool finish();
+
+ protected:
+  std::streamsize xsputn(const char* data, std::streamsize size) override;
+  int_type overflow(int_type c) override;
+
+ private:
+  bool deflateInput(const char* data, size_t size, int flush);
+
+  std::streambuf* sink;
+  std::unique_ptr<z_stream_s> stream;
+  char output[16384];
+  bool finished;
+  bool failed;
+};
+
+#endif
@@ -2,31 +2,58 @@
 #ifndef COURSE_H
 #define COURSE_H
 
+#include <atomic>
+
+#include "JsonWriter.h"
+#include "Roster.h"
+#include "StringPool.h"
+#include "TimeSlot.h"
+#include "Waitlist.h"
+
 class Course {
  private:
   int enrollmentCapacity;
-  int enrolledStudentCount;
-  std::string courseLocation;
-  std::string instructorName;
-  std::string courseTimeSlot;
+  std::atomic<int> enrolledStudentCount;
+  InternedString courseLocation;
+  InternedString instructorName;
+  TimeSlot courseTimeSlot;
+  Roster roster;
+  Waitlist waitlist;
 
  public:
   Course(int count, const std::string &instructorName,
          const std::string &courseLocation, const std::string &timeSlot);
   Course();
+  Course(const Course &other);
+  Course &operator=(const Course &other);
 
-  std::string getCourseLocation() const;
-  std::string getInstructorName() const;
-  std::string getCourseTimeSlot() const;
+  const std::string &getCourseLocation() const;
+  const std::string &getInstructorName() const;
+  const std::string &getCourseTimeSlot() const;
+  const TimeSlot &getTimeSlot() const;
+  int getEnrolledStudentCount() const;
+  int getEnrollmentCapacity() const;
   std::string display() const;
+  void writeJsonFields(JsonWriter& writer) const;
 
   bool isCourseFull() const;
   bool enrollStudent();
   bool dropStudent();
+  bool enrollStudent(uint32_t studentId);
+  bool dropStudent(uint32_t studentId);
+  bool isStudentEnrolled(uint32_t studentId) const;
+  const Roster &getRoster() const;
+  void setRoster(Roster roster);
+  bool joinWaitlist(uint32_t studentId);
+  bool leaveWaitlist(uint32_t studentId);
+  size_t getWaitlistPosition(uint32_t studentId) const;
+  bool promoteFromWaitlist(uint32_t *studentId);
+  const Waitlist &getWaitlist() const;
+  void setWaitlist(Waitlist waitlist);
 
   void reassignInstructor(const std::string &newInstructorName);
   void reassignLocation(const std::string &newLocation);
-  void reassignTime(const std::string &newTime);
+  bool reassignTime(const std::string &newTime);
   void setEnrolledStudentCount(int count);
   void serialize(std::ostream &out) const;
   void deserialize(std::istream &in);
@@ -0,0 +1,63 @@
+#ifndef COURSEINDEX_H
+#define COURSEINDEX_H
+
+#include <cstddef>
+#include <map>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Department.h"
+#include "StringPool.h"
+
+/**
+ * Secondary index from the value of one Course attribute to the courses
+ * that have it, so "which courses does Adam Cannon teach" is one hash lookup
+ * and a copy of the answer instead of a walk over every course. The
+ * attribute is declared by the Course getter that reads it, e.g.
+ * CourseIndex(&Course::getInstructorName), and the database keeps the index
+ * up to date by calling update() before it changes that attribute. Each
+ * value keeps its courses in a small vector sorted by department code and
+ * course number, holding interned department codes.
+ *
+ * Courses whose value is empty are not indexed. The index is thread-safe,
+ * since courses of different departments change concurrently under their
+ * own locks.
+ */
+class CourseIndex {
+ public:
+  using Attribute = const std::string& (Course::*)() const;
+
+  /**
+   * A course with the value looked up.
+   */
+  struct Match {
+    std::string deptCode;
+    int courseNumber;
+  };
+
+  explicit CourseIndex(Attribute attribute);
+
+  void rebuild(const std::map<std::string, Department>& departments);
+  void update(const std::string& deptCode, int courseNumber,
+              const Course& course, const std::string& newValue);
+
+  std::vector<Match> findCourses(const std::string& value) const;
+  size_t getValueCount() const;
+
+ private:
+  struct Entry {
+    InternedString deptCode;
+    int courseNumber;
+  };
+
+  static bool comesBefore(const Entry& entry, const std::string& deptCode,
+                          int courseNumber);
+
+  const Attribute attribute;
+  mutable std::shared_timed_mutex mutex;
+  std::unordered_map<std::string, std::vector<Entry>> values;
+};
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Computes the CRC-32 (IEEE 802.3) of a byte range. Passing the result of a
+ * previous call as crc continues the checksum over several ranges.
+ *
+ * @param data pointer to the first byte
+ * @param size the number of bytes
+ * @param crc  the checksum of the preceding bytes, 0 to start a new one
+ * @return the checksum of all bytes so far
+ */
+uint32_t crc32(const char* data, size_t size, uint32_t crc = 0);
+
+#endif
@@ -6,13 +6,23 @@
 #define DEPARTMENT_H
 
 #include <map>
-#include <memory>
 #include <string>
+#include <vector>
 
+#include "ShardedCounter.h"
+
+/**
+ * A department and the courses it offers. Courses are keyed by their number
+ * and stored by value in contiguous arrays sorted by that number, so a
+ * lookup is a binary search over a packed array of ints instead of a walk
+ * over string-keyed tree nodes and separately allocated courses.
+ *
+ * The number of majors is a ShardedCounter, so concurrent requests for the
+ * same department can change it under a shared lock without contending.
+ */
 class Department {
  public:
-  Department(std::string deptCode,
-             std::map<std::string, std::shared_ptr<Course>> courses,
+  Department(std::string deptCode, std::map<int, Course> courses,
              std::string departmentChair, int numberOfMajors);
 
   Department();
@@ -22,19 +32,29 @@ class Department {
   void deserialize(std::istream& in);
   void addPersonToMajor();
   void dropPersonFromMajor();
-  void addCourse(std::string courseId, std::shared_ptr<Course> course);
-  void createCourse(std::string courseId, std::string instructorName,
+  void addCourse(int courseNumber, const Course& course);
+  void createCourse(int courseNumber, std::string instructorName,
                     std::string courseLocation, std::string courseTimeSlot,
                     int capacity);
   std::string display() const;
+  void writeJson(JsonWriter& writer) const;
   std::string getDepartmentChair() const;
-  std::map<std::string, std::shared_ptr<Course>> getCourseSelection() const;
+  const std::vector<int>& getCourseNumbers() const;
+  const std::vector<Course>& getCourses() const;
+  Course* findCourse(int courseNumber);
+  const Course* findCourse(int courseNumber) const;
+  Course* findCourse(const std::string& courseId);
+  const Course* findCourse(const std::string& courseId) const;
+
+  static bool parseCourseNumber(const std::string& courseId, int* number);
 
  private:
-  int numberOfMajors;
+  ShardedCounter numberOfMajors;
   std::string deptCode;
   std::string departmentChair;
-  std::map<std::string, std::shared_ptr<Course>> courses;
+  // Parallel arrays: courses[i] is the course numbered courseNumbers[i]
+  std::vector<int> courseNumbers;
+  std::vector<Course> courses;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,37 @@
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+#include <cstdint>
+#include <string>
+
+/**
+ * Writes JSON straight onto the end of a string, such as a response body,
+ * as values are handed to it, without building intermediate strings.
+ * Commas between members and elements are added automatically; the caller
+ * is responsible for balancing begin and end calls and for giving every
+ * object member a key.
+ */
+class JsonWriter {
+ public:
+  explicit JsonWriter(std::string* out);
+
+  JsonWriter& beginObject();
+  JsonWriter& endObject();
+  JsonWriter& beginArray();
+  JsonWriter& endArray();
+  JsonWriter& key(const char* name);
+  JsonWriter& value(const std::string& text);
+  JsonWriter& value(const char* text);
+  JsonWriter& value(int64_t number);
+  JsonWriter& value(int number);
+  JsonWriter& value(bool flag);
+
+ private:
+  void separate();
+  void writeString(const char* text, size_t length);
+
+  std::string* out;
+  bool needsComma;
+};
+
+#endif
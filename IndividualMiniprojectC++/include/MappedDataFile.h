@@ -0,0 +1,68 @@
+#ifndef MAPPEDDATAFILE_H
+#define MAPPEDDATAFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Department.h"
+
+/**
+ * Read-only view of a data file in format version 4, mapped into memory.
+ *
+ * The file starts with a fixed header (magic, version, byte order mark,
+ * checkpoint LSN, department count, checksum) followed by a directory with
+ * the offset, size and CRC-32 of every department block, sorted by
+ * department code. Each block holds a fixed-size record per course, sorted
+ * by course number, and then the distinct strings of the department back to
+ * back, acting as the block's dictionary. A course's roster and waitlist
+ * are entries there too, in the form of Roster::encode() and
+ * Waitlist::encode(). Files of versions 2 and 3, whose course records end
+ * before the roster or the waitlist, are still read, with those empty.
+ * Opening a file only validates the header and directory, so a single
+ * department or course can be read without parsing the rest of the file.
+ */
+class MappedDataFile {
+ public:
+  static const uint32_t kVersion = 4;
+
+  explicit MappedDataFile(const std::string& path);
+  ~MappedDataFile();
+
+  MappedDataFile(const MappedDataFile&) = delete;
+  MappedDataFile& operator=(const MappedDataFile&) = delete;
+
+  static bool isMappedFormat(const std::string& path);
+  static std::string encodeDepartment(const std::string& deptCode,
+                                      const Department& department);
+  static Department decodeDepartment(const std::string& block,
+                                     std::string* deptCode);
+  static std::string encodeIndex(const std::vector<const std::string*>& blocks,
+                                 uint64_t checkpointLsn);
+
+  uint64_t getCheckpointLsn() const;
+  size_t getDepartmentCount() const;
+  std::string getDepartmentCode(size_t index) const;
+  Department readDepartment(size_t index) const;
+  bool readDepartment(const std::string& deptCode, Department& out) const;
+  bool readCourse(const std::string& deptCode, int courseNumber,
+                  Course& out) const;
+  std::map<std::string, Department> readAll() const;
+
+ private:
+  const char* blockAt(size_t index, size_t* size) const;
+  const char* verifiedBlockAt(size_t index, size_t* size) const;
+  Department decodeDepartment(size_t index, std::string* deptCode) const;
+  bool findDepartmentIndex(const std::string& deptCode, size_t* index) const;
+
+  std::string path;
+  const char* data;
+  size_t fileSize;
+  uint64_t checkpointLsn;
+  size_t departmentCount;
+  size_t courseRecordSize;
+};
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Request counters and latency histograms for every route, rendered in the
+ * Prometheus text format.
+ *
+ * Each thread that records a request gets its own shard of counters, so
+ * recording touches only memory no other thread writes and needs neither a
+ * lock nor an atomic read-modify-write. A scrape sums the shards; it may see
+ * a request counted in its status code but not yet in its histogram, which
+ * is fine for monitoring. Shards live as long as the Metrics object, so the
+ * counts of threads that exit are kept.
+ *
+ * Routes must be added before requests are recorded.
+ */
+class Metrics {
+ public:
+  static const int kMaxRoutes = 64;
+  // Upper bounds of the latency buckets, in microseconds; the last bucket
+  // has no bound
+  static const int kBucketCount = 15;
+  static const int64_t kBucketBounds[kBucketCount - 1];
+  // Status codes counted separately; others are counted as "other"
+  static const int kStatusCount = 8;
+  static const int kStatusCodes[kStatusCount - 1];
+
+  /**
+   * Records the time from its creation to its destruction as one request,
+   * with the status code current at destruction.
+   */
+  class Timer {
+   public:
+    Timer(Metrics* metrics, int route, const int* status)
+        : metrics(metrics),
+          route(route),
+          status(status),
+          start(std::chrono::steady_clock::now()) {}
+    ~Timer() {
+      metrics->record(route, *status,
+                      std::chrono::steady_clock::now() - start);
+    }
+
+   private:
+    Metrics* metrics;
+    int route;
+    const int* status;
+    std::chrono::steady_clock::time_point start;
+  };
+
+  Metrics();
+  ~Metrics();
+
+  Metrics(const Metrics&) = delete;
+  Metrics& operator=(const Metrics&) = delete;
+
+  int addRoute(const std::string& name);
+  void record(int route, int status, std::chrono::nanoseconds latency);
+
+  uint64_t getRequestCount(int route) const;
+  uint64_t getStatusCount(int route, int status) const;
+  uint64_t getBucketCount(int route, int bucket) const;
+  std::string render() const;
+
+ private:
+  struct Shard;
+
+  static int statusSlot(int status);
+  Shard* localShard();
+  uint64_t sum(int route, int slot) const;
+
+  const uint64_t id;
+  std::vector<std::string> routes;
+  mutable std::mutex shardsMutex;
+  std::vector<std::unique_ptr<Shard>> shards;
+};
+
+#endif
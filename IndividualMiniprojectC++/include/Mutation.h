@@ -0,0 +1,65 @@
+#ifndef MUTATION_H
+#define MUTATION_H
+
+#include <cstdint>
+#include <string>
+
+/**
+ * The kinds of changes clients can make to the database. The numeric values
+ * are written to the write-ahead log, so existing values must never change.
+ */
+enum class MutationType : uint8_t {
+  SetEnrollmentCount = 1,
+  ChangeLocation = 2,
+  ChangeInstructor = 3,
+  ChangeTime = 4,
+  AddMajor = 5,
+  RemoveMajor = 6,
+  EnrollStudent = 7,
+  DropStudent = 8,
+  EnrollStudentById = 9,
+  DropStudentById = 10,
+  JoinWaitlist = 11,
+  LeaveWaitlist = 12,
+  SetWaitlist = 13,
+  PromoteFromWaitlist = 14,
+};
+
+/**
+ * A single change to a department or one of its courses. Department-level
+ * mutations leave courseCode empty, and value holds the new attribute (the
+ * count for SetEnrollmentCount, the student ID for EnrollStudentById,
+ * DropStudentById, JoinWaitlist and LeaveWaitlist, the comma-separated IDs
+ * for SetWaitlist) or is empty when there is none. PromoteFromWaitlist is
+ * never requested; the database applies and logs it after a drop frees a
+ * seat.
+ * rejectConflicts makes a location or time change fail instead of booking a
+ * room that is already in use; it is not logged, since a logged change was
+ * already accepted.
+ */
+struct Mutation {
+  MutationType type;
+  std::string deptCode;
+  std::string courseCode;
+  std::string value;
+  bool rejectConflicts = false;
+};
+
+/**
+ * The outcome of applying a Mutation. Aborted marks a mutation of a batch
+ * that was left unapplied, or undone, because another one in it failed.
+ */
+enum class MutationStatus {
+  Applied,
+  DepartmentNotFound,
+  CourseNotFound,
+  Rejected,
+  RoomConflict,
+  Aborted,
+  AlreadyEnrolled,
+  NotEnrolled,
+  AlreadyWaitlisted,
+  NotWaitlisted,
+};
+
+#endif
@@ -6,20 +6,137 @@
 #ifndef MYFILEDATABASE_H
 #define MYFILEDATABASE_H
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include "CourseIndex.h"
+#include "Mutation.h"
+#include "ResponseCache.h"
+#include "RoomIndex.h"
+#include "SearchIndex.h"
+#include "StudentIndex.h"
+#include "TimeSlotIndex.h"
+#include "WriteAheadLog.h"
+
 class MyFileDatabase {
  public:
+  using ReadLock = std::shared_lock<std::shared_timed_mutex>;
+  using WriteLock = std::unique_lock<std::shared_timed_mutex>;
+  // Every department in the block format of the data file, sharing the
+  // blocks of departments unchanged since the last checkpoint
+  using CatalogSnapshot = std::vector<std::shared_ptr<const std::string>>;
+
   MyFileDatabase(int flag, const std::string& filePath);
+  ~MyFileDatabase();
+
+  // The lock stripes are over-aligned, which new only honours from C++17.
+  static void* operator new(size_t size);
+  static void operator delete(void* pointer);
 
   void setMapping(const std::map<std::string, Department>& mapping);
-  void saveContentsToFile() const;
+  void saveContentsToFile();
   void deSerializeObjectFromFile();
 
-  std::map<std::string, Department> getDepartmentMapping() const;
+  void checkpoint(bool full);
+  void startCheckpointing(std::chrono::milliseconds interval);
+  void stopCheckpointing();
+  bool hasUnsavedChanges() const;
+  uint64_t getCheckpointCount() const;
+  std::chrono::microseconds getLastCheckpointDuration() const;
+
+  MutationStatus applyMutation(const Mutation& mutation);
+  bool applyMutations(const std::vector<Mutation>& mutations,
+                      std::vector<MutationStatus>* statuses);
+
+  ReadLock acquireReadLock(const std::string& deptCode) const;
+  std::vector<ReadLock> acquireReadLocks(
+      const std::vector<std::string>& deptCodes) const;
+  std::vector<ReadLock> acquireAllReadLocks() const;
+  WriteLock acquireWriteLock(const std::string& deptCode) const;
+
+  const std::map<std::string, Department>& getDepartmentMapping() const;
+  Department* findDepartment(const std::string& deptCode);
+  const Department* findDepartment(const std::string& deptCode) const;
+  const TimeSlotIndex& getTimeSlotIndex() const;
+  const RoomIndex& getRoomIndex() const;
+  const CourseIndex& getInstructorIndex() const;
+  const SearchIndex& getInstructorSearch() const;
+  const SearchIndex& getLocationSearch() const;
+  const StudentIndex& getStudentIndex() const;
+  ResponseCache& getResponseCache() const;
+  size_t getDepartmentCount() const;
+  size_t getCourseCount() const;
   std::string display() const;
+  void writeJson(JsonWriter& writer) const;
+  CatalogSnapshot snapshotCatalog() const;
+  static void writeCatalog(std::ostream& out, const CatalogSnapshot& snapshot,
+                           bool json);
 
  private:
+  static const size_t kLockStripes = 32;
+
+  // Aligned to a cache line so that neighbouring stripes do not contend.
+  struct alignas(64) LockStripe {
+    std::shared_timed_mutex mutex;
+  };
+
+  std::shared_timed_mutex& stripeFor(const std::string& deptCode) const;
+  std::set<size_t> stripesFor(const std::vector<std::string>& deptCodes) const;
+  std::vector<WriteLock> acquireWriteLocks(
+      const std::vector<std::string>& deptCodes) const;
+  std::vector<WriteLock> acquireAllWriteLocks() const;
+  MutationStatus applyUnlocked(const Mutation& mutation, bool replaying);
+  bool inverseOf(const Mutation& mutation, Mutation* inverse);
+  bool hasWaitlist(const Mutation& mutation) const;
+  void promoteWaitlisted(const Mutation& cause, std::vector<Mutation>* logged,
+                         std::vector<Mutation>* undo);
+  void markDirty(const std::string& deptCode);
+  void markAllDirty();
+  void writeCheckpointFile(uint64_t lsn) const;
+  void rebuildIndexes();
+
   std::map<std::string, Department> departmentMapping;
   std::string filePath;
+  uint64_t checkpointLsn;
+  std::unique_ptr<WriteAheadLog> writeAheadLog;
+  mutable std::array<LockStripe, kLockStripes> lockStripes;
+  TimeSlotIndex timeSlotIndex;
+  RoomIndex roomIndex;
+  CourseIndex instructorIndex;
+  SearchIndex instructorSearch;
+  SearchIndex locationSearch;
+  StudentIndex studentIndex;
+  mutable ResponseCache responseCache;
+
+  // Departments changed since the last checkpoint
+  mutable std::mutex dirtyMutex;
+  std::set<std::string> dirtyDepartments;
+  bool fullCheckpointNeeded;
+
+  // Serialized bytes of every department as of the last checkpoint, so a
+  // checkpoint only re-serializes the dirty ones. Only changed while every
+  // department is write-locked, and a block is replaced rather than
+  // modified, since catalog snapshots may still share it.
+  std::mutex checkpointMutex;
+  std::map<std::string, std::shared_ptr<const std::string>>
+      serializedDepartments;
+  std::atomic<uint64_t> checkpointCount;
+  std::atomic<int64_t> lastCheckpointMicros;
+
+  std::mutex checkpointThreadMutex;
+  std::condition_variable checkpointWakeup;
+  bool stopCheckpointRequested;
+  std::thread checkpointThread;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,102 @@
+#ifndef RESPONSECACHE_H
+#define RESPONSECACHE_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+#include "Compression.h"
+#include "ShardedCounter.h"
+
+/**
+ * Rendered response bodies of departments and courses, so that reading the
+ * same department or course again copies the stored text instead of
+ * rendering it. A body is cached separately in each content coding it is
+ * sent in, so it is compressed only once per version.
+ *
+ * Callers must store a body while holding at least a read lock on its
+ * department, and invalidate it while holding the write lock, so a body is
+ * never stored after the change that makes it stale. Changing a course also
+ * drops its department's body, which lists every course. The cache is split
+ * into shards by department code, each with its own lock, so readers of
+ * different departments do not contend. Hits and misses are counted in
+ * ShardedCounters, so readers of the same department do not contend on
+ * the counts either.
+ *
+ * Each department and course also has a version, bumped whenever its body is
+ * invalidated, from which its HTTP entity tag is made. Versions outlive the
+ * bodies they describe, and clearing the cache starts a new generation, so a
+ * tag is never given to two different bodies, even across restarts. A
+ * catalog-wide version, bumped along with every department's, tags exports
+ * of the whole catalog.
+ */
+class ResponseCache {
+ public:
+  using Body = std::shared_ptr<const std::string>;
+
+  ResponseCache();
+
+  Body findDepartment(
+      const std::string& deptCode,
+      ContentEncoding encoding = ContentEncoding::Identity) const;
+  Body findCourse(const std::string& deptCode, int courseNumber,
+                  ContentEncoding encoding = ContentEncoding::Identity) const;
+  Body storeDepartment(const std::string& deptCode, std::string body,
+                       ContentEncoding encoding = ContentEncoding::Identity);
+  Body storeCourse(const std::string& deptCode, int courseNumber,
+                   std::string body,
+                   ContentEncoding encoding = ContentEncoding::Identity);
+
+  std::string getDepartmentTag(const std::string& deptCode) const;
+  std::string getCourseTag(const std::string& deptCode, int courseNumber) const;
+  std::string getCatalogTag() const;
+
+  void invalidateCourse(const std::string& deptCode, int courseNumber);
+  void clear();
+
+  uint64_t getHitCount() const;
+  uint64_t getMissCount() const;
+  size_t size() const;
+
+ private:
+  static const size_t kShards = 32;
+
+  // A body in each content coding, indexed by ContentEncoding
+  using Bodies = std::array<Body, kContentEncodings>;
+
+  // A course's cached bodies and its version
+  struct CourseEntry {
+    Bodies bodies;
+    uint64_t version = 0;
+  };
+
+  // The bodies and versions of one department and its courses
+  struct Entry {
+    Bodies department;
+    uint64_t version = 0;
+    std::unordered_map<int, CourseEntry> courses;
+  };
+
+  // Padded to a cache line so that neighbouring shards do not contend.
+  struct Shard {
+    mutable std::shared_timed_mutex mutex;
+    std::unordered_map<std::string, Entry> departments;
+    char padding[64];
+  };
+
+  Shard& shardFor(const std::string& deptCode) const;
+  Body count(Body body) const;
+  std::string makeTag(uint64_t version) const;
+
+  mutable std::array<Shard, kShards> shards;
+  mutable ShardedCounter hits;
+  mutable ShardedCounter misses;
+  std::atomic<uint64_t> generation;
+  std::atomic<uint64_t> catalogVersion;
+};
+
+#endif
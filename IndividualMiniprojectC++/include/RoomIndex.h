@@ -0,0 +1,68 @@
+#ifndef ROOMINDEX_H
+#define ROOMINDEX_H
+
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "TimeSlot.h"
+
+/**
+ * Two courses booked in the same room at overlapping times.
+ */
+struct RoomConflict {
+  std::string location;
+  ScheduledCourse first;
+  ScheduledCourse second;
+};
+
+/**
+ * Inverted index from a location to the courses held there. Rooms hold few
+ * courses, so each room keeps its courses in a small vector and a room's
+ * conflicts are found by sorting and sweeping just that vector.
+ *
+ * Courses without a location are not indexed, and courses without a valid
+ * time slot are indexed but never conflict. The index is thread-safe; an
+ * update checks for conflicts and applies the change under one lock, so two
+ * concurrent updates cannot both book the same free slot. Like
+ * TimeSlotIndex, the rooms passed to rebuild() are only grouped by the first
+ * call that needs them.
+ */
+class RoomIndex {
+ public:
+  /**
+   * A course and the location it is held in.
+   */
+  struct Booking {
+    std::string location;
+    ScheduledCourse course;
+  };
+
+  RoomIndex();
+
+  void rebuild(std::vector<Booking> bookings);
+  bool update(const std::string& deptCode, int courseNumber,
+              const std::string& oldLocation, const std::string& newLocation,
+              const TimeSlot& newSlot, bool rejectConflicts);
+
+  std::vector<ScheduledCourse> findCourses(const std::string& location) const;
+  std::vector<RoomConflict> findConflicts(const std::string& location) const;
+  std::vector<RoomConflict> findAllConflicts() const;
+  size_t getRoomCount() const;
+
+ private:
+  static void appendConflicts(const std::string& location,
+                              std::vector<ScheduledCourse> courses,
+                              std::vector<RoomConflict>* out);
+  void buildPendingUnlocked() const;
+  std::shared_lock<std::shared_timed_mutex> lockForQuery() const;
+
+  mutable std::shared_timed_mutex mutex;
+  // Bookings passed to rebuild() and not yet grouped by room
+  mutable std::vector<Booking> pending;
+  mutable bool hasPending;
+  mutable std::unordered_map<std::string, std::vector<ScheduledCourse>> rooms;
+};
+
+#endif
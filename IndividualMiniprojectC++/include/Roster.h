@@ -0,0 +1,36 @@
+#ifndef ROSTER_H
+#define ROSTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * The students enrolled in a course by ID, kept as a sorted vector: four
+ * bytes per student, with membership found by binary search. A course
+ * enrolls at most a few hundred students, so shifting the tail of the
+ * vector on an insert or removal is one short memmove. In the data file a
+ * roster is written as the varint gaps between successive IDs, one to three
+ * bytes each for IDs drawn from a university-sized range.
+ *
+ * A roster is not thread-safe; courses only change theirs under the write
+ * lock of their department.
+ */
+class Roster {
+ public:
+  bool contains(uint32_t studentId) const;
+  bool add(uint32_t studentId);
+  bool remove(uint32_t studentId);
+  size_t size() const;
+  const std::vector<uint32_t>& getStudentIds() const;
+
+  std::string encode() const;
+  static bool decode(const char* data, size_t size, Roster* out);
+  static bool parseStudentId(const std::string& text, uint32_t* studentId);
+
+ private:
+  std::vector<uint32_t> studentIds;
+};
+
+#endif
@@ -1,27 +1,68 @@
 #ifndef ROUTECONTROLLER_H
 #define ROUTECONTROLLER_H
 
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "Compression.h"
 #include "Globals.h"
+#include "Metrics.h"
 #include "MyFileDatabase.h"
 #include "crow.h"
 
 class RouteController {
  private:
-  MyFileDatabase* myFileDatabase;
+  MyFileDatabase* myFileDatabase = nullptr;
+  Metrics metrics;
+
+  // The latest export file of the catalog in each format, text then JSON,
+  // and each content coding, reused until the catalog changes. Each is
+  // locked on its own, so writing one does not hold up requests for
+  // another. Replaced files are kept for a while, since a response naming
+  // one may not have opened it yet. All of them live in a temporary
+  // directory made for this controller on its first export.
+  struct CatalogExport {
+    std::mutex mutex;
+    std::string tag;
+    std::string path;
+  };
+  CatalogExport catalogExports[2 * kContentEncodings];
+  std::mutex exportFilesMutex;  // guards the two members below
+  std::string exportDirectory;
+  std::map<std::string, std::chrono::steady_clock::time_point> retiredExports;
+
+  void writeCatalogExport(CatalogExport& current, const std::string& tag,
+                          const MyFileDatabase::CatalogSnapshot& snapshot,
+                          bool json, ContentEncoding encoding);
 
  public:
+  ~RouteController();
+
   void initRoutes(crow::App<>& app);
   void setDatabase(MyFileDatabase* db);
 
   void index(crow::response& res);
+  void exportMetrics(crow::response& res);
   void retrieveDepartment(const crow::request& req, crow::response& res);
   void retrieveCourse(const crow::request& req, crow::response& res);
+  void retrieveCourses(const crow::request& req, crow::response& res);
+  void exportCatalog(const crow::request& req, crow::response& res);
   void isCourseFull(const crow::request& req, crow::response& res);
+  void isStudentEnrolled(const crow::request& req, crow::response& res);
+  void retrieveStudentCourses(const crow::request& req, crow::response& res);
   void getMajorCountFromDept(const crow::request& req, crow::response& res);
   void identifyDeptChair(const crow::request& req, crow::response& res);
   void findCourseLocation(const crow::request& req, crow::response& res);
   void findCourseInstructor(const crow::request& req, crow::response& res);
   void findCourseTime(const crow::request& req, crow::response& res);
+  void findCoursesMeetingAt(const crow::request& req, crow::response& res);
+  void findCourseConflicts(const crow::request& req, crow::response& res);
+  void findRoomConflicts(const crow::request& req, crow::response& res);
+  void coursesByInstructor(const crow::request& req, crow::response& res);
+  void coursesByLocation(const crow::request& req, crow::response& res);
+  void search(const crow::request& req, crow::response& res);
   void addMajorToDept(const crow::request& req, crow::response& res);
   void removeMajorFromDept(const crow::request& req, crow::response& res);
   void setEnrollmentCount(const crow::request& req, crow::response& res);
@@ -29,6 +70,11 @@ class RouteController {
   void setCourseInstructor(const crow::request& req, crow::response& res);
   void setCourseTime(const crow::request& req, crow::response& res);
   void dropStudentFromCourse(const crow::request&, crow::response& res);
+  void enrollStudentInCourse(const crow::request& req, crow::response& res);
+  void joinWaitlist(const crow::request& req, crow::response& res);
+  void leaveWaitlist(const crow::request& req, crow::response& res);
+  void getWaitlistPosition(const crow::request& req, crow::response& res);
+  void batchUpdate(const crow::request& req, crow::response& res);
 };
 
 #endif
@@ -0,0 +1,78 @@
+#ifndef SEARCHINDEX_H
+#define SEARCHINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Fuzzy, type-ahead search over the distinct values of a course attribute,
+ * such as instructor names or locations. Every value is split into
+ * lower-cased words, each padded with two spaces in front and one behind,
+ * and indexed under every three-character window (trigram) of them, so
+ * "Choromanski" gives "  c", " ch", "cho", ..., "ki ". A query is split the
+ * same way, except that its last word is taken as a prefix still being
+ * typed and gets no padding behind. Values are ranked by the share of the
+ * query's trigrams they contain, then by how little else they contain, so
+ * "chormanski" still finds "Krzysztof M Choromanski" and "ad" prefers
+ * "Adam Cannon" to "Adam Cannon Jr".
+ *
+ * A search only visits the postings of the query's trigrams, never every
+ * value. Many courses share a value, so each value is counted and indexed
+ * once. The index is thread-safe. Like RoomIndex, the values passed to
+ * rebuild() are only indexed by the first call that needs them.
+ */
+class SearchIndex {
+ public:
+  // Share of a query's trigrams a value must contain to match
+  static constexpr double kMinScore = 0.5;
+
+  /**
+   * A value found by a search and the share of the query's trigrams it
+   * contains, from kMinScore to 1.
+   */
+  struct Match {
+    std::string value;
+    double score;
+  };
+
+  SearchIndex();
+
+  void rebuild(std::vector<std::string> values);
+  void add(const std::string& value);
+  void remove(const std::string& value);
+  void update(const std::string& oldValue, const std::string& newValue);
+
+  std::vector<Match> search(const std::string& query, size_t limit) const;
+  size_t size() const;
+
+ private:
+  struct Entry {
+    std::string value;
+    // Courses with the value; 0 marks a free slot
+    int count;
+    uint32_t trigramCount;
+  };
+
+  static std::vector<uint32_t> trigramsOf(const std::string& text,
+                                          bool prefix);
+  void addUnlocked(const std::string& value, int count) const;
+  void removeUnlocked(const std::string& value);
+  void buildPendingUnlocked() const;
+  std::shared_lock<std::shared_timed_mutex> lockForQuery() const;
+
+  mutable std::shared_timed_mutex mutex;
+  // Values passed to rebuild() and not yet indexed
+  mutable std::vector<std::string> pending;
+  mutable bool hasPending;
+  mutable std::vector<Entry> entries;
+  mutable std::vector<uint32_t> freeIds;
+  mutable std::unordered_map<std::string, uint32_t> ids;
+  // The ids of the values containing each trigram, in ascending order
+  mutable std::unordered_map<uint32_t, std::vector<uint32_t>> postings;
+};
+
+#endif
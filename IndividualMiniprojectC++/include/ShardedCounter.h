@@ -0,0 +1,45 @@
+#ifndef SHARDEDCOUNTER_H
+#define SHARDEDCOUNTER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * A counter that many threads can add to without contending. It is split
+ * into slots, each on its own cache line, and every thread adds to the slot
+ * picked for it when it first counts something; a read sums the slots. A
+ * popular department's major count is changed by every request for it, and
+ * with a single counter each change would wait for the cache line to move
+ * from the core that made the last one.
+ *
+ * Adding and reading are thread-safe. A read while others add sees some of
+ * the concurrent additions, as a read of a plain atomic would. Setting the
+ * value, copying and assigning must not race with additions.
+ */
+class ShardedCounter {
+ public:
+  static const int kSlots = 16;
+
+  explicit ShardedCounter(int64_t value = 0);
+  ShardedCounter(const ShardedCounter& other);
+  ShardedCounter& operator=(const ShardedCounter& other);
+
+  void add(int64_t delta);
+  int64_t load() const;
+  void store(int64_t value);
+
+ private:
+  // Padded to a cache line so that threads adding to neighbouring slots do
+  // not contend
+  struct Slot {
+    std::atomic<int64_t> value;
+    char padding[64 - sizeof(std::atomic<int64_t>)];
+  };
+
+  static int localSlot();
+
+  std::array<Slot, kSlots> slots;
+};
+
+#endif
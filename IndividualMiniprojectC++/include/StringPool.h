@@ -0,0 +1,70 @@
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * Process-wide table of unique strings. Course attributes such as
+ * instructors, rooms and time slots repeat across thousands of sections, so
+ * each distinct value is stored once and courses only hold a handle to it.
+ *
+ * Every string counts the handles referring to it. Strings no handle refers
+ * to any more are freed by a sweep, run once the pool has gained as many
+ * strings as it kept after the previous one, so a client setting ever new
+ * instructors or locations cannot grow the pool without bound, and adding
+ * a string stays constant time on average.
+ */
+class StringPool {
+ public:
+  // A pooled string and the number of handles referring to it
+  using Entry = std::pair<const std::string, std::atomic<size_t>>;
+
+  static StringPool& global();
+
+  Entry* acquire(const std::string& value);
+  static void release(Entry* entry);
+  void sweep();
+  size_t size() const;
+
+ private:
+  void sweepUnlocked();
+
+  mutable std::shared_timed_mutex mutex;
+  // Node-based, so entry addresses survive a rehash
+  std::unordered_map<std::string, std::atomic<size_t>> strings;
+  // Strings added since the last sweep, and how many make the next one due
+  size_t addedSinceSweep = 0;
+  size_t sweepInterval = 0;
+};
+
+/**
+ * Counted handle to a string in the global StringPool. Copying it copies a
+ * pointer and counts one more reference, and two handles are equal exactly
+ * when their strings are equal.
+ */
+class InternedString {
+ public:
+  InternedString();
+  explicit InternedString(const std::string& value);
+  InternedString(const InternedString& other);
+  InternedString& operator=(const InternedString& other);
+  ~InternedString();
+
+  const std::string& str() const { return entry->first; }
+  bool operator==(const InternedString& other) const {
+    return entry == other.entry;
+  }
+  bool operator!=(const InternedString& other) const {
+    return entry != other.entry;
+  }
+
+ private:
+  StringPool::Entry* entry;
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef STUDENTINDEX_H
+#define STUDENTINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "StringPool.h"
+
+/**
+ * Reverse index from a student ID to the courses the student is enrolled in
+ * by ID, the inverse of every course's Roster, so a student's courses are
+ * found with one hash lookup instead of a search of every roster. A student
+ * takes a handful of courses, so each keeps them in a small vector sorted by
+ * department code and course number, holding interned department codes.
+ *
+ * The index is thread-safe, since rosters of different departments change
+ * concurrently under their own locks.
+ */
+class StudentIndex {
+ public:
+  /**
+   * A course a student is enrolled in.
+   */
+  struct Enrollment {
+    std::string deptCode;
+    int courseNumber;
+  };
+
+  /**
+   * A student's enrollment in a course, as passed to rebuild().
+   */
+  struct Record {
+    uint32_t studentId;
+    Enrollment course;
+  };
+
+  void rebuild(const std::vector<Record>& records);
+  void add(uint32_t studentId, const std::string& deptCode, int courseNumber);
+  void remove(uint32_t studentId, const std::string& deptCode,
+              int courseNumber);
+
+  std::vector<Enrollment> findCourses(uint32_t studentId) const;
+  size_t getStudentCount() const;
+
+ private:
+  struct Entry {
+    InternedString deptCode;
+    int courseNumber;
+  };
+
+  static bool comesBefore(const Entry& entry, const std::string& deptCode,
+                          int courseNumber);
+  void addUnlocked(uint32_t studentId, const std::string& deptCode,
+                   int courseNumber);
+
+  mutable std::shared_timed_mutex mutex;
+  std::unordered_map<uint32_t, std::vector<Entry>> students;
+};
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef TIMESLOT_H
+#define TIMESLOT_H
+
+#include <cstdint>
+#include <string>
+
+#include "StringPool.h"
+
+/**
+ * The time a course meets, such as "11:40-12:55" or "MW 11:40-12:55". The
+ * text is kept as written, and parsed into start and end minutes after
+ * midnight plus a bit mask of the days of the week (M T W R F S U). A slot
+ * without days meets every day.
+ *
+ * The catalog writes times on a 12-hour clock without am/pm, so hours 8 to
+ * 11 are read as morning, 12 as noon and 1 to 7 as afternoon or evening;
+ * hours 0 and 13 to 23 are read as a 24-hour clock. An end time is the first
+ * one after the start, so "7:10-9:40" ends at 21:40.
+ *
+ * Text that cannot be parsed gives an invalid slot that still displays as
+ * written, so data files with free-form times remain readable.
+ */
+class TimeSlot {
+ public:
+  static const uint8_t kEveryDay = 0x7f;
+  static const int kMinutesPerDay = 24 * 60;
+
+  TimeSlot();
+  explicit TimeSlot(const std::string& text);
+
+  static bool parseTime(const std::string& text, int* minute);
+  static bool parseDays(const std::string& text, uint8_t* days);
+
+  const std::string& str() const { return text.str(); }
+  bool isValid() const { return days != 0; }
+  int getStartMinute() const { return startMinute; }
+  int getEndMinute() const { return endMinute; }
+  uint8_t getDays() const { return days; }
+
+  bool meetsAt(int minute, uint8_t onDays) const;
+  bool overlaps(const TimeSlot& other) const;
+
+ private:
+  InternedString text;
+  int16_t startMinute;
+  int16_t endMinute;
+  uint8_t days;
+};
+
+/**
+ * A course together with the time it meets.
+ */
+struct ScheduledCourse {
+  std::string deptCode;
+  int courseNumber;
+  TimeSlot timeSlot;
+};
+
+#endif
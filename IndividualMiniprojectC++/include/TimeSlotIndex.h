@@ -0,0 +1,69 @@
+#ifndef TIMESLOTINDEX_H
+#define TIMESLOTINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include "TimeSlot.h"
+
+/**
+ * Interval tree over the time slots of every course in the catalog. It is a
+ * treap ordered by start minute in which each node also records the latest
+ * end minute below it, so a query skips every subtree that ends before the
+ * interval it asks about. Matches come out in tree order, by start time, so
+ * a query does no work per match beyond copying it.
+ *
+ * Courses without a valid time slot are not indexed. The index is
+ * thread-safe; queries share a lock and updates take it exclusively. A tree
+ * passed to rebuild() is only built by the first call that needs it, so
+ * loading a catalog that is never queried by time costs almost nothing.
+ */
+class TimeSlotIndex {
+ public:
+  TimeSlotIndex();
+  ~TimeSlotIndex();
+
+  TimeSlotIndex(const TimeSlotIndex&) = delete;
+  TimeSlotIndex& operator=(const TimeSlotIndex&) = delete;
+
+  void rebuild(std::vector<ScheduledCourse> courses);
+  void insert(const ScheduledCourse& course);
+  bool erase(const ScheduledCourse& course);
+  void update(const std::string& deptCode, int courseNumber,
+              const TimeSlot& oldSlot, const TimeSlot& newSlot);
+
+  std::vector<ScheduledCourse> findMeetingAt(int minute, uint8_t days) const;
+  std::vector<ScheduledCourse> findOverlapping(const TimeSlot& slot) const;
+  size_t size() const;
+
+ private:
+  struct Node;
+  using NodePtr = std::unique_ptr<Node>;
+
+  static NodePtr build(std::vector<ScheduledCourse>* courses, size_t begin,
+                       size_t end, uint32_t priority);
+  static void split(NodePtr node, const ScheduledCourse& key, NodePtr* less,
+                    NodePtr* rest);
+  static NodePtr merge(NodePtr first, NodePtr second);
+  static bool eraseFrom(NodePtr* node, const ScheduledCourse& key);
+  static void collect(const Node* node, int start, int end, uint8_t days,
+                      std::vector<ScheduledCourse>* out);
+  void insertUnlocked(const ScheduledCourse& course);
+  void buildPendingUnlocked() const;
+  std::shared_lock<std::shared_timed_mutex> lockForQuery() const;
+
+  mutable std::shared_timed_mutex mutex;
+  // Courses passed to rebuild() and not yet built into the tree
+  mutable std::vector<ScheduledCourse> pending;
+  mutable bool hasPending;
+  mutable NodePtr root;
+  mutable size_t count;
+  std::minstd_rand random;
+};
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef WAITLIST_H
+#define WAITLIST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * The students waiting for a seat in a full course, by ID, in the order
+ * they joined. When a seat frees up the first one is enrolled. Waitlists
+ * hold at most a few hundred students, so they are kept as a plain vector
+ * and a student's position is found by a linear scan. In the data file a
+ * waitlist is written as one varint per ID, in order.
+ *
+ * A waitlist is not thread-safe; courses only change theirs under the write
+ * lock of their department.
+ */
+class Waitlist {
+ public:
+  bool join(uint32_t studentId);
+  bool leave(uint32_t studentId);
+  size_t getPosition(uint32_t studentId) const;
+  uint32_t front() const;
+  void popFront();
+  bool empty() const;
+  size_t size() const;
+  const std::vector<uint32_t>& getStudentIds() const;
+
+  std::string str() const;
+  static bool parse(const std::string& text, Waitlist* out);
+  std::string encode() const;
+  static bool decode(const char* data, size_t size, Waitlist* out);
+
+ private:
+  std::vector<uint32_t> studentIds;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef WRITEAHEADLOG_H
+#define WRITEAHEADLOG_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Mutation.h"
+
+/**
+ * Append-only log of mutations that makes them durable without rewriting
+ * the data file. Every record gets a log sequence number (LSN). Records are
+ * buffered by append() and written with group commit: the first thread to
+ * wait for durability writes and fsyncs everything buffered so far, and
+ * threads that arrive meanwhile are covered by the same or the next flush.
+ * A batch of mutations can share one record, so that replay applies either
+ * all of them or none.
+ */
+class WriteAheadLog {
+ public:
+  explicit WriteAheadLog(const std::string& logPath);
+  ~WriteAheadLog();
+
+  WriteAheadLog(const WriteAheadLog&) = delete;
+  WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+  uint64_t append(const Mutation& mutation);
+  uint64_t append(const std::vector<Mutation>& mutations);
+  void waitForDurable(uint64_t lsn);
+  void replay(uint64_t afterLsn,
+              const std::function<void(const Mutation&)>& apply);
+  void truncate();
+  uint64_t rotate();
+  void discardRotated();
+  uint64_t getLastLsn() const;
+  void advanceLastLsn(uint64_t lsn);
+
+ private:
+  uint64_t appendRecord(const std::string& body);
+  void writeBatch(const std::string& batch);
+  size_t replayFile(const std::string& path, uint64_t afterLsn,
+                    const std::function<void(const Mutation&)>& apply,
+                    size_t* fileSize = nullptr);
+  std::string getRotatedPath() const;
+
+  std::string logPath;
+  int fd;
+
+  mutable std::mutex mutex;
+  std::condition_variable flushed;
+  std::string pendingRecords;
+  uint64_t lastLsn;
+  uint64_t durableLsn;
+  bool flushInProgress;
+  // Set when a failed write could not be cut off again
+  std::atomic<bool> failed;
+};
+
+#endif
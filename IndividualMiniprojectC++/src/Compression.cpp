@@ -0,0 +1,124 @@
+// Copyright 2024 Maria Surani
+#include "Compression.h"
+
+#include <zlib.h>
+
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+// The zlib window bits selecting each coding's header: gzip's, or zlib's,
+// which is what HTTP calls deflate
+int windowBits(ContentEncoding encoding) {
+  return encoding == ContentEncoding::Gzip ? 15 + 16 : 15;
+}
+
+void initDeflate(z_stream* stream, ContentEncoding encoding) {
+  if (encoding == ContentEncoding::Identity) {
+    throw std::invalid_argument("Identity is not a compression");
+  }
+  if (deflateInit2(stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                   windowBits(encoding), 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+    throw std::runtime_error("Could not start compressing");
+  }
+}
+
+}  // namespace
+
+const char* contentEncodingName(ContentEncoding encoding) {
+  switch (encoding) {
+    case ContentEncoding::Gzip:
+      return "gzip";
+    case ContentEncoding::Deflate:
+      return "deflate";
+    default:
+      return "identity";
+  }
+}
+
+std::string compress(const std::string& data, ContentEncoding encoding) {
+  if (encoding == ContentEncoding::Identity) return data;
+  z_stream stream{};
+  initDeflate(&stream, encoding);
+  // deflateBound() is enough for the whole output, so one call finishes it
+  std::string result(deflateBound(&stream, data.size()), '\0');
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+  stream.avail_in = static_cast<uInt>(data.size());
+  stream.next_out = reinterpret_cast<Bytef*>(&result[0]);
+  stream.avail_out = static_cast<uInt>(result.size());
+  int status = deflate(&stream, Z_FINISH);
+  deflateEnd(&stream);
+  if (status != Z_STREAM_END) {
+    throw std::runtime_error("Could not compress");
+  }
+  result.resize(stream.total_out);
+  return result;
+}
+
+/**
+ * Creates a buffer compressing into a sink.
+ *
+ * @param sink     the buffer to write compressed output to; it must outlive
+ *                 this one
+ * @param encoding gzip or deflate
+ */
+CompressingStreamBuf::CompressingStreamBuf(std::streambuf* sink,
+                                           ContentEncoding encoding)
+    : sink(sink), stream(new z_stream_s()), finished(false), failed(false) {
+  initDeflate(stream.get(), encoding);
+}
+
+CompressingStreamBuf::~CompressingStreamBuf() { deflateEnd(stream.get()); }
+
+/**
+ * Writes the end of the compressed stream and flushes the sink. Nothing may
+ * be written afterwards.
+ *
+ * @return whether all output reached the sink
+ */
+bool CompressingStreamBuf::finish() {
+  if (!finished && !failed) {
+    finished = true;
+    deflateInput(nullptr, 0, Z_FINISH);
+    if (sink->pubsync() != 0) failed = true;
+  }
+  return !failed;
+}
+
+std::streamsize CompressingStreamBuf::xsputn(const char* data,
+                                             std::streamsize size) {
+  if (finished || !deflateInput(data, static_cast<size_t>(size), Z_NO_FLUSH)) {
+    return 0;
+  }
+  return size;
+}
+
+CompressingStreamBuf::int_type CompressingStreamBuf::overflow(int_type c) {
+  if (traits_type::eq_int_type(c, traits_type::eof())) return 0;
+  char ch = traits_type::to_char_type(c);
+  return xsputn(&ch, 1) == 1 ? c : traits_type::eof();
+}
+
+// Feeds input to zlib and passes on every block of output it produces, until
+// zlib leaves space in the block, which means it needs more input or, for
+// Z_FINISH, that the stream is complete.
+bool CompressingStreamBuf::deflateInput(const char* data, size_t size,
+                                        int flush) {
+  stream->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+  stream->avail_in = static_cast<uInt>(size);
+  do {
+    stream->next_out = reinterpret_cast<Bytef*>(output);
+    stream->avail_out = sizeof(output);
+    if (deflate(stream.get(), flush) == Z_STREAM_ERROR) {
+      failed = true;
+      return false;
+    }
+    std::streamsize produced = sizeof(output) - stream->avail_out;
+    if (sink->sputn(output, produced) != produced) {
+      failed = true;
+      return false;
+    }
+  } while (stream->avail_out == 0);
+  return true;
+}
@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <string>
+#include <utility>
 
 /**
  * Constructs a new Course object with the given parameters. Initial count
@@ -23,58 +24,243 @@ Course::Course(int capacity, const std::string& instructorName,
       courseTimeSlot(timeSlot) {}
 
 /**
- * Constructs a default Course object with the default parameters.
+ * Constructs a default Course object with the default parameters. The
+ * string attributes default to the empty string.
  *
  */
-Course::Course()
-    : enrollmentCapacity(0),
-      enrolledStudentCount(0),
-      courseLocation(""),
-      instructorName(""),
-      courseTimeSlot("") {}
+Course::Course() : enrollmentCapacity(0), enrolledStudentCount(0) {}
+
+/**
+ * Copies a course, taking a snapshot of its enrolled student count. Copies
+ * are only safe while no other thread modifies the original.
+ *
+ * @param other The course to copy.
+ */
+Course::Course(const Course& other)
+    : enrollmentCapacity(other.enrollmentCapacity),
+      enrolledStudentCount(other.getEnrolledStudentCount()),
+      courseLocation(other.courseLocation),
+      instructorName(other.instructorName),
+      courseTimeSlot(other.courseTimeSlot),
+      roster(other.roster),
+      waitlist(other.waitlist) {}
+
+/**
+ * Replaces this course with a copy of another one.
+ *
+ * @param other The course to copy.
+ * @return A reference to this course.
+ */
+Course& Course::operator=(const Course& other) {
+  enrollmentCapacity = other.enrollmentCapacity;
+  setEnrolledStudentCount(other.getEnrolledStudentCount());
+  courseLocation = other.courseLocation;
+  instructorName = other.instructorName;
+  courseTimeSlot = other.courseTimeSlot;
+  roster = other.roster;
+  waitlist = other.waitlist;
+  return *this;
+}
 
 /**
- * Enrolls a student in the course if there is space available.
+ * Enrolls a student in the course if there is space available. The capacity
+ * check and the increment are a single compare-and-swap, so concurrent
+ * callers never push the count past the enrollment capacity and never block.
  *
  * @return true if the student is successfully enrolled, false otherwise.
  */
 bool Course::enrollStudent() {
-  if (enrolledStudentCount >= enrollmentCapacity) return false;
-  enrolledStudentCount++;
-  return false;
+  int current = enrolledStudentCount.load(std::memory_order_relaxed);
+  do {
+    if (current >= enrollmentCapacity) return false;
+  } while (!enrolledStudentCount.compare_exchange_weak(
+      current, current + 1, std::memory_order_relaxed));
+  return true;
 }
 
 /**
- * Drops a student from the course if a student is enrolled.
+ * Drops a student from the course if a student is enrolled. Like
+ * enrollStudent(), this is lock-free. It never takes the count below the
+ * number of students on the roster, who can only be dropped by ID.
  *
  * @return true if the student is successfully dropped, false otherwise.
  */
 bool Course::dropStudent() {
-  if (enrolledStudentCount == 0) return false;
-  enrolledStudentCount--;
+  int named = static_cast<int>(roster.size());
+  int current = enrolledStudentCount.load(std::memory_order_relaxed);
+  do {
+    if (current <= named) return false;
+  } while (!enrolledStudentCount.compare_exchange_weak(
+      current, current - 1, std::memory_order_relaxed));
   return true;
 }
 
+/**
+ * Enrolls a student by ID, adding them to the roster, if there is space
+ * available and they are not already enrolled. Unlike enrollStudent(), this
+ * changes the roster, so the caller must hold the department's write lock.
+ *
+ * @param studentId the student's ID
+ * @return true if the student is successfully enrolled, false otherwise.
+ */
+bool Course::enrollStudent(uint32_t studentId) {
+  if (roster.contains(studentId) || !enrollStudent()) return false;
+  roster.add(studentId);
+  return true;
+}
+
+/**
+ * Drops a student by ID, removing them from the roster. As for
+ * enrollStudent(uint32_t), the caller must hold the department's write
+ * lock.
+ *
+ * @param studentId the student's ID
+ * @return true if the student was enrolled and has been dropped.
+ */
+bool Course::dropStudent(uint32_t studentId) {
+  if (!roster.remove(studentId)) return false;
+  enrolledStudentCount.fetch_sub(1, std::memory_order_relaxed);
+  return true;
+}
+
+/**
+ * Checks whether a student is on the course's roster.
+ *
+ * @param studentId the student's ID
+ * @return true if the student is enrolled by ID.
+ */
+bool Course::isStudentEnrolled(uint32_t studentId) const {
+  return roster.contains(studentId);
+}
+
+/**
+ * Gets the students enrolled in the course by ID. The enrolled student
+ * count also includes students enrolled without an ID.
+ *
+ * @return the roster.
+ */
+const Roster& Course::getRoster() const { return roster; }
+
+/**
+ * Replaces the roster, as when the course is read from the data file. The
+ * enrolled student count is left as it is.
+ *
+ * @param roster the new roster.
+ */
+void Course::setRoster(Roster roster) { this->roster = std::move(roster); }
+
+/**
+ * Puts a student at the end of the course's waitlist. Like the roster, the
+ * waitlist only changes under the department's write lock.
+ *
+ * @param studentId the student's ID
+ * @return true if the student joined, false if already enrolled or waiting.
+ */
+bool Course::joinWaitlist(uint32_t studentId) {
+  return !roster.contains(studentId) && waitlist.join(studentId);
+}
+
+/**
+ * Takes a student off the course's waitlist.
+ *
+ * @param studentId the student's ID
+ * @return true if the student was waiting and has left.
+ */
+bool Course::leaveWaitlist(uint32_t studentId) {
+  return waitlist.leave(studentId);
+}
+
+/**
+ * Gets a student's place on the course's waitlist.
+ *
+ * @param studentId the student's ID
+ * @return the position, 1 for the next to be enrolled, or 0 if the student
+ * is not waiting.
+ */
+size_t Course::getWaitlistPosition(uint32_t studentId) const {
+  return waitlist.getPosition(studentId);
+}
+
+/**
+ * Enrolls the student who has waited longest, if there is a free seat.
+ *
+ * @param studentId set to the ID of the enrolled student
+ * @return true if a student was promoted, false if the waitlist is empty or
+ * the course is full.
+ */
+bool Course::promoteFromWaitlist(uint32_t* studentId) {
+  if (waitlist.empty() || !enrollStudent(waitlist.front())) return false;
+  *studentId = waitlist.front();
+  waitlist.popFront();
+  return true;
+}
+
+/**
+ * Gets the students waiting for a seat in the course.
+ *
+ * @return the waitlist.
+ */
+const Waitlist& Course::getWaitlist() const { return waitlist; }
+
+/**
+ * Replaces the waitlist, as when the course is read from the data file or a
+ * change is undone.
+ *
+ * @param waitlist the new waitlist.
+ */
+void Course::setWaitlist(Waitlist waitlist) {
+  this->waitlist = std::move(waitlist);
+}
+
 /**
  * Gets the course location.
  *
  * @return string representing the course location.
  */
-std::string Course::getCourseLocation() const { return courseLocation; }
+const std::string& Course::getCourseLocation() const {
+  return courseLocation.str();
+}
 
 /**
  * Gets the instructor's name.
  *
  * @return string representing the instructor's name.
  */
-std::string Course::getInstructorName() const { return instructorName; }
+const std::string& Course::getInstructorName() const {
+  return instructorName.str();
+}
 
 /**
  * Gets the time slot for the course.
  *
  * @return string representing the time slot of the course.
  */
-std::string Course::getCourseTimeSlot() const { return courseTimeSlot; }
+const std::string& Course::getCourseTimeSlot() const {
+  return courseTimeSlot.str();
+}
+
+/**
+ * Gets the parsed time slot for the course.
+ *
+ * @return the time slot, which is invalid if its text could not be parsed.
+ */
+const TimeSlot& Course::getTimeSlot() const { return courseTimeSlot; }
+
+/**
+ * Gets the number of students currently enrolled in the course.
+ *
+ * @return the enrolled student count.
+ */
+int Course::getEnrolledStudentCount() const {
+  return enrolledStudentCount.load(std::memory_order_relaxed);
+}
+
+/**
+ * Gets the maximum number of students that can enroll in the course.
+ *
+ * @return the enrollment capacity.
+ */
+int Course::getEnrollmentCapacity() const { return enrollmentCapacity; }
 
 /**
  * Displays the course information in a string format.
@@ -83,8 +269,22 @@ std::string Course::getCourseTimeSlot() const { return courseTimeSlot; }
  * time slot.
  */
 std::string Course::display() const {
-  return "\nInstructor: " + instructorName + "; Location: " + courseLocation +
-         "; Time: " + courseTimeSlot;
+  return "\nInstructor: " + instructorName.str() +
+         "; Location: " + courseLocation.str() +
+         "; Time: " + courseTimeSlot.str();
+}
+
+/**
+ * Writes the attributes shown by display() as members of the JSON object
+ * being written, e.g. "instructor":"Adam Cannon","location":"417 IAB",
+ * "time":"11:40-12:55".
+ *
+ * @param writer the writer, inside an object
+ */
+void Course::writeJsonFields(JsonWriter& writer) const {
+  writer.key("instructor").value(instructorName.str());
+  writer.key("location").value(courseLocation.str());
+  writer.key("time").value(courseTimeSlot.str());
 }
 
 /**
@@ -93,10 +293,10 @@ std::string Course::display() const {
  * @param newInstructorName The new instructor's name.
  */
 void Course::reassignInstructor(const std::string& newInstructorName) {
-  std::cout << "Old Instructor: " << instructorName << std::endl;
-  this->instructorName =
-      newInstructorName;  // Ensure the class member is being updated
-  std::cout << "New Instructor: " << this->instructorName << std::endl;
+  std::cout << "Old Instructor: " << instructorName.str() << std::endl;
+  this->instructorName = InternedString(
+      newInstructorName);  // Ensure the class member is being updated
+  std::cout << "New Instructor: " << this->instructorName.str() << std::endl;
 }
 
 /**
@@ -105,16 +305,21 @@ void Course::reassignInstructor(const std::string& newInstructorName) {
  * @param newLocation The new course location.
  */
 void Course::reassignLocation(const std::string& newLocation) {
-  courseLocation = newLocation;
+  courseLocation = InternedString(newLocation);
 }
 
 /**
- * Update value of the time of the course.
+ * Update value of the time of the course. The time is left unchanged if the
+ * new one is not a valid time slot.
  *
- * @param newTime The new time slot for the course.
+ * @param newTime The new time slot for the course, e.g. "11:40-12:55".
+ * @return true if the time slot was valid and has been updated.
  */
-void Course::reassignTime(const std::string& newTime) {
-  courseTimeSlot = newTime;
+bool Course::reassignTime(const std::string& newTime) {
+  TimeSlot slot(newTime);
+  if (!slot.isValid()) return false;
+  courseTimeSlot = slot;
+  return true;
 }
 
 /**
@@ -123,7 +328,7 @@ void Course::reassignTime(const std::string& newTime) {
  * @param count The number of enrolled students.
  */
 void Course::setEnrolledStudentCount(int count) {
-  enrolledStudentCount = count;
+  enrolledStudentCount.store(count, std::memory_order_relaxed);
 }
 
 /**
@@ -132,7 +337,7 @@ void Course::setEnrolledStudentCount(int count) {
  * @return true if the course is full, false otherwise.
  */
 bool Course::isCourseFull() const {
-  return enrolledStudentCount >= enrollmentCapacity;
+  return getEnrolledStudentCount() >= enrollmentCapacity;
 }
 
 /**
@@ -143,21 +348,22 @@ bool Course::isCourseFull() const {
 void Course::serialize(std::ostream& out) const {
   out.write(reinterpret_cast<const char*>(&enrollmentCapacity),
             sizeof(enrollmentCapacity));
-  out.write(reinterpret_cast<const char*>(&enrolledStudentCount),
-            sizeof(enrolledStudentCount));
+  int enrolledCount = getEnrolledStudentCount();
+  out.write(reinterpret_cast<const char*>(&enrolledCount),
+            sizeof(enrolledCount));
 
-  size_t locationLen = courseLocation.length();
+  size_t locationLen = courseLocation.str().length();
   out.write(reinterpret_cast<const char*>(&locationLen), sizeof(locationLen));
-  out.write(courseLocation.c_str(), locationLen);
+  out.write(courseLocation.str().c_str(), locationLen);
 
-  size_t instructorLen = instructorName.length();
+  size_t instructorLen = instructorName.str().length();
   out.write(reinterpret_cast<const char*>(&instructorLen),
             sizeof(instructorLen));
-  out.write(instructorName.c_str(), instructorLen);
+  out.write(instructorName.str().c_str(), instructorLen);
 
-  size_t timeSlotLen = courseTimeSlot.length();
+  size_t timeSlotLen = courseTimeSlot.str().length();
   out.write(reinterpret_cast<const char*>(&timeSlotLen), sizeof(timeSlotLen));
-  out.write(courseTimeSlot.c_str(), timeSlotLen);
+  out.write(courseTimeSlot.str().c_str(), timeSlotLen);
 }
 
 /**
@@ -168,21 +374,25 @@ void Course::serialize(std::ostream& out) const {
 void Course::deserialize(std::istream& in) {
   in.read(reinterpret_cast<char*>(&enrollmentCapacity),
           sizeof(enrollmentCapacity));
-  in.read(reinterpret_cast<char*>(&enrolledStudentCount),
-          sizeof(enrolledStudentCount));
+  int enrolledCount = 0;
+  in.read(reinterpret_cast<char*>(&enrolledCount), sizeof(enrolledCount));
+  setEnrolledStudentCount(enrolledCount);
 
   size_t locationLen;
   in.read(reinterpret_cast<char*>(&locationLen), sizeof(locationLen));
-  courseLocation.resize(locationLen);
-  in.read(&courseLocation[0], locationLen);
+  std::string location(locationLen, ' ');
+  in.read(&location[0], locationLen);
+  courseLocation = InternedString(location);
 
   size_t instructorLen;
   in.read(reinterpret_cast<char*>(&instructorLen), sizeof(instructorLen));
-  instructorName.resize(instructorLen);
-  in.read(&instructorName[0], instructorLen);
+  std::string instructor(instructorLen, ' ');
+  in.read(&instructor[0], instructorLen);
+  instructorName = InternedString(instructor);
 
   size_t timeSlotLen;
   in.read(reinterpret_cast<char*>(&timeSlotLen), sizeof(timeSlotLen));
-  courseTimeSlot.resize(timeSlotLen);
-  in.read(&courseTimeSlot[0], timeSlotLen);
+  std::string timeSlot(timeSlotLen, ' ');
+  in.read(&timeSlot[0], timeSlotLen);
+  courseTimeSlot = TimeSlot(timeSlot);
 }
@@ -0,0 +1,110 @@
+// Copyright 2024 Maria Surani
+#include "CourseIndex.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Constructs an empty index over one attribute of every course.
+ *
+ * @param attribute the getter of the attribute, e.g. &Course::getInstructorName
+ */
+CourseIndex::CourseIndex(Attribute attribute) : attribute(attribute) {}
+
+/**
+ * Replaces the contents of the index with the courses of every department.
+ * Departments and their courses are visited in sorted order, so every value's
+ * courses are appended already sorted.
+ *
+ * @param departments the department mapping
+ */
+void CourseIndex::rebuild(
+    const std::map<std::string, Department>& departments) {
+  std::unique_lock<std::shared_timed_mutex> lock(mutex);
+  values.clear();
+  for (const auto& it : departments) {
+    InternedString deptCode(it.first);
+    const auto& numbers = it.second.getCourseNumbers();
+    const auto& courses = it.second.getCourses();
+    for (size_t i = 0; i < courses.size(); ++i) {
+      const std::string& value = (courses[i].*attribute)();
+      if (!value.empty()) values[value].push_back({deptCode, numbers[i]});
+    }
+  }
+}
+
+/**
+ * Moves a course from its current value of the attribute to a new one. Must
+ * be called before the course itself is changed.
+ *
+ * @param deptCode     the course's department
+ * @param courseNumber the course's number
+ * @param course       the course, still holding its current value
+ * @param newValue     the value the course is about to get
+ */
+void CourseIndex::update(const std::string& deptCode, int courseNumber,
+                         const Course& course, const std::string& newValue) {
+  const std::string& oldValue = (course.*attribute)();
+  if (oldValue == newValue) return;
+  auto before = [courseNumber](const Entry& entry, const std::string& code) {
+    return comesBefore(entry, code, courseNumber);
+  };
+
+  std::unique_lock<std::shared_timed_mutex> lock(mutex);
+  auto old = values.find(oldValue);
+  if (old != values.end()) {
+    auto& entries = old->second;
+    auto it =
+        std::lower_bound(entries.begin(), entries.end(), deptCode, before);
+    if (it != entries.end() && it->deptCode.str() == deptCode &&
+        it->courseNumber == courseNumber) {
+      entries.erase(it);
+      if (entries.empty()) values.erase(old);
+    }
+  }
+  if (newValue.empty()) return;
+  auto& entries = values[newValue];
+  auto it = std::lower_bound(entries.begin(), entries.end(), deptCode, before);
+  entries.insert(it, {InternedString(deptCode), courseNumber});
+}
+
+/**
+ * Finds the courses with a value of the attribute.
+ *
+ * @param value the value, e.g. "Adam Cannon"
+ * @return the courses, sorted by department code and course number; empty
+ * if no course has the value
+ */
+std::vector<CourseIndex::Match> CourseIndex::findCourses(
+    const std::string& value) const {
+  std::shared_lock<std::shared_timed_mutex> lock(mutex);
+  std::vector<Match> result;
+  auto it = values.find(value);
+  if (it == values.end()) return result;
+  result.reserve(it->second.size());
+  for (const auto& entry : it->second) {
+    result.push_back({entry.deptCode.str(), entry.courseNumber});
+  }
+  return result;
+}
+
+/**
+ * Gets the number of distinct values held by at least one course.
+ *
+ * @return the number of values in the index
+ */
+size_t CourseIndex::getValueCount() const {
+  std::shared_lock<std::shared_timed_mutex> lock(mutex);
+  return values.size();
+}
+
+// Whether an entry sorts before a course, by department code and then
+// course number.
+bool CourseIndex::comesBefore(const Entry& entry, const std::string& deptCode,
+                              int courseNumber) {
+  int cmp = entry.deptCode.str().compare(deptCode);
+  return cmp < 0 || (cmp == 0 && entry.courseNumber < courseNumber);
+}
@@ -0,0 +1,54 @@
+// Copyright 2024 Maria Surani
+#include "Crc32.h"
+
+#include <array>
+
+namespace {
+
+using CrcTables = std::array<std::array<uint32_t, 256>, 8>;
+
+// Table k holds the CRC of a byte followed by k zero bytes, which lets the
+// main loop consume eight bytes per step ("slicing-by-8").
+CrcTables makeCrcTables() {
+  CrcTables tables{};
+  for (uint32_t i = 0; i < 256; ++i) {
+    uint32_t c = i;
+    for (int k = 0; k < 8; ++k) {
+      c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+    }
+    tables[0][i] = c;
+  }
+  for (uint32_t i = 0; i < 256; ++i) {
+    for (size_t k = 1; k < tables.size(); ++k) {
+      uint32_t previous = tables[k - 1][i];
+      tables[k][i] = tables[0][previous & 0xFF] ^ (previous >> 8);
+    }
+  }
+  return tables;
+}
+
+}  // namespace
+
+uint32_t crc32(const char* data, size_t size, uint32_t crc) {
+  static const CrcTables tables = makeCrcTables();
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+  crc ^= 0xFFFFFFFFu;
+  while (size >= 8) {
+    // Assembled byte by byte so the result does not depend on the host's
+    // byte order
+    uint32_t low = (bytes[0] | bytes[1] << 8 | bytes[2] << 16 |
+           static_cast<uint32_t>(bytes[3]) << 24) ^ crc;
+    uint32_t high = bytes[4] | bytes[5] << 8 | bytes[6] << 16 |
+           static_cast<uint32_t>(bytes[7]) << 24;
+    crc = tables[7][low & 0xFF] ^ tables[6][(low >> 8) & 0xFF] ^
+          tables[5][(low >> 16) & 0xFF] ^ tables[4][low >> 24] ^
+          tables[3][high & 0xFF] ^ tables[2][(high >> 8) & 0xFF] ^
+          tables[1][(high >> 16) & 0xFF] ^ tables[0][high >> 24];
+    bytes += 8;
+    size -= 8;
+  }
+  while (size-- > 0) {
+    crc = tables[0][(crc ^ *bytes++) & 0xFF] ^ (crc >> 8);
+  }
+  return crc ^ 0xFFFFFFFFu;
+}
@@ -1,10 +1,11 @@
 // Copyright 2024 Maria Surani
 #include "Department.h"
 
+#include <algorithm>
 #include <map>
-#include <memory>
 #include <sstream>
 #include <string>
+#include <utility>
 
 #include "Course.h"
 
@@ -12,18 +13,23 @@
  * Constructs a new Department object with the given parameters.
  *
  * @param deptCode         The code of the department.
- * @param courses          A HashMap containing courses offered by the
- * department.
+ * @param courses          The courses offered by the department, keyed by
+ * course number.
  * @param departmentChair  The name of the department chair.
  * @param numberOfMajors   The number of majors in the department.
  */
-Department::Department(std::string deptCode,
-                       std::map<std::string, std::shared_ptr<Course>> courses,
+Department::Department(std::string deptCode, std::map<int, Course> courses,
                        std::string departmentChair, int numberOfMajors)
-    : departmentChair(departmentChair),
-      deptCode(deptCode),
-      numberOfMajors(numberOfMajors),
-      courses(courses) {}
+    : departmentChair(std::move(departmentChair)),
+      deptCode(std::move(deptCode)),
+      numberOfMajors(numberOfMajors) {
+  courseNumbers.reserve(courses.size());
+  this->courses.reserve(courses.size());
+  for (const auto& it : courses) {
+    courseNumbers.push_back(it.first);
+    this->courses.push_back(it.second);
+  }
+}
 
 Department::Department() : numberOfMajors(0) {}
 
@@ -32,7 +38,9 @@ Department::Department() : numberOfMajors(0) {}
  *
  * @return The number of majors.
  */
-int Department::getNumberOfMajors() const { return numberOfMajors; }
+int Department::getNumberOfMajors() const {
+  return static_cast<int>(numberOfMajors.load());
+}
 
 /**
  * Gets the name of the department chair.
@@ -41,54 +49,124 @@ int Department::getNumberOfMajors() const { return numberOfMajors; }
  */
 std::string Department::getDepartmentChair() const { return departmentChair; }
 
+/**
+ * Gets the numbers of the courses offered by the department.
+ *
+ * @return A read-only reference to the course numbers in ascending order.
+ */
+const std::vector<int>& Department::getCourseNumbers() const {
+  return courseNumbers;
+}
+
 /**
  * Gets the courses offered by the department.
  *
- * @return A HashMap containing courses offered by the department.
+ * @return A read-only reference to the courses, in the same order as
+ * getCourseNumbers().
  */
-std::map<std::string, std::shared_ptr<Course>> Department::getCourseSelection()
-    const {
-  return courses;
+const std::vector<Course>& Department::getCourses() const { return courses; }
+
+/**
+ * Looks up a single course by number with a binary search over the sorted
+ * course numbers.
+ *
+ * @param courseNumber The number of the course to find.
+ * @return A pointer to the course owned by this department, or nullptr if the
+ * department does not offer it. The pointer stays valid until a course is
+ * added to the department.
+ */
+Course* Department::findCourse(int courseNumber) {
+  auto it = std::lower_bound(courseNumbers.begin(), courseNumbers.end(),
+                             courseNumber);
+  if (it == courseNumbers.end() || *it != courseNumber) return nullptr;
+  return &courses[it - courseNumbers.begin()];
+}
+
+const Course* Department::findCourse(int courseNumber) const {
+  return const_cast<Department*>(this)->findCourse(courseNumber);
 }
 
 /**
- * Increases the number of majors in the department by one.
+ * Looks up a single course by its code as written in requests and logs.
+ *
+ * @param courseId The ID of the course to find.
+ * @return A pointer to the course, or nullptr if the department does not
+ * offer it or the ID is not a course number.
  */
-void Department::addPersonToMajor() { numberOfMajors++; }
+Course* Department::findCourse(const std::string& courseId) {
+  int courseNumber;
+  if (!parseCourseNumber(courseId, &courseNumber)) return nullptr;
+  return findCourse(courseNumber);
+}
+
+const Course* Department::findCourse(const std::string& courseId) const {
+  return const_cast<Department*>(this)->findCourse(courseId);
+}
+
+/**
+ * Parses a course ID consisting only of decimal digits.
+ *
+ * @param courseId The ID to parse.
+ * @param number   Set to the course number on success.
+ * @return true if the ID is a valid course number.
+ */
+bool Department::parseCourseNumber(const std::string& courseId, int* number) {
+  if (courseId.empty() || courseId.size() > 9) return false;
+  int value = 0;
+  for (char c : courseId) {
+    if (c < '0' || c > '9') return false;
+    value = value * 10 + (c - '0');
+  }
+  *number = value;
+  return true;
+}
+
+/**
+ * Increases the number of majors in the department by one. Safe to call
+ * concurrently with itself and dropPersonFromMajor().
+ */
+void Department::addPersonToMajor() { numberOfMajors.add(1); }
 
 /**
  * Decreases the number of majors in the department by one if it's greater than
  * zero.
  */
-void Department::dropPersonFromMajor() { numberOfMajors--; }
+void Department::dropPersonFromMajor() { numberOfMajors.add(-1); }
 
 /**
- * Adds a new course to the department's course selection.
+ * Adds a new course to the department's course selection, replacing any
+ * course with the same number.
  *
- * @param courseId The ID of the course to add.
- * @param course   The Course object to add.
+ * @param courseNumber The number of the course to add.
+ * @param course       The Course object to add.
  */
-void Department::addCourse(std::string courseId,
-                           std::shared_ptr<Course> course) {
-  courses[courseId] = course;
+void Department::addCourse(int courseNumber, const Course& course) {
+  auto it = std::lower_bound(courseNumbers.begin(), courseNumbers.end(),
+                             courseNumber);
+  auto index = it - courseNumbers.begin();
+  if (it != courseNumbers.end() && *it == courseNumber) {
+    courses[index] = course;
+    return;
+  }
+  courseNumbers.insert(it, courseNumber);
+  courses.insert(courses.begin() + index, course);
 }
 
 /**
  * Creates and adds a new course to the department's course selection.
  *
- * @param courseId           The ID of the new course.
+ * @param courseNumber       The number of the new course.
  * @param instructorName     The name of the instructor teaching the course.
  * @param courseLocation     The location where the course is held.
  * @param courseTimeSlot     The time slot of the course.
  * @param capacity           The maximum number of students that can enroll in
  * the course.
  */
-void Department::createCourse(std::string courseId, std::string instructorName,
+void Department::createCourse(int courseNumber, std::string instructorName,
                               std::string courseLocation,
                               std::string courseTimeSlot, int capacity) {
-  std::shared_ptr<Course> newCourse = std::make_shared<Course>(
-      capacity, instructorName, courseLocation, courseTimeSlot);
-  addCourse(courseId, newCourse);
+  addCourse(courseNumber,
+            Course(capacity, instructorName, courseLocation, courseTimeSlot));
 }
 
 /**
@@ -99,13 +177,31 @@ void Department::createCourse(std::string courseId, std::string instructorName,
  */
 std::string Department::display() const {
   std::ostringstream result;
-  for (const auto& it : courses) {
-    result << deptCode << " " << it.first << ": " << it.second->display()
-           << "\n";
+  for (size_t i = 0; i < courses.size(); ++i) {
+    result << deptCode << " " << courseNumbers[i] << ": "
+           << courses[i].display() << "\n";
   }
   return result.str();
 }
 
+/**
+ * Writes the department as a JSON object with the same courses as
+ * display(), e.g. {"deptCode":"COMS","courses":[{"courseCode":1004,
+ * "instructor":"Adam Cannon","location":"417 IAB","time":"11:40-12:55"}]}.
+ *
+ * @param writer the writer to append the object to
+ */
+void Department::writeJson(JsonWriter& writer) const {
+  writer.beginObject().key("deptCode").value(deptCode);
+  writer.key("courses").beginArray();
+  for (size_t i = 0; i < courses.size(); ++i) {
+    writer.beginObject().key("courseCode").value(courseNumbers[i]);
+    courses[i].writeJsonFields(writer);
+    writer.endObject();
+  }
+  writer.endArray().endObject();
+}
+
 /**
  * Serializes the Department object to binary format.
  * Including the department code, department chair,
@@ -122,16 +218,17 @@ void Department::serialize(std::ostream& out) const {
   out.write(reinterpret_cast<const char*>(&chairLen), sizeof(chairLen));
   out.write(departmentChair.c_str(), chairLen);
 
-  out.write(reinterpret_cast<const char*>(&numberOfMajors),
-            sizeof(numberOfMajors));
+  int majors = getNumberOfMajors();
+  out.write(reinterpret_cast<const char*>(&majors), sizeof(majors));
 
   size_t mapSize = courses.size();
   out.write(reinterpret_cast<const char*>(&mapSize), sizeof(mapSize));
-  for (const auto& it : courses) {
-    size_t courseIdLen = it.first.length();
+  for (size_t i = 0; i < courses.size(); ++i) {
+    std::string courseId = std::to_string(courseNumbers[i]);
+    size_t courseIdLen = courseId.length();
     out.write(reinterpret_cast<const char*>(&courseIdLen), sizeof(courseIdLen));
-    out.write(it.first.c_str(), courseIdLen);
-    it.second->serialize(out);
+    out.write(courseId.c_str(), courseIdLen);
+    courses[i].serialize(out);
   }
 }
 
@@ -151,7 +248,9 @@ void Department::deserialize(std::istream& in) {
   departmentChair.resize(chairLen);
   in.read(&departmentChair[0], chairLen);
 
-  in.read(reinterpret_cast<char*>(&numberOfMajors), sizeof(numberOfMajors));
+  int majors = 0;
+  in.read(reinterpret_cast<char*>(&majors), sizeof(majors));
+  numberOfMajors.store(majors);
 
   size_t mapSize;
   in.read(reinterpret_cast<char*>(&mapSize), sizeof(mapSize));
@@ -160,8 +259,11 @@ void Department::deserialize(std::istream& in) {
     in.read(reinterpret_cast<char*>(&courseIdLen), sizeof(courseIdLen));
     std::string courseId(courseIdLen, ' ');
     in.read(&courseId[0], courseIdLen);
-    std::shared_ptr<Course> course = std::make_shared<Course>();
-    course->deserialize(in);
-    courses[courseId] = course;
+    Course course;
+    course.deserialize(in);
+    int courseNumber;
+    if (parseCourseNumber(courseId, &courseNumber)) {
+      addCourse(courseNumber, course);
+    }
   }
 }
@@ -0,0 +1,187 @@
+// Copyright 2024 Maria Surani
+#include "JsonWriter.h"
+
+#include <cstring>
+#include <string>
+
+/**
+ * Creates a writer that appends to a string.
+ *
+ * @param out the string to append to; it must outlive the writer
+ */
+JsonWriter::JsonWriter(std::string* out) : out(out), needsComma(false) {}
+
+/**
+ * Starts an object.
+ *
+ * @return this writer
+ */
+JsonWriter& JsonWriter::beginObject() {
+  separate();
+  out->push_back('{');
+  needsComma = false;
+  return *this;
+}
+
+/**
+ * Ends the innermost object.
+ *
+ * @return this writer
+ */
+JsonWriter& JsonWriter::endObject() {
+  out->push_back('}');
+  needsComma = true;
+  return *this;
+}
+
+/**
+ * Starts an array.
+ *
+ * @return this writer
+ */
+JsonWriter& JsonWriter::beginArray() {
+  separate();
+  out->push_back('[');
+  needsComma = false;
+  return *this;
+}
+
+/**
+ * Ends the innermost array.
+ *
+ * @return this writer
+ */
+JsonWriter& JsonWriter::endArray() {
+  out->push_back(']');
+  needsComma = true;
+  return *this;
+}
+
+/**
+ * Writes the key of the next object member.
+ *
+ * @param name the key
+ * @return this writer
+ */
+JsonWriter& JsonWriter::key(const char* name) {
+  separate();
+  writeString(name, std::strlen(name));
+  out->push_back(':');
+  needsComma = false;
+  return *this;
+}
+
+/**
+ * Writes a string value, escaping it as needed.
+ *
+ * @param text the value
+ * @return this writer
+ */
+JsonWriter& JsonWriter::value(const std::string& text) {
+  separate();
+  writeString(text.data(), text.size());
+  needsComma = true;
+  return *this;
+}
+
+/**
+ * Writes a string value, escaping it as needed.
+ *
+ * @param text the value
+ * @return this writer
+ */
+JsonWriter& JsonWriter::value(const char* text) {
+  separate();
+  writeString(text, std::strlen(text));
+  needsComma = true;
+  return *this;
+}
+
+/**
+ * Writes a number.
+ *
+ * @param number the value
+ * @return this writer
+ */
+JsonWriter& JsonWriter::value(int64_t number) {
+  separate();
+  // Digits are produced backwards into a buffer wide enough for any int64_t
+  char digits[20];
+  char* end = digits + sizeof(digits);
+  char* start = end;
+  uint64_t magnitude = number < 0 ? 0 - static_cast<uint64_t>(number)
+                                  : static_cast<uint64_t>(number);
+  do {
+    *--start = static_cast<char>('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude != 0);
+  if (number < 0) out->push_back('-');
+  out->append(start, end);
+  needsComma = true;
+  return *this;
+}
+
+/**
+ * Writes a number.
+ *
+ * @param number the value
+ * @return this writer
+ */
+JsonWriter& JsonWriter::value(int number) {
+  return value(static_cast<int64_t>(number));
+}
+
+/**
+ * Writes true or false.
+ *
+ * @param flag the value
+ * @return this writer
+ */
+JsonWriter& JsonWriter::value(bool flag) {
+  separate();
+  out->append(flag ? "true" : "false");
+  needsComma = true;
+  return *this;
+}
+
+// Adds the comma that goes before every member or element but the first.
+void JsonWriter::separate() {
+  if (needsComma) out->push_back(',');
+}
+
+// Writes a quoted string, copying runs of characters that need no escaping
+// in one go.
+void JsonWriter::writeString(const char* text, size_t length) {
+  static const char kHex[] = "0123456789abcdef";
+  out->push_back('"');
+  size_t run = 0;
+  for (size_t i = 0; i < length; ++i) {
+    unsigned char c = static_cast<unsigned char>(text[i]);
+    if (c >= 0x20 && c != '"' && c != '\\') continue;
+    out->append(text + run, i - run);
+    run = i + 1;
+    switch (c) {
+      case '"':
+        out->append("\\\"");
+        break;
+      case '\\':
+        out->append("\\\\");
+        break;
+      case '\n':
+        out->append("\\n");
+        break;
+      case '\t':
+        out->append("\\t");
+        break;
+      case '\r':
+        out->append("\\r");
+        break;
+      default:
+        out->append("\\u00");
+        out->push_back(kHex[c >> 4]);
+        out->push_back(kHex[c & 0xf]);
+    }
+  }
+  out->append(text + run, length - run);
+  out->push_back('"');
+}
@@ -0,0 +1,591 @@
+// Copyright 2024 Maria Surani
+#include "MappedDataFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+#include "Crc32.h"
+#include "Roster.h"
+#include "Waitlist.h"
+
+namespace {
+
+const char kMagic[8] = {'4', '1', '5', '6', 'M', 'F', 'D', 'B'};
+
+// Written in the machine's byte order; reads back reversed on a machine with
+// the other one.
+const uint32_t kByteOrderMark = 0x01020304u;
+
+// All integers are fixed width and all offsets inside a department block are
+// relative to the start of that block, so a block can be copied between
+// files unchanged.
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byteOrderMark;
+  uint64_t checkpointLsn;
+  uint32_t departmentCount;
+  uint32_t checksum;  // CRC-32 of the fields above and the directory
+};
+
+struct DirectoryEntry {
+  uint64_t offset;
+  uint32_t size;
+  uint32_t checksum;  // CRC-32 of the block
+};
+
+struct StringRef {
+  uint32_t offset;
+  uint32_t length;
+};
+
+struct DepartmentRecord {
+  StringRef code;
+  StringRef chair;
+  int32_t numberOfMajors;
+  uint32_t courseCount;
+};
+
+struct CourseRecord {
+  StringRef id;
+  StringRef instructor;
+  StringRef location;
+  StringRef timeSlot;
+  int32_t capacity;
+  int32_t enrolled;
+  StringRef roster;    // Roster::encode() bytes; not in version 2
+  StringRef waitlist;  // Waitlist::encode() bytes; not before version 4
+};
+
+static_assert(sizeof(FileHeader) == 32, "FileHeader must not be padded");
+static_assert(sizeof(DirectoryEntry) == 16, "DirectoryEntry is padded");
+static_assert(sizeof(DepartmentRecord) == 24, "DepartmentRecord is padded");
+static_assert(sizeof(CourseRecord) == 56, "CourseRecord must not be padded");
+
+const size_t kChecksumOffset = offsetof(FileHeader, checksum);
+
+const uint32_t kFirstVersion = 2;
+
+// Course records gained the roster in version 3 and the waitlist in 4;
+// older ones end before them.
+size_t courseRecordSizeOf(uint32_t version) {
+  switch (version) {
+    case 2:
+      return offsetof(CourseRecord, roster);
+    case 3:
+      return offsetof(CourseRecord, waitlist);
+    default:
+      return sizeof(CourseRecord);
+  }
+}
+
+std::runtime_error dataFileError(const std::string& path,
+                                 const std::string& what) {
+  return std::runtime_error("Data file " + path + ": " + what);
+}
+
+// Blocks may start at any offset of the mapping, so records are copied out
+// instead of being accessed in place.
+template <typename T>
+T readRecord(const char* at) {
+  T record;
+  std::memcpy(&record, at, sizeof(record));
+  return record;
+}
+
+template <typename T>
+void appendRecord(std::string& out, const T& record) {
+  out.append(reinterpret_cast<const char*>(&record), sizeof(record));
+}
+
+// The string data of one department block. Each distinct value is written
+// once, so courses sharing an instructor, room or time slot share its bytes.
+class BlockStrings {
+ public:
+  explicit BlockStrings(size_t start) : start(start) {}
+
+  StringRef add(const std::string& value) {
+    auto it = refs.find(value);
+    if (it != refs.end()) return it->second;
+    StringRef ref{static_cast<uint32_t>(start + bytes.size()),
+                  static_cast<uint32_t>(value.size())};
+    bytes.append(value);
+    refs.emplace(value, ref);
+    return ref;
+  }
+
+  const std::string& getBytes() const { return bytes; }
+
+ private:
+  size_t start;
+  std::string bytes;
+  std::unordered_map<std::string, StringRef> refs;
+};
+
+bool fitsIn(const StringRef& ref, size_t size) {
+  return ref.offset <= size && ref.length <= size - ref.offset;
+}
+
+std::string getString(const char* block, size_t size, const StringRef& ref,
+                      const std::string& path) {
+  if (!fitsIn(ref, size)) throw dataFileError(path, "string out of bounds");
+  return std::string(block + ref.offset, ref.length);
+}
+
+DepartmentRecord getDepartmentRecord(const char* block, size_t size,
+                                     size_t courseRecordSize,
+                                     const std::string& path) {
+  if (size < sizeof(DepartmentRecord)) {
+    throw dataFileError(path, "department block too small");
+  }
+  DepartmentRecord record = readRecord<DepartmentRecord>(block);
+  if ((size - sizeof(DepartmentRecord)) / courseRecordSize <
+      record.courseCount) {
+    throw dataFileError(path, "course table out of bounds");
+  }
+  return record;
+}
+
+// Reads a course record of any version; fields it predates are empty.
+CourseRecord getCourseRecord(const char* block, size_t index,
+                             size_t courseRecordSize) {
+  CourseRecord record{};
+  std::memcpy(&record,
+              block + sizeof(DepartmentRecord) + index * courseRecordSize,
+              courseRecordSize);
+  return record;
+}
+
+int getCourseNumber(const char* block, size_t size, const CourseRecord& record,
+                    const std::string& path) {
+  int courseNumber;
+  if (!Department::parseCourseNumber(getString(block, size, record.id, path),
+                                     &courseNumber)) {
+    throw dataFileError(path, "invalid course number");
+  }
+  return courseNumber;
+}
+
+Course makeCourse(const char* block, size_t size, const CourseRecord& record,
+                  const std::string& path) {
+  Course course(record.capacity,
+                getString(block, size, record.instructor, path),
+                getString(block, size, record.location, path),
+                getString(block, size, record.timeSlot, path));
+  if (record.roster.length > 0) {
+    if (!fitsIn(record.roster, size)) {
+      throw dataFileError(path, "string out of bounds");
+    }
+    Roster roster;
+    if (!Roster::decode(block + record.roster.offset, record.roster.length,
+                        &roster) ||
+        roster.size() > static_cast<size_t>(std::max(record.enrolled, 0))) {
+      throw dataFileError(path, "invalid roster");
+    }
+    course.setRoster(std::move(roster));
+  }
+  if (record.waitlist.length > 0) {
+    if (!fitsIn(record.waitlist, size)) {
+      throw dataFileError(path, "string out of bounds");
+    }
+    Waitlist waitlist;
+    if (!Waitlist::decode(block + record.waitlist.offset,
+                          record.waitlist.length, &waitlist)) {
+      throw dataFileError(path, "invalid waitlist");
+    }
+    course.setWaitlist(std::move(waitlist));
+  }
+  course.setEnrolledStudentCount(record.enrolled);
+  return course;
+}
+
+Department decodeBlock(const char* block, size_t size,
+                       size_t courseRecordSize, const std::string& path,
+                       std::string* deptCode) {
+  DepartmentRecord deptRecord =
+      getDepartmentRecord(block, size, courseRecordSize, path);
+  std::string code = getString(block, size, deptRecord.code, path);
+  if (deptCode != nullptr) *deptCode = code;
+  Department department(std::move(code), {},
+                        getString(block, size, deptRecord.chair, path),
+                        deptRecord.numberOfMajors);
+  for (uint32_t i = 0; i < deptRecord.courseCount; ++i) {
+    CourseRecord record = getCourseRecord(block, i, courseRecordSize);
+    department.addCourse(getCourseNumber(block, size, record, path),
+                         makeCourse(block, size, record, path));
+  }
+  return department;
+}
+
+}  // namespace
+
+const uint32_t MappedDataFile::kVersion;
+
+/**
+ * Maps a data file of version 2 or later into memory and validates its
+ * header and directory. Department blocks are checked when they are first read.
+ *
+ * @param path the path of the data file
+ * @throws std::runtime_error if the file cannot be mapped or is not a valid
+ * data file in either version
+ */
+MappedDataFile::MappedDataFile(const std::string& path)
+    : path(path),
+      data(nullptr),
+      fileSize(0),
+      checkpointLsn(0),
+      departmentCount(0),
+      courseRecordSize(sizeof(CourseRecord)) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) throw dataFileError(path, std::strerror(errno));
+  struct stat fileStat;
+  if (::fstat(fd, &fileStat) != 0) {
+    ::close(fd);
+    throw dataFileError(path, std::strerror(errno));
+  }
+  fileSize = static_cast<size_t>(fileStat.st_size);
+  if (fileSize < sizeof(FileHeader)) {
+    ::close(fd);
+    throw dataFileError(path, "too small for a header");
+  }
+  void* mapping = ::mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED) throw dataFileError(path, std::strerror(errno));
+  data = static_cast<const char*>(mapping);
+
+  try {
+    FileHeader header = readRecord<FileHeader>(data);
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+      throw dataFileError(path, "not a mapped data file");
+    }
+    if (header.byteOrderMark != kByteOrderMark) {
+      throw dataFileError(path, "written with a different byte order");
+    }
+    if (header.version < kFirstVersion || header.version > kVersion) {
+      throw dataFileError(path, "unsupported version " +
+                                    std::to_string(header.version));
+    }
+    courseRecordSize = courseRecordSizeOf(header.version);
+    if ((fileSize - sizeof(FileHeader)) / sizeof(DirectoryEntry) <
+        header.departmentCount) {
+      throw dataFileError(path, "directory out of bounds");
+    }
+    size_t directorySize = header.departmentCount * sizeof(DirectoryEntry);
+    uint32_t checksum = crc32(data, kChecksumOffset);
+    checksum = crc32(data + sizeof(FileHeader), directorySize, checksum);
+    if (checksum != header.checksum) {
+      throw dataFileError(path, "header checksum mismatch");
+    }
+    checkpointLsn = header.checkpointLsn;
+    departmentCount = header.departmentCount;
+  } catch (...) {
+    ::munmap(const_cast<char*>(data), fileSize);
+    throw;
+  }
+}
+
+MappedDataFile::~MappedDataFile() {
+  ::munmap(const_cast<char*>(data), fileSize);
+}
+
+/**
+ * Checks whether a file starts with the mapped format's magic bytes. Files in
+ * the original format start with the department count instead.
+ *
+ * @param path the path of the data file
+ * @return true if the file should be opened with MappedDataFile
+ */
+bool MappedDataFile::isMappedFormat(const std::string& path) {
+  std::ifstream inFile(path, std::ios::binary);
+  char magic[sizeof(kMagic)];
+  if (!inFile.read(magic, sizeof(magic))) return false;
+  return std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+/**
+ * Encodes a department and its courses as a self-contained block.
+ *
+ * @param deptCode   the code the department is stored under
+ * @param department the department to encode
+ * @return the block, padded to a multiple of 8 bytes
+ */
+std::string MappedDataFile::encodeDepartment(const std::string& deptCode,
+                                             const Department& department) {
+  const auto& courseNumbers = department.getCourseNumbers();
+  const auto& courses = department.getCourses();
+  BlockStrings strings(sizeof(DepartmentRecord) +
+                       courses.size() * sizeof(CourseRecord));
+
+  DepartmentRecord deptRecord;
+  deptRecord.code = strings.add(deptCode);
+  deptRecord.chair = strings.add(department.getDepartmentChair());
+  deptRecord.numberOfMajors = department.getNumberOfMajors();
+  deptRecord.courseCount = static_cast<uint32_t>(courses.size());
+
+  std::string block;
+  appendRecord(block, deptRecord);
+  for (size_t i = 0; i < courses.size(); ++i) {
+    const Course& course = courses[i];
+    CourseRecord record;
+    record.id = strings.add(std::to_string(courseNumbers[i]));
+    record.instructor = strings.add(course.getInstructorName());
+    record.location = strings.add(course.getCourseLocation());
+    record.timeSlot = strings.add(course.getCourseTimeSlot());
+    record.capacity = course.getEnrollmentCapacity();
+    record.enrolled = course.getEnrolledStudentCount();
+    record.roster = strings.add(course.getRoster().encode());
+    record.waitlist = strings.add(course.getWaitlist().encode());
+    appendRecord(block, record);
+  }
+  block.append(strings.getBytes());
+  block.append((8 - block.size() % 8) % 8, '\0');
+  return block;
+}
+
+/**
+ * Decodes a block made by encodeDepartment(), e.g. one copied out of the
+ * database to be read without holding its locks.
+ *
+ * @param block    the block
+ * @param deptCode set to the code the department is stored under, if not
+ *                 null
+ * @return the decoded department
+ */
+Department MappedDataFile::decodeDepartment(const std::string& block,
+                                            std::string* deptCode) {
+  return decodeBlock(block.data(), block.size(), sizeof(CourseRecord),
+                     "in memory", deptCode);
+}
+
+/**
+ * Encodes the header and directory for a file made of the given blocks,
+ * which must be written right after it in the same order.
+ *
+ * @param blocks        department blocks sorted by department code
+ * @param checkpointLsn the LSN of the last mutation contained in the blocks
+ * @return the header followed by the directory
+ */
+std::string MappedDataFile::encodeIndex(
+    const std::vector<const std::string*>& blocks, uint64_t checkpointLsn) {
+  FileHeader header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.byteOrderMark = kByteOrderMark;
+  header.checkpointLsn = checkpointLsn;
+  header.departmentCount = static_cast<uint32_t>(blocks.size());
+  header.checksum = 0;
+
+  std::string directory;
+  uint64_t offset =
+      sizeof(FileHeader) + blocks.size() * sizeof(DirectoryEntry);
+  for (const std::string* block : blocks) {
+    DirectoryEntry entry{offset, static_cast<uint32_t>(block->size()),
+                         crc32(block->data(), block->size())};
+    appendRecord(directory, entry);
+    offset += block->size();
+  }
+
+  std::string index;
+  appendRecord(index, header);
+  uint32_t checksum = crc32(index.data(), kChecksumOffset);
+  header.checksum = crc32(directory.data(), directory.size(), checksum);
+  index.replace(kChecksumOffset, sizeof(header.checksum),
+                reinterpret_cast<const char*>(&header.checksum),
+                sizeof(header.checksum));
+  return index + directory;
+}
+
+/**
+ * Gets the LSN of the last write-ahead log record contained in the file.
+ *
+ * @return the checkpoint LSN
+ */
+uint64_t MappedDataFile::getCheckpointLsn() const { return checkpointLsn; }
+
+/**
+ * Gets the number of departments in the file.
+ *
+ * @return the department count
+ */
+size_t MappedDataFile::getDepartmentCount() const { return departmentCount; }
+
+/**
+ * Gets the code of a department without verifying its whole block.
+ *
+ * @param index the position of the department in code order
+ * @return the department code
+ */
+std::string MappedDataFile::getDepartmentCode(size_t index) const {
+  size_t size;
+  const char* block = blockAt(index, &size);
+  DepartmentRecord record =
+      getDepartmentRecord(block, size, courseRecordSize, path);
+  return getString(block, size, record.code, path);
+}
+
+/**
+ * Reads a department and all of its courses.
+ *
+ * @param index the position of the department in code order
+ * @return the decoded department
+ */
+Department MappedDataFile::readDepartment(size_t index) const {
+  return decodeDepartment(index, nullptr);
+}
+
+/**
+ * Reads a department by code, using a binary search over the directory.
+ *
+ * @param deptCode the code of the department
+ * @param out      set to the decoded department if it exists
+ * @return true if the department exists
+ */
+bool MappedDataFile::readDepartment(const std::string& deptCode,
+                                    Department& out) const {
+  size_t index;
+  if (!findDepartmentIndex(deptCode, &index)) return false;
+  out = readDepartment(index);
+  return true;
+}
+
+/**
+ * Reads a single course, decoding only its own record and strings.
+ *
+ * @param deptCode     the code of the department offering the course
+ * @param courseNumber the number of the course
+ * @param out          set to the decoded course if it exists
+ * @return true if the course exists
+ */
+bool MappedDataFile::readCourse(const std::string& deptCode, int courseNumber,
+                                Course& out) const {
+  size_t index;
+  if (!findDepartmentIndex(deptCode, &index)) return false;
+  size_t size;
+  const char* block = verifiedBlockAt(index, &size);
+  DepartmentRecord deptRecord =
+      getDepartmentRecord(block, size, courseRecordSize, path);
+
+  // Course records are sorted by number
+  size_t low = 0;
+  size_t high = deptRecord.courseCount;
+  while (low < high) {
+    size_t mid = low + (high - low) / 2;
+    CourseRecord record = getCourseRecord(block, mid, courseRecordSize);
+    int midNumber = getCourseNumber(block, size, record, path);
+    if (midNumber == courseNumber) {
+      out = makeCourse(block, size, record, path);
+      return true;
+    }
+    if (courseNumber < midNumber) {
+      high = mid;
+    } else {
+      low = mid + 1;
+    }
+  }
+  return false;
+}
+
+/**
+ * Reads every department in the file.
+ *
+ * @return the department mapping stored in the file
+ */
+std::map<std::string, Department> MappedDataFile::readAll() const {
+  std::map<std::string, Department> mapping;
+  for (size_t i = 0; i < departmentCount; ++i) {
+    std::string deptCode;
+    Department department = decodeDepartment(i, &deptCode);
+    mapping.emplace_hint(mapping.end(), std::move(deptCode),
+                         std::move(department));
+  }
+  return mapping;
+}
+
+/**
+ * Decodes a department block after checking its CRC-32.
+ *
+ * @param index    the position of the department in code order
+ * @param deptCode set to the department code, if not null
+ * @return the decoded department
+ */
+Department MappedDataFile::decodeDepartment(size_t index,
+                                            std::string* deptCode) const {
+  size_t size;
+  const char* block = verifiedBlockAt(index, &size);
+  return decodeBlock(block, size, courseRecordSize, path, deptCode);
+}
+
+/**
+ * Locates a department block from its directory entry.
+ *
+ * @param index the position of the department in code order
+ * @param size  set to the size of the block
+ * @return a pointer to the start of the block inside the mapping
+ */
+const char* MappedDataFile::blockAt(size_t index, size_t* size) const {
+  if (index >= departmentCount) {
+    throw std::out_of_range("Department index out of range");
+  }
+  DirectoryEntry entry = readRecord<DirectoryEntry>(
+      data + sizeof(FileHeader) + index * sizeof(DirectoryEntry));
+  if (entry.offset > fileSize || entry.size > fileSize - entry.offset) {
+    throw dataFileError(path, "department block out of bounds");
+  }
+  *size = entry.size;
+  return data + entry.offset;
+}
+
+/**
+ * Like blockAt(), but also checks the CRC-32 of the block.
+ *
+ * @param index the position of the department in code order
+ * @param size  set to the size of the block
+ * @return a pointer to the start of the block inside the mapping
+ */
+const char* MappedDataFile::verifiedBlockAt(size_t index, size_t* size) const {
+  const char* block = blockAt(index, size);
+  DirectoryEntry entry = readRecord<DirectoryEntry>(
+      data + sizeof(FileHeader) + index * sizeof(DirectoryEntry));
+  if (crc32(block, *size) != entry.checksum) {
+    throw dataFileError(path, "department block checksum mismatch");
+  }
+  return block;
+}
+
+/**
+ * Binary searches the directory for a department code.
+ *
+ * @param deptCode the code to find
+ * @param index    set to the position of the department if found
+ * @return true if the department exists
+ */
+bool MappedDataFile::findDepartmentIndex(const std::string& deptCode,
+                                         size_t* index) const {
+  size_t low = 0;
+  size_t high = departmentCount;
+  while (low < high) {
+    size_t mid = low + (high - low) / 2;
+    int cmp = deptCode.compare(getDepartmentCode(mid));
+    if (cmp == 0) {
+      *index = mid;
+      return true;
+    }
+    if (cmp < 0) {
+      high = mid;
+    } else {
+      low = mid + 1;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,234 @@
+// Copyright 2024 Maria Surani
+#include "Metrics.h"
+
+#include <cstdio>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Distinguishes Metrics objects in the per-thread shard caches, so a new
+// object allocated where an old one was never sees its shards
+std::atomic<uint64_t> nextMetricsId(1);
+
+// Counters kept for each route: the latency buckets, the status codes and
+// the total latency in nanoseconds
+const int kStatusOffset = Metrics::kBucketCount;
+const int kLatencySumSlot = Metrics::kBucketCount + Metrics::kStatusCount;
+const int kSlotsPerRoute = kLatencySumSlot + 1;
+
+// Formats a number of seconds without trailing zeros, e.g. "0.00025".
+std::string seconds(double value) {
+  char text[32];
+  std::snprintf(text, sizeof(text), "%.9f", value);
+  std::string result = text;
+  result.erase(result.find_last_not_of('0') + 1);
+  if (result.back() == '.') result.pop_back();
+  return result;
+}
+
+}  // namespace
+
+const int64_t Metrics::kBucketBounds[kBucketCount - 1] = {
+    50,    100,   250,    500,    1000,   2500,   5000,
+    10000, 25000, 50000, 100000, 250000, 500000, 1000000};
+const int Metrics::kStatusCodes[kStatusCount - 1] = {200, 304, 400, 404,
+                                                     409, 413, 500};
+const int Metrics::kMaxRoutes;
+const int Metrics::kBucketCount;
+const int Metrics::kStatusCount;
+
+// One thread's counters. Only its own thread writes them, with plain loads
+// and stores, and scrapes read them. The padding keeps two threads' shards
+// off the same cache line.
+struct Metrics::Shard {
+  Shard() {
+    for (auto& route : counters) {
+      for (auto& counter : route) counter.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  void add(int route, int slot, uint64_t value) {
+    std::atomic<uint64_t>& counter = counters[route][slot];
+    counter.store(counter.load(std::memory_order_relaxed) + value,
+                  std::memory_order_relaxed);
+  }
+
+  char leading[64];
+  std::atomic<uint64_t> counters[kMaxRoutes][kSlotsPerRoute];
+  char trailing[64];
+};
+
+Metrics::Metrics() : id(nextMetricsId++) {}
+
+Metrics::~Metrics() = default;
+
+/**
+ * Adds a route to report on. Adding a route twice returns the same id.
+ *
+ * @param name the route, e.g. "/retrieveCourse"
+ * @return the id to record the route's requests under
+ */
+int Metrics::addRoute(const std::string& name) {
+  for (size_t i = 0; i < routes.size(); ++i) {
+    if (routes[i] == name) return static_cast<int>(i);
+  }
+  if (routes.size() == static_cast<size_t>(kMaxRoutes)) {
+    throw std::length_error("Metrics supports at most " +
+                            std::to_string(kMaxRoutes) + " routes");
+  }
+  routes.push_back(name);
+  return static_cast<int>(routes.size() - 1);
+}
+
+/**
+ * Records one request.
+ *
+ * @param route   the id returned by addRoute()
+ * @param status  the HTTP status code of the response
+ * @param latency the time taken to handle the request
+ */
+void Metrics::record(int route, int status, std::chrono::nanoseconds latency) {
+  int64_t micros = latency.count() / 1000;
+  int bucket = 0;
+  while (bucket < kBucketCount - 1 && micros > kBucketBounds[bucket]) {
+    ++bucket;
+  }
+  Shard* shard = localShard();
+  shard->add(route, bucket, 1);
+  shard->add(route, kStatusOffset + statusSlot(status), 1);
+  shard->add(route, kLatencySumSlot, static_cast<uint64_t>(latency.count()));
+}
+
+/**
+ * Gets the number of requests recorded for a route.
+ *
+ * @param route the route's id
+ * @return the number of requests
+ */
+uint64_t Metrics::getRequestCount(int route) const {
+  uint64_t count = 0;
+  for (int slot = 0; slot < kBucketCount; ++slot) count += sum(route, slot);
+  return count;
+}
+
+/**
+ * Gets the number of responses with a status code recorded for a route.
+ *
+ * @param route  the route's id
+ * @param status the status code; any code not counted separately gives the
+ *               number of responses with such codes
+ * @return the number of responses
+ */
+uint64_t Metrics::getStatusCount(int route, int status) const {
+  return sum(route, kStatusOffset + statusSlot(status));
+}
+
+/**
+ * Gets the number of requests of a route that fell in one latency bucket.
+ *
+ * @param route  the route's id
+ * @param bucket the bucket's index; bucket i holds latencies up to
+ *               kBucketBounds[i] that do not fit an earlier bucket
+ * @return the number of requests, not including earlier buckets
+ */
+uint64_t Metrics::getBucketCount(int route, int bucket) const {
+  return sum(route, bucket);
+}
+
+/**
+ * Renders the counters in the Prometheus text exposition format, as
+ * http_requests_total by route and status code and
+ * http_request_duration_seconds histograms by route.
+ *
+ * @return the metrics text
+ */
+std::string Metrics::render() const {
+  std::vector<uint64_t> totals(routes.size() * kSlotsPerRoute, 0);
+  {
+    std::lock_guard<std::mutex> guard(shardsMutex);
+    for (const auto& shard : shards) {
+      for (size_t route = 0; route < routes.size(); ++route) {
+        for (int slot = 0; slot < kSlotsPerRoute; ++slot) {
+          totals[route * kSlotsPerRoute + slot] +=
+              shard->counters[route][slot].load(std::memory_order_relaxed);
+        }
+      }
+    }
+  }
+
+  std::string out =
+      "# HELP http_requests_total Requests handled, by route and status "
+      "code.\n"
+      "# TYPE http_requests_total counter\n";
+  for (size_t route = 0; route < routes.size(); ++route) {
+    const uint64_t* counts = &totals[route * kSlotsPerRoute];
+    for (int i = 0; i < kStatusCount; ++i) {
+      uint64_t count = counts[kStatusOffset + i];
+      if (count == 0) continue;
+      std::string code =
+          i < kStatusCount - 1 ? std::to_string(kStatusCodes[i]) : "other";
+      out += "http_requests_total{route=\"" + routes[route] + "\",code=\"" +
+             code + "\"} " + std::to_string(count) + "\n";
+    }
+  }
+
+  out +=
+      "# HELP http_request_duration_seconds Time taken to handle a request, "
+      "by route.\n"
+      "# TYPE http_request_duration_seconds histogram\n";
+  for (size_t route = 0; route < routes.size(); ++route) {
+    const uint64_t* counts = &totals[route * kSlotsPerRoute];
+    const std::string label = "{route=\"" + routes[route] + "\",le=\"";
+    uint64_t cumulative = 0;
+    for (int bucket = 0; bucket < kBucketCount; ++bucket) {
+      cumulative += counts[bucket];
+      std::string bound = bucket < kBucketCount - 1
+                              ? seconds(kBucketBounds[bucket] / 1e6)
+                              : "+Inf";
+      out += "http_request_duration_seconds_bucket" + label + bound + "\"} " +
+             std::to_string(cumulative) + "\n";
+    }
+    out += "http_request_duration_seconds_sum{route=\"" + routes[route] +
+           "\"} " + seconds(counts[kLatencySumSlot] / 1e9) + "\n";
+    out += "http_request_duration_seconds_count{route=\"" + routes[route] +
+           "\"} " + std::to_string(cumulative) + "\n";
+  }
+  return out;
+}
+
+int Metrics::statusSlot(int status) {
+  for (int i = 0; i < kStatusCount - 1; ++i) {
+    if (kStatusCodes[i] == status) return i;
+  }
+  return kStatusCount - 1;
+}
+
+// Finds the calling thread's shard, creating it on the thread's first
+// request. Later calls only search a small thread-local cache.
+Metrics::Shard* Metrics::localShard() {
+  thread_local std::vector<std::pair<uint64_t, Shard*>> cache;
+  for (const auto& entry : cache) {
+    if (entry.first == id) return entry.second;
+  }
+  std::unique_ptr<Shard> shard(new Shard());
+  Shard* result = shard.get();
+  {
+    std::lock_guard<std::mutex> guard(shardsMutex);
+    shards.push_back(std::move(shard));
+  }
+  cache.emplace_back(id, result);
+  return result;
+}
+
+uint64_t Metrics::sum(int route, int slot) const {
+  std::lock_guard<std::mutex> guard(shardsMutex);
+  uint64_t total = 0;
+  for (const auto& shard : shards) {
+    total += shard->counters[route][slot].load(std::memory_order_relaxed);
+  }
+  return total;
+}
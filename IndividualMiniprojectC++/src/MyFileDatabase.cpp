@@ -1,68 +1,852 @@
 // Copyright 2024 Maria Surani
 #include "MyFileDatabase.h"
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <new>
+#include <ostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "MappedDataFile.h"
+
+namespace {
+
+std::runtime_error checkpointError(const std::string& what) {
+  return std::runtime_error("Checkpoint: " + what + ": " +
+                            std::strerror(errno));
+}
+
+void writeFully(int fd, const char* data, size_t size) {
+  while (size > 0) {
+    ssize_t n = ::write(fd, data, size);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      throw checkpointError("write failed");
+    }
+    data += n;
+    size -= static_cast<size_t>(n);
+  }
+}
+
+// Makes a rename inside the directory of path durable.
+void syncParentDirectory(const std::string& path) {
+  size_t slash = path.find_last_of('/');
+  std::string dir = slash == std::string::npos ? "." : path.substr(0, slash);
+  int dirFd = ::open(dir.empty() ? "/" : dir.c_str(), O_RDONLY);
+  if (dirFd < 0) return;
+  ::fsync(dirFd);
+  ::close(dirFd);
+}
+
+}  // namespace
 
 /**
  * Constructs a MyFileDatabase object and loads up the data structure with
- * the contents of the file.
+ * the contents of the file. Mutations logged after the file was last saved
+ * are then replayed from the write-ahead log next to it, so changes survive
+ * a crash. A database with an empty file path is kept in memory only.
  *
  * @param flag     used to distinguish mode of database
  * @param filePath the path to the file containing the entries of the database
  */
 MyFileDatabase::MyFileDatabase(int flag, const std::string& filePath)
-    : filePath(filePath) {
+    : filePath(filePath),
+      checkpointLsn(0),
+      instructorIndex(&Course::getInstructorName),
+      fullCheckpointNeeded(true),
+      checkpointCount(0),
+      lastCheckpointMicros(0),
+      stopCheckpointRequested(false) {
   if (flag == 0) {
     deSerializeObjectFromFile();
   }
+  if (filePath.empty()) return;
+
+  writeAheadLog.reset(new WriteAheadLog(filePath + ".wal"));
+  if (flag == 0) {
+    writeAheadLog->advanceLastLsn(checkpointLsn);
+    writeAheadLog->replay(checkpointLsn, [this](const Mutation& mutation) {
+      if (applyUnlocked(mutation, true) == MutationStatus::Applied) {
+        markDirty(mutation.deptCode);
+      }
+    });
+  } else {
+    // A fresh database starts with an empty log
+    writeAheadLog->truncate();
+  }
+}
+
+MyFileDatabase::~MyFileDatabase() { stopCheckpointing(); }
+
+// Allocates a database at the alignment of its lock stripes.
+void* MyFileDatabase::operator new(size_t size) {
+  void* pointer;
+  if (::posix_memalign(&pointer, alignof(MyFileDatabase), size) != 0) {
+    throw std::bad_alloc();
+  }
+  return pointer;
 }
 
+void MyFileDatabase::operator delete(void* pointer) { std::free(pointer); }
+
 /**
- * Sets the department mapping of the database.
+ * Sets the department mapping of the database. Waits for every in-flight
+ * request to finish before replacing the mapping.
  *
  * @param mapping the mapping of department names to Department objects
  */
 void MyFileDatabase::setMapping(
     const std::map<std::string, Department>& mapping) {
+  auto locks = acquireAllWriteLocks();
   departmentMapping = mapping;
+  rebuildIndexes();
+  markAllDirty();
+}
+
+/**
+ * Applies a mutation under the department's lock and records it in the
+ * write-ahead log. Returns only once the log record is durable; the lock is
+ * released before waiting, so the wait is shared with concurrent writers
+ * through group commit instead of blocking the department. A drop that
+ * frees a seat in a course with a waitlist enrolls the next student in the
+ * same log record.
+ *
+ * @param mutation the change to apply
+ * @return Applied on success, otherwise the reason nothing was changed
+ */
+MutationStatus MyFileDatabase::applyMutation(const Mutation& mutation) {
+  MutationStatus status;
+  uint64_t lsn = 0;
+  {
+    // Enrollment and major counters are atomic, so those mutations only need
+    // a shared lock and never wait for readers of the department.
+    bool lockFree = mutation.type == MutationType::EnrollStudent ||
+                    mutation.type == MutationType::DropStudent ||
+                    mutation.type == MutationType::AddMajor ||
+                    mutation.type == MutationType::RemoveMajor;
+    ReadLock readLock;
+    WriteLock writeLock;
+    if (lockFree) {
+      readLock = acquireReadLock(mutation.deptCode);
+      // Promoting a waiting student changes the roster, which needs the
+      // write lock. The waitlist cannot grow while the read lock is held.
+      if (mutation.type == MutationType::DropStudent &&
+          hasWaitlist(mutation)) {
+        readLock = ReadLock();
+        lockFree = false;
+      }
+    }
+    if (!lockFree) writeLock = acquireWriteLock(mutation.deptCode);
+    status = applyUnlocked(mutation, false);
+    if (status == MutationStatus::Applied) {
+      std::vector<Mutation> logged{mutation};
+      if (!lockFree) promoteWaitlisted(mutation, &logged, nullptr);
+      markDirty(mutation.deptCode);
+      if (writeAheadLog) {
+        lsn = logged.size() == 1 ? writeAheadLog->append(mutation)
+                                 : writeAheadLog->append(logged);
+      }
+    }
+  }
+  if (lsn != 0) writeAheadLog->waitForDurable(lsn);
+  return status;
+}
+
+/**
+ * Applies several mutations, in order, as one transaction: either all of
+ * them are applied and recorded in a single write-ahead log record, or, as
+ * soon as one fails, the ones before it are undone and nothing is logged.
+ * Every department involved is write-locked for the whole batch, so no
+ * reader sees part of it. Students promoted from a waitlist by a drop in
+ * the batch are logged with it, and undone with it. Returns once the
+ * record is durable.
+ *
+ * @param mutations the changes to apply
+ * @param statuses  set to the outcome of each mutation; when the batch
+ *                  fails, the failing one has its reason and the rest are
+ *                  Aborted
+ * @return true if every mutation was applied
+ */
+bool MyFileDatabase::applyMutations(const std::vector<Mutation>& mutations,
+                                    std::vector<MutationStatus>* statuses) {
+  statuses->assign(mutations.size(), MutationStatus::Aborted);
+  std::vector<std::string> deptCodes;
+  deptCodes.reserve(mutations.size());
+  for (const auto& mutation : mutations) {
+    deptCodes.push_back(mutation.deptCode);
+  }
+
+  uint64_t lsn = 0;
+  {
+    auto locks = acquireWriteLocks(deptCodes);
+    std::vector<Mutation> undo;
+    undo.reserve(mutations.size());
+    std::vector<Mutation> logged;
+    logged.reserve(mutations.size());
+    auto rollBack = [this, &undo]() {
+      for (auto it = undo.rbegin(); it != undo.rend(); ++it) {
+        if (applyUnlocked(*it, true) != MutationStatus::Applied) {
+          throw std::logic_error("Cannot undo a change to " + it->deptCode +
+                                 " " + it->courseCode);
+        }
+      }
+    };
+    for (size_t i = 0; i < mutations.size(); ++i) {
+      Mutation inverse;
+      bool invertible = inverseOf(mutations[i], &inverse);
+      MutationStatus status;
+      try {
+        status = applyUnlocked(mutations[i], false);
+      } catch (...) {
+        rollBack();
+        throw;
+      }
+      if (status != MutationStatus::Applied) {
+        (*statuses)[i] = status;
+        rollBack();
+        return false;
+      }
+      if (invertible) undo.push_back(std::move(inverse));
+      logged.push_back(mutations[i]);
+      promoteWaitlisted(mutations[i], &logged, &undo);
+    }
+
+    statuses->assign(mutations.size(), MutationStatus::Applied);
+    for (const auto& deptCode : deptCodes) markDirty(deptCode);
+    if (writeAheadLog && !mutations.empty()) {
+      lsn = writeAheadLog->append(logged);
+    }
+  }
+  if (lsn != 0) writeAheadLog->waitForDurable(lsn);
+  return true;
+}
+
+/**
+ * Builds the mutation that undoes another, from the current state of its
+ * department or course. The caller must hold the department's write lock.
+ *
+ * @param mutation the change about to be applied
+ * @param inverse  set to the change that restores the current state
+ * @return false if the department or course does not exist, in which case
+ *         the mutation cannot be applied either
+ */
+bool MyFileDatabase::inverseOf(const Mutation& mutation, Mutation* inverse) {
+  const Department* department = findDepartment(mutation.deptCode);
+  if (department == nullptr) return false;
+  *inverse = {mutation.type, mutation.deptCode, mutation.courseCode, ""};
+  if (mutation.type == MutationType::AddMajor) {
+    inverse->type = MutationType::RemoveMajor;
+    return true;
+  }
+  if (mutation.type == MutationType::RemoveMajor) {
+    inverse->type = MutationType::AddMajor;
+    return true;
+  }
+
+  const Course* course = department->findCourse(mutation.courseCode);
+  if (course == nullptr) return false;
+  switch (mutation.type) {
+    case MutationType::ChangeLocation:
+      inverse->value = course->getCourseLocation();
+      return true;
+    case MutationType::ChangeInstructor:
+      inverse->value = course->getInstructorName();
+      return true;
+    case MutationType::ChangeTime:
+      inverse->value = course->getCourseTimeSlot();
+      return true;
+    case MutationType::EnrollStudentById:
+      inverse->type = MutationType::DropStudentById;
+      inverse->value = mutation.value;
+      return true;
+    case MutationType::DropStudentById:
+      inverse->type = MutationType::EnrollStudentById;
+      inverse->value = mutation.value;
+      return true;
+    case MutationType::JoinWaitlist:
+    case MutationType::LeaveWaitlist:
+    case MutationType::SetWaitlist:
+      // Waitlist changes are undone by restoring the whole waitlist, which
+      // puts a student who left back in their place
+      inverse->type = MutationType::SetWaitlist;
+      inverse->value = course->getWaitlist().str();
+      return true;
+    default:
+      // Enrollment changes are undone by restoring the count
+      inverse->type = MutationType::SetEnrollmentCount;
+      inverse->value = std::to_string(course->getEnrolledStudentCount());
+      return true;
+  }
+}
+
+// Whether the course a mutation names has students waiting. The caller
+// holds the department's lock.
+bool MyFileDatabase::hasWaitlist(const Mutation& mutation) const {
+  const Department* department = findDepartment(mutation.deptCode);
+  if (department == nullptr) return false;
+  const Course* course = department->findCourse(mutation.courseCode);
+  return course != nullptr && !course->getWaitlist().empty();
+}
+
+// Enrolls waiting students in the course an applied drop or count change
+// freed seats in, one PromoteFromWaitlist per seat, appending each to
+// logged and the changes that undo it to undo, if given. The caller holds
+// the department's write lock.
+void MyFileDatabase::promoteWaitlisted(const Mutation& cause,
+                                       std::vector<Mutation>* logged,
+                                       std::vector<Mutation>* undo) {
+  if (cause.type != MutationType::DropStudent &&
+      cause.type != MutationType::DropStudentById &&
+      cause.type != MutationType::SetEnrollmentCount) {
+    return;
+  }
+  const Course* course =
+      findDepartment(cause.deptCode)->findCourse(cause.courseCode);
+  while (!course->getWaitlist().empty() && !course->isCourseFull()) {
+    std::string waiting = course->getWaitlist().str();
+    std::string next = std::to_string(course->getWaitlist().front());
+    Mutation promotion{MutationType::PromoteFromWaitlist, cause.deptCode,
+                       cause.courseCode, ""};
+    if (applyUnlocked(promotion, false) != MutationStatus::Applied) return;
+    logged->push_back(std::move(promotion));
+    if (undo != nullptr) {
+      // Undone in reverse: drop the student, then restore the waitlist
+      undo->push_back({MutationType::SetWaitlist, cause.deptCode,
+                       cause.courseCode, waiting});
+      undo->push_back({MutationType::DropStudentById, cause.deptCode,
+                       cause.courseCode, next});
+    }
+  }
+}
+
+/**
+ * Applies a mutation to the in-memory data. The caller must hold the
+ * department's lock, or be the only thread using the database.
+ *
+ * @param mutation  the change to apply
+ * @param replaying true when re-applying a record from the write-ahead log
+ * @return Applied on success, otherwise the reason nothing was changed
+ */
+MutationStatus MyFileDatabase::applyUnlocked(const Mutation& mutation,
+                                             bool replaying) {
+  Department* department = findDepartment(mutation.deptCode);
+  if (department == nullptr) return MutationStatus::DepartmentNotFound;
+
+  if (mutation.type == MutationType::AddMajor) {
+    department->addPersonToMajor();
+    return MutationStatus::Applied;
+  }
+  if (mutation.type == MutationType::RemoveMajor) {
+    department->dropPersonFromMajor();
+    return MutationStatus::Applied;
+  }
+
+  Course* course = department->findCourse(mutation.courseCode);
+  if (course == nullptr) return MutationStatus::CourseNotFound;
+  int courseNumber;
+  Department::parseCourseNumber(mutation.courseCode, &courseNumber);
+
+  switch (mutation.type) {
+    case MutationType::SetEnrollmentCount: {
+      // Students on the roster can only leave by being dropped by ID
+      int count = std::stoi(mutation.value);
+      if (count < static_cast<int>(course->getRoster().size())) {
+        return MutationStatus::Rejected;
+      }
+      course->setEnrolledStudentCount(count);
+      return MutationStatus::Applied;
+    }
+    case MutationType::ChangeLocation:
+      if (!roomIndex.update(mutation.deptCode, courseNumber,
+                            course->getCourseLocation(), mutation.value,
+                            course->getTimeSlot(),
+                            mutation.rejectConflicts)) {
+        return MutationStatus::RoomConflict;
+      }
+      locationSearch.update(course->getCourseLocation(), mutation.value);
+      course->reassignLocation(mutation.value);
+      responseCache.invalidateCourse(mutation.deptCode, courseNumber);
+      return MutationStatus::Applied;
+    case MutationType::ChangeInstructor:
+      instructorIndex.update(mutation.deptCode, courseNumber, *course,
+                             mutation.value);
+      instructorSearch.update(course->getInstructorName(), mutation.value);
+      course->reassignInstructor(mutation.value);
+      responseCache.invalidateCourse(mutation.deptCode, courseNumber);
+      return MutationStatus::Applied;
+    case MutationType::ChangeTime: {
+      TimeSlot oldSlot = course->getTimeSlot();
+      TimeSlot newSlot(mutation.value);
+      if (!newSlot.isValid()) return MutationStatus::Rejected;
+      if (!roomIndex.update(mutation.deptCode, courseNumber,
+                            course->getCourseLocation(),
+                            course->getCourseLocation(), newSlot,
+                            mutation.rejectConflicts)) {
+        return MutationStatus::RoomConflict;
+      }
+      course->reassignTime(mutation.value);
+      timeSlotIndex.update(mutation.deptCode, courseNumber, oldSlot, newSlot);
+      responseCache.invalidateCourse(mutation.deptCode, courseNumber);
+      return MutationStatus::Applied;
+    }
+    case MutationType::EnrollStudent:
+    case MutationType::DropStudent: {
+      int delta = mutation.type == MutationType::EnrollStudent ? 1 : -1;
+      if (replaying) {
+        // Enrollments run concurrently under a shared lock, so their log
+        // order can differ from the order they happened in. Replaying them
+        // as plain deltas gives the same count in any order.
+        course->setEnrolledStudentCount(course->getEnrolledStudentCount() +
+                                        delta);
+        return MutationStatus::Applied;
+      }
+      bool changed =
+          delta > 0 ? course->enrollStudent() : course->dropStudent();
+      return changed ? MutationStatus::Applied : MutationStatus::Rejected;
+    }
+    case MutationType::EnrollStudentById: {
+      uint32_t studentId;
+      if (!Roster::parseStudentId(mutation.value, &studentId)) {
+        return MutationStatus::Rejected;
+      }
+      if (course->isStudentEnrolled(studentId)) {
+        return MutationStatus::AlreadyEnrolled;
+      }
+      if (!course->enrollStudent(studentId)) return MutationStatus::Rejected;
+      studentIndex.add(studentId, mutation.deptCode, courseNumber);
+      return MutationStatus::Applied;
+    }
+    case MutationType::DropStudentById: {
+      uint32_t studentId;
+      if (!Roster::parseStudentId(mutation.value, &studentId)) {
+        return MutationStatus::Rejected;
+      }
+      if (!course->dropStudent(studentId)) return MutationStatus::NotEnrolled;
+      studentIndex.remove(studentId, mutation.deptCode, courseNumber);
+      return MutationStatus::Applied;
+    }
+    case MutationType::JoinWaitlist: {
+      uint32_t studentId;
+      if (!Roster::parseStudentId(mutation.value, &studentId)) {
+        return MutationStatus::Rejected;
+      }
+      if (course->isStudentEnrolled(studentId)) {
+        return MutationStatus::AlreadyEnrolled;
+      }
+      if (course->getWaitlistPosition(studentId) != 0) {
+        return MutationStatus::AlreadyWaitlisted;
+      }
+      // Students with a free seat enroll instead of waiting
+      if (!replaying && !course->isCourseFull()) {
+        return MutationStatus::Rejected;
+      }
+      course->joinWaitlist(studentId);
+      return MutationStatus::Applied;
+    }
+    case MutationType::LeaveWaitlist: {
+      uint32_t studentId;
+      if (!Roster::parseStudentId(mutation.value, &studentId)) {
+        return MutationStatus::Rejected;
+      }
+      return course->leaveWaitlist(studentId) ? MutationStatus::Applied
+                                              : MutationStatus::NotWaitlisted;
+    }
+    case MutationType::SetWaitlist: {
+      Waitlist waitlist;
+      if (!Waitlist::parse(mutation.value, &waitlist)) {
+        return MutationStatus::Rejected;
+      }
+      for (uint32_t studentId : waitlist.getStudentIds()) {
+        if (course->isStudentEnrolled(studentId)) {
+          return MutationStatus::Rejected;
+        }
+      }
+      course->setWaitlist(std::move(waitlist));
+      return MutationStatus::Applied;
+    }
+    case MutationType::PromoteFromWaitlist: {
+      uint32_t studentId;
+      if (!course->promoteFromWaitlist(&studentId)) {
+        return MutationStatus::Rejected;
+      }
+      studentIndex.add(studentId, mutation.deptCode, courseNumber);
+      return MutationStatus::Applied;
+    }
+    default:
+      return MutationStatus::Rejected;
+  }
 }
 
 /**
- * Gets the department mapping of the database.
+ * Locks a department for reading. Any number of readers of the same
+ * department may hold the lock at once; writers wait until they are done.
+ * Lookups through findDepartment() and reads of the returned Department and
+ * its courses must happen while the lock is held.
  *
- * @return the department mapping
+ * @param deptCode the code of the department that will be read
+ * @return a shared lock released when it goes out of scope
  */
-std::map<std::string, Department> MyFileDatabase::getDepartmentMapping() const {
+MyFileDatabase::ReadLock MyFileDatabase::acquireReadLock(
+    const std::string& deptCode) const {
+  return ReadLock(stripeFor(deptCode));
+}
+
+/**
+ * Locks several departments for reading at once, so that they are read as
+ * one snapshot. Each stripe is locked once, in the same fixed order as
+ * acquireAllWriteLocks(), so that two callers can never deadlock.
+ *
+ * @param deptCodes the codes of the departments that will be read; may
+ *                  repeat
+ * @return the held locks, released when the vector goes out of scope
+ */
+std::vector<MyFileDatabase::ReadLock> MyFileDatabase::acquireReadLocks(
+    const std::vector<std::string>& deptCodes) const {
+  std::set<size_t> stripes = stripesFor(deptCodes);
+  std::vector<ReadLock> locks;
+  locks.reserve(stripes.size());
+  for (size_t stripe : stripes) {
+    locks.emplace_back(lockStripes[stripe].mutex);
+  }
+  return locks;
+}
+
+/**
+ * Locks a department for modification, excluding all other readers and
+ * writers of that department. Requests for other departments are not
+ * blocked unless they happen to map to the same lock stripe.
+ *
+ * @param deptCode the code of the department that will be modified
+ * @return an exclusive lock released when it goes out of scope
+ */
+MyFileDatabase::WriteLock MyFileDatabase::acquireWriteLock(
+    const std::string& deptCode) const {
+  return WriteLock(stripeFor(deptCode));
+}
+
+/**
+ * Maps a department code onto one of the fixed lock stripes.
+ *
+ * @param deptCode the code of the department
+ * @return the reader/writer mutex guarding that department
+ */
+std::shared_timed_mutex& MyFileDatabase::stripeFor(
+    const std::string& deptCode) const {
+  return lockStripes[std::hash<std::string>{}(deptCode) % kLockStripes].mutex;
+}
+
+/**
+ * Locks several departments for modification, each stripe once and in the
+ * same fixed order as acquireAllWriteLocks().
+ *
+ * @param deptCodes the codes of the departments that will be modified; may
+ *                  repeat
+ * @return the held locks, released when the vector goes out of scope
+ */
+std::vector<MyFileDatabase::WriteLock> MyFileDatabase::acquireWriteLocks(
+    const std::vector<std::string>& deptCodes) const {
+  std::set<size_t> stripes = stripesFor(deptCodes);
+  std::vector<WriteLock> locks;
+  locks.reserve(stripes.size());
+  for (size_t stripe : stripes) {
+    locks.emplace_back(lockStripes[stripe].mutex);
+  }
+  return locks;
+}
+
+/**
+ * Maps department codes onto the distinct lock stripes that guard them.
+ *
+ * @param deptCodes the codes of the departments
+ * @return the stripes' indexes, in ascending order
+ */
+std::set<size_t> MyFileDatabase::stripesFor(
+    const std::vector<std::string>& deptCodes) const {
+  std::set<size_t> stripes;
+  for (const auto& deptCode : deptCodes) {
+    stripes.insert(std::hash<std::string>{}(deptCode) % kLockStripes);
+  }
+  return stripes;
+}
+
+/**
+ * Locks every department for reading, so that the whole catalog is read as
+ * one snapshot. Stripes are locked in the same fixed order as
+ * acquireAllWriteLocks().
+ *
+ * @return the held locks, released when the vector goes out of scope
+ */
+std::vector<MyFileDatabase::ReadLock> MyFileDatabase::acquireAllReadLocks()
+    const {
+  std::vector<ReadLock> locks;
+  locks.reserve(kLockStripes);
+  for (auto& stripe : lockStripes) {
+    locks.emplace_back(stripe.mutex);
+  }
+  return locks;
+}
+
+/**
+ * Locks every stripe exclusively, in a fixed order so that two callers can
+ * never deadlock. Used when the set of departments itself changes.
+ *
+ * @return the held locks, released when the vector goes out of scope
+ */
+std::vector<MyFileDatabase::WriteLock> MyFileDatabase::acquireAllWriteLocks()
+    const {
+  std::vector<WriteLock> locks;
+  locks.reserve(kLockStripes);
+  for (auto& stripe : lockStripes) {
+    locks.emplace_back(stripe.mutex);
+  }
+  return locks;
+}
+
+/**
+ * Gets the department mapping of the database. The reference is not guarded
+ * by any lock, so it must not be used while requests are being served.
+ *
+ * @return a read-only reference to the department mapping
+ */
+const std::map<std::string, Department>& MyFileDatabase::getDepartmentMapping()
+    const {
   return departmentMapping;
 }
 
 /**
- * Saves the contents of the internal data structure to the file. Contents of
- * the file are overwritten with this operation.
+ * Looks up a single department without copying the department mapping.
+ *
+ * @param deptCode the code of the department to find
+ * @return a pointer to the department owned by the database, or nullptr if no
+ * such department exists
  */
-void MyFileDatabase::saveContentsToFile() const {
-  std::ofstream outFile(filePath, std::ios::binary);
-  size_t mapSize = departmentMapping.size();
-  outFile.write(reinterpret_cast<const char*>(&mapSize), sizeof(mapSize));
-  for (const auto& it : departmentMapping) {
-    size_t keyLen = it.first.length();
-    outFile.write(reinterpret_cast<const char*>(&keyLen), sizeof(keyLen));
-    outFile.write(it.first.c_str(), keyLen);
-    it.second.serialize(outFile);
+Department* MyFileDatabase::findDepartment(const std::string& deptCode) {
+  auto it = departmentMapping.find(deptCode);
+  return it == departmentMapping.end() ? nullptr : &it->second;
+}
+
+const Department* MyFileDatabase::findDepartment(
+    const std::string& deptCode) const {
+  auto it = departmentMapping.find(deptCode);
+  return it == departmentMapping.end() ? nullptr : &it->second;
+}
+
+/**
+ * Saves the contents of the internal data structure to the file. Every
+ * department is re-serialized, and the file is replaced atomically as in
+ * checkpoint().
+ */
+void MyFileDatabase::saveContentsToFile() { checkpoint(true); }
+
+/**
+ * Writes the current state to the data file without stopping requests for
+ * longer than it takes to serialize the changed departments in memory.
+ *
+ * While every department is locked, the departments changed since the last
+ * checkpoint are serialized into the in-memory copy of the file and the
+ * write-ahead log is rotated. The file itself is then written to a
+ * temporary file, fsynced and renamed over the data file with no lock held,
+ * so a crash leaves either the old or the new file. Finally the rotated log
+ * is deleted, since the new file contains all of its records.
+ *
+ * @param full true to re-serialize every department, not only dirty ones
+ */
+void MyFileDatabase::checkpoint(bool full) {
+  if (filePath.empty()) return;
+  std::lock_guard<std::mutex> checkpointGuard(checkpointMutex);
+  auto start = std::chrono::steady_clock::now();
+  uint64_t lsn = 0;
+  {
+    auto locks = acquireAllWriteLocks();
+    std::set<std::string> dirty;
+    {
+      std::lock_guard<std::mutex> guard(dirtyMutex);
+      dirty.swap(dirtyDepartments);
+      full = full || fullCheckpointNeeded;
+      fullCheckpointNeeded = false;
+    }
+    if (full) {
+      serializedDepartments.clear();
+      for (const auto& it : departmentMapping) dirty.insert(it.first);
+    }
+    for (const auto& deptCode : dirty) {
+      auto it = departmentMapping.find(deptCode);
+      if (it == departmentMapping.end()) continue;
+      serializedDepartments[deptCode] = std::make_shared<const std::string>(
+          MappedDataFile::encodeDepartment(it->first, it->second));
+    }
+    if (writeAheadLog) lsn = writeAheadLog->rotate();
+  }
+
+  try {
+    writeCheckpointFile(lsn);
+  } catch (...) {
+    // The in-memory copy is up to date, so the next checkpoint retries
+    std::lock_guard<std::mutex> guard(dirtyMutex);
+    fullCheckpointNeeded = true;
+    throw;
   }
-  outFile.close();
+  if (writeAheadLog) writeAheadLog->discardRotated();
+  lastCheckpointMicros = std::chrono::duration_cast<std::chrono::microseconds>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+  ++checkpointCount;
+}
+
+/**
+ * Writes the serialized departments and the checkpoint LSN to a temporary
+ * file in the format read by MappedDataFile and atomically moves it over the
+ * data file. The caller must hold the
+ * checkpoint mutex.
+ *
+ * @param lsn the LSN of the last mutation contained in the departments
+ */
+void MyFileDatabase::writeCheckpointFile(uint64_t lsn) const {
+  const std::string tempPath = filePath + ".tmp";
+  int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) throw checkpointError("cannot open " + tempPath);
+  try {
+    std::vector<const std::string*> blocks;
+    blocks.reserve(serializedDepartments.size());
+    for (const auto& it : serializedDepartments) {
+      blocks.push_back(it.second.get());
+    }
+    const std::string index = MappedDataFile::encodeIndex(blocks, lsn);
+    writeFully(fd, index.data(), index.size());
+    for (const std::string* block : blocks) {
+      writeFully(fd, block->data(), block->size());
+    }
+    if (::fsync(fd) != 0) throw checkpointError("fsync failed");
+  } catch (...) {
+    ::close(fd);
+    ::unlink(tempPath.c_str());
+    throw;
+  }
+  ::close(fd);
+  if (::rename(tempPath.c_str(), filePath.c_str()) != 0) {
+    throw checkpointError("cannot replace " + filePath);
+  }
+  syncParentDirectory(filePath);
+}
+
+/**
+ * Starts a background thread that checkpoints the database at the given
+ * interval whenever something changed since the last checkpoint.
+ *
+ * @param interval the time between checkpoints
+ */
+void MyFileDatabase::startCheckpointing(std::chrono::milliseconds interval) {
+  stopCheckpointing();
+  stopCheckpointRequested = false;
+  checkpointThread = std::thread([this, interval]() {
+    std::unique_lock<std::mutex> lock(checkpointThreadMutex);
+    while (!checkpointWakeup.wait_for(
+        lock, interval, [this]() { return stopCheckpointRequested; })) {
+      lock.unlock();
+      try {
+        if (hasUnsavedChanges()) checkpoint(false);
+      } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+      }
+      lock.lock();
+    }
+  });
+}
+
+/**
+ * Stops the background checkpoint thread, waiting for a running checkpoint
+ * to finish. Does nothing if no thread is running.
+ */
+void MyFileDatabase::stopCheckpointing() {
+  {
+    std::lock_guard<std::mutex> guard(checkpointThreadMutex);
+    stopCheckpointRequested = true;
+  }
+  checkpointWakeup.notify_all();
+  if (checkpointThread.joinable()) checkpointThread.join();
+}
+
+/**
+ * Checks whether any department changed since the last checkpoint.
+ *
+ * @return true if a checkpoint would write something new
+ */
+bool MyFileDatabase::hasUnsavedChanges() const {
+  std::lock_guard<std::mutex> guard(dirtyMutex);
+  return !dirtyDepartments.empty();
+}
+
+/**
+ * Gets the number of checkpoints written since the database was opened.
+ *
+ * @return the number of successful checkpoints
+ */
+uint64_t MyFileDatabase::getCheckpointCount() const { return checkpointCount; }
+
+/**
+ * Gets how long the last successful checkpoint took, from taking the locks
+ * to deleting the rotated log.
+ *
+ * @return the duration, or zero if no checkpoint was written yet
+ */
+std::chrono::microseconds MyFileDatabase::getLastCheckpointDuration() const {
+  return std::chrono::microseconds(lastCheckpointMicros.load());
+}
+
+/**
+ * Records that a department must be re-serialized by the next checkpoint.
+ *
+ * @param deptCode the code of the changed department
+ */
+void MyFileDatabase::markDirty(const std::string& deptCode) {
+  std::lock_guard<std::mutex> guard(dirtyMutex);
+  dirtyDepartments.insert(deptCode);
+}
+
+/**
+ * Records that the set of departments changed, so the next checkpoint must
+ * re-serialize all of them.
+ */
+void MyFileDatabase::markAllDirty() {
+  std::lock_guard<std::mutex> guard(dirtyMutex);
+  for (const auto& it : departmentMapping) dirtyDepartments.insert(it.first);
+  fullCheckpointNeeded = true;
 }
 
 /**
  * Deserializes the object from the file and returns the department mapping.
+ * Version 2 files are mapped into memory and decoded straight from the
+ * mapping. Files in the original format are still read, and are converted
+ * by the next checkpoint; those written before the write-ahead log existed
+ * have no stored LSN and are treated as containing none of its records.
  *
  * @return the deserialized department mapping
  */
 void MyFileDatabase::deSerializeObjectFromFile() {
+  auto locks = acquireAllWriteLocks();
+  if (MappedDataFile::isMappedFormat(filePath)) {
+    MappedDataFile mappedFile(filePath);
+    departmentMapping = mappedFile.readAll();
+    checkpointLsn = mappedFile.getCheckpointLsn();
+    rebuildIndexes();
+    std::lock_guard<std::mutex> guard(dirtyMutex);
+    fullCheckpointNeeded = true;
+    return;
+  }
+
   std::ifstream inFile(filePath, std::ios::binary);
-  size_t mapSize;
+  size_t mapSize = 0;
   inFile.read(reinterpret_cast<char*>(&mapSize), sizeof(mapSize));
+  if (!inFile) return;
   for (size_t i = 0; i < mapSize; ++i) {
     size_t keyLen;
     inFile.read(reinterpret_cast<char*>(&keyLen), sizeof(keyLen));
@@ -72,7 +856,152 @@ void MyFileDatabase::deSerializeObjectFromFile() {
     dept.deserialize(inFile);
     departmentMapping[key] = dept;
   }
+  uint64_t lastLsn = 0;
+  if (inFile.read(reinterpret_cast<char*>(&lastLsn), sizeof(lastLsn))) {
+    checkpointLsn = lastLsn;
+  }
   inFile.close();
+  rebuildIndexes();
+
+  std::lock_guard<std::mutex> guard(dirtyMutex);
+  fullCheckpointNeeded = true;
+}
+
+/**
+ * Gets the index of course time slots, which is kept up to date with every
+ * change to the database.
+ *
+ * @return the time slot index
+ */
+const TimeSlotIndex& MyFileDatabase::getTimeSlotIndex() const {
+  return timeSlotIndex;
+}
+
+/**
+ * Gets the index of courses by location, which is kept up to date with every
+ * change to the database.
+ *
+ * @return the room index
+ */
+const RoomIndex& MyFileDatabase::getRoomIndex() const { return roomIndex; }
+
+/**
+ * Gets the index of courses by instructor, which is kept up to date with
+ * every change to the database.
+ *
+ * @return the instructor index
+ */
+const CourseIndex& MyFileDatabase::getInstructorIndex() const {
+  return instructorIndex;
+}
+
+/**
+ * Gets the fuzzy search over instructor names, which is kept up to date
+ * with every change to the database.
+ *
+ * @return the instructor search index
+ */
+const SearchIndex& MyFileDatabase::getInstructorSearch() const {
+  return instructorSearch;
+}
+
+/**
+ * Gets the fuzzy search over course locations, which is kept up to date
+ * with every change to the database.
+ *
+ * @return the location search index
+ */
+const SearchIndex& MyFileDatabase::getLocationSearch() const {
+  return locationSearch;
+}
+
+/**
+ * Gets the index of courses by enrolled student, which is kept up to date
+ * with every enrollment and drop by student ID.
+ *
+ * @return the student index
+ */
+const StudentIndex& MyFileDatabase::getStudentIndex() const {
+  return studentIndex;
+}
+
+/**
+ * Gets the cache of rendered department and course bodies. Bodies must be
+ * stored under the department's read lock; the database drops them when
+ * the department or course changes.
+ *
+ * @return the response cache
+ */
+ResponseCache& MyFileDatabase::getResponseCache() const {
+  return responseCache;
+}
+
+/**
+ * Indexes the time slot, location, instructor and students of every course,
+ * for lookups and for search, and empties the response cache. The caller
+ * must hold every department lock.
+ */
+void MyFileDatabase::rebuildIndexes() {
+  size_t courseCount = 0;
+  for (const auto& it : departmentMapping) {
+    courseCount += it.second.getCourses().size();
+  }
+  std::vector<ScheduledCourse> scheduled;
+  std::vector<RoomIndex::Booking> bookings;
+  std::vector<StudentIndex::Record> enrollments;
+  std::vector<std::string> instructors;
+  std::vector<std::string> locations;
+  scheduled.reserve(courseCount);
+  bookings.reserve(courseCount);
+  instructors.reserve(courseCount);
+  locations.reserve(courseCount);
+  for (const auto& it : departmentMapping) {
+    const auto& numbers = it.second.getCourseNumbers();
+    const auto& courses = it.second.getCourses();
+    for (size_t i = 0; i < courses.size(); ++i) {
+      scheduled.push_back({it.first, numbers[i], courses[i].getTimeSlot()});
+      bookings.push_back({courses[i].getCourseLocation(), scheduled.back()});
+      instructors.push_back(courses[i].getInstructorName());
+      locations.push_back(courses[i].getCourseLocation());
+      for (uint32_t studentId : courses[i].getRoster().getStudentIds()) {
+        enrollments.push_back({studentId, {it.first, numbers[i]}});
+      }
+    }
+  }
+  timeSlotIndex.rebuild(std::move(scheduled));
+  roomIndex.rebuild(std::move(bookings));
+  instructorIndex.rebuild(departmentMapping);
+  instructorSearch.rebuild(std::move(instructors));
+  locationSearch.rebuild(std::move(locations));
+  studentIndex.rebuild(enrollments);
+  responseCache.clear();
+}
+
+/**
+ * Gets the number of departments. Every department is read-locked, since
+ * setMapping() and deSerializeObjectFromFile() replace the mapping under
+ * every write lock.
+ *
+ * @return the number of departments
+ */
+size_t MyFileDatabase::getDepartmentCount() const {
+  auto locks = acquireAllReadLocks();
+  return departmentMapping.size();
+}
+
+/**
+ * Counts the courses of every department, with every department
+ * read-locked for the same reason as getDepartmentCount().
+ *
+ * @return the number of courses
+ */
+size_t MyFileDatabase::getCourseCount() const {
+  auto locks = acquireAllReadLocks();
+  size_t count = 0;
+  for (const auto& it : departmentMapping) {
+    count += it.second.getCourses().size();
+  }
+  return count;
 }
 
 /**
@@ -83,8 +1012,94 @@ void MyFileDatabase::deSerializeObjectFromFile() {
 std::string MyFileDatabase::display() const {
   std::string result;
   for (const auto& it : departmentMapping) {
+    auto lock = acquireReadLock(it.first);
     result +=
         "For the " + it.first + " department:\n" + it.second.display() + "\n";
   }
   return result;
 }
+
+/**
+ * Writes the database as a JSON object listing every department, e.g.
+ * {"departments":[{"deptCode":"COMS","courses":[...]}]}. Like display(), each
+ * department is read under its own lock.
+ *
+ * @param writer the writer to append the object to
+ */
+void MyFileDatabase::writeJson(JsonWriter& writer) const {
+  writer.beginObject().key("departments").beginArray();
+  for (const auto& it : departmentMapping) {
+    auto lock = acquireReadLock(it.first);
+    it.second.writeJson(writer);
+  }
+  writer.endArray().endObject();
+}
+
+/**
+ * Takes every department in the block format of the data file, so that the
+ * catalog can be rendered after the locks are released. Departments
+ * unchanged since the last checkpoint share the block it kept, which a
+ * later checkpoint replaces instead of modifying; only the departments
+ * changed since are encoded again. The snapshot therefore costs one pointer
+ * per department plus a copy of each changed one: nothing beyond that right
+ * after a checkpoint, but up to a full copy of the catalog before the
+ * first one, or when every department has changed since. The caller must
+ * hold acquireAllReadLocks() for the snapshot to be consistent.
+ *
+ * @return one block per department, in department code order
+ */
+MyFileDatabase::CatalogSnapshot MyFileDatabase::snapshotCatalog() const {
+  std::set<std::string> dirty;
+  bool full;
+  {
+    std::lock_guard<std::mutex> guard(dirtyMutex);
+    dirty = dirtyDepartments;
+    full = fullCheckpointNeeded;
+  }
+  CatalogSnapshot blocks;
+  blocks.reserve(departmentMapping.size());
+  for (const auto& it : departmentMapping) {
+    auto saved = serializedDepartments.find(it.first);
+    if (!full && saved != serializedDepartments.end() &&
+        dirty.count(it.first) == 0) {
+      blocks.push_back(saved->second);
+    } else {
+      blocks.push_back(std::make_shared<const std::string>(
+          MappedDataFile::encodeDepartment(it.first, it.second)));
+    }
+  }
+  return blocks;
+}
+
+/**
+ * Writes a catalog taken by snapshotCatalog() to a stream, as display() or
+ * writeJson() would render it, one department at a time through a single
+ * reused buffer, so memory use beyond the snapshot depends on the largest
+ * department rather than on the catalog. No lock is needed.
+ *
+ * @param out      the stream to write to
+ * @param snapshot the departments returned by snapshotCatalog()
+ * @param json     whether to write JSON instead of text
+ */
+void MyFileDatabase::writeCatalog(std::ostream& out,
+                                  const CatalogSnapshot& snapshot, bool json) {
+  std::string buffer;
+  JsonWriter writer(&buffer);
+  if (json) writer.beginObject().key("departments").beginArray();
+  for (const auto& block : snapshot) {
+    std::string deptCode;
+    Department department =
+        MappedDataFile::decodeDepartment(*block, &deptCode);
+    if (json) {
+      department.writeJson(writer);
+    } else {
+      buffer += "For the " + deptCode + " department:\n";
+      buffer += department.display();
+      buffer += "\n";
+    }
+    out.write(buffer.data(), buffer.size());
+    buffer.clear();
+  }
+  if (json) writer.endArray().endObject();
+  out.write(buffer.data(), buffer.size());
+}
@@ -0,0 +1,248 @@
+// Copyright 2024 Maria Surani
+#include "ResponseCache.h"
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+
+/**
+ * Creates an empty cache. The first generation is the time of creation, so
+ * tags handed out by an earlier run of the service never match.
+ */
+ResponseCache::ResponseCache()
+    : generation(std::chrono::duration_cast<std::chrono::microseconds>(
+                     std::chrono::system_clock::now().time_since_epoch())
+                     .count()),
+      catalogVersion(0) {}
+
+/**
+ * Finds the cached body of a department.
+ *
+ * @param deptCode the department's code
+ * @param encoding the coding of the body
+ * @return the body, or nullptr if it is not cached
+ */
+ResponseCache::Body ResponseCache::findDepartment(
+    const std::string& deptCode, ContentEncoding encoding) const {
+  const Shard& shard = shardFor(deptCode);
+  Body body;
+  {
+    std::shared_lock<std::shared_timed_mutex> lock(shard.mutex);
+    auto entry = shard.departments.find(deptCode);
+    if (entry != shard.departments.end()) {
+      body = entry->second.department[static_cast<size_t>(encoding)];
+    }
+  }
+  return count(std::move(body));
+}
+
+/**
+ * Finds the cached body of a course.
+ *
+ * @param deptCode     the course's department
+ * @param courseNumber the course's number
+ * @param encoding     the coding of the body
+ * @return the body, or nullptr if it is not cached
+ */
+ResponseCache::Body ResponseCache::findCourse(const std::string& deptCode,
+                                              int courseNumber,
+                                              ContentEncoding encoding) const {
+  const Shard& shard = shardFor(deptCode);
+  Body body;
+  {
+    std::shared_lock<std::shared_timed_mutex> lock(shard.mutex);
+    auto entry = shard.departments.find(deptCode);
+    if (entry != shard.departments.end()) {
+      auto course = entry->second.courses.find(courseNumber);
+      if (course != entry->second.courses.end()) {
+        body = course->second.bodies[static_cast<size_t>(encoding)];
+      }
+    }
+  }
+  return count(std::move(body));
+}
+
+/**
+ * Caches the body of a department.
+ *
+ * @param deptCode the department's code
+ * @param body     the rendered department
+ * @param encoding the coding of the body
+ * @return the cached body
+ */
+ResponseCache::Body ResponseCache::storeDepartment(const std::string& deptCode,
+                                                   std::string body,
+                                                   ContentEncoding encoding) {
+  Body stored = std::make_shared<const std::string>(std::move(body));
+  Shard& shard = shardFor(deptCode);
+  std::unique_lock<std::shared_timed_mutex> lock(shard.mutex);
+  shard.departments[deptCode].department[static_cast<size_t>(encoding)] =
+      stored;
+  return stored;
+}
+
+/**
+ * Caches the body of a course.
+ *
+ * @param deptCode     the course's department
+ * @param courseNumber the course's number
+ * @param body         the rendered course
+ * @param encoding     the coding of the body
+ * @return the cached body
+ */
+ResponseCache::Body ResponseCache::storeCourse(const std::string& deptCode,
+                                               int courseNumber,
+                                               std::string body,
+                                               ContentEncoding encoding) {
+  Body stored = std::make_shared<const std::string>(std::move(body));
+  Shard& shard = shardFor(deptCode);
+  std::unique_lock<std::shared_timed_mutex> lock(shard.mutex);
+  shard.departments[deptCode]
+      .courses[courseNumber]
+      .bodies[static_cast<size_t>(encoding)] = stored;
+  return stored;
+}
+
+/**
+ * Gets the entity tag of a department's current body, e.g. "1728000000-3"
+ * in quotes.
+ *
+ * @param deptCode the department's code
+ * @return the quoted tag
+ */
+std::string ResponseCache::getDepartmentTag(const std::string& deptCode) const {
+  const Shard& shard = shardFor(deptCode);
+  uint64_t version = 0;
+  {
+    std::shared_lock<std::shared_timed_mutex> lock(shard.mutex);
+    auto entry = shard.departments.find(deptCode);
+    if (entry != shard.departments.end()) version = entry->second.version;
+  }
+  return makeTag(version);
+}
+
+/**
+ * Gets the entity tag of a course's current body.
+ *
+ * @param deptCode     the course's department
+ * @param courseNumber the course's number
+ * @return the quoted tag
+ */
+std::string ResponseCache::getCourseTag(const std::string& deptCode,
+                                        int courseNumber) const {
+  const Shard& shard = shardFor(deptCode);
+  uint64_t version = 0;
+  {
+    std::shared_lock<std::shared_timed_mutex> lock(shard.mutex);
+    auto entry = shard.departments.find(deptCode);
+    if (entry != shard.departments.end()) {
+      auto course = entry->second.courses.find(courseNumber);
+      if (course != entry->second.courses.end()) {
+        version = course->second.version;
+      }
+    }
+  }
+  return makeTag(version);
+}
+
+/**
+ * Gets the entity tag of the whole catalog, which changes whenever any
+ * department's does. Callers hold a read lock on every department so that
+ * the tag matches what they read.
+ *
+ * @return the quoted tag
+ */
+std::string ResponseCache::getCatalogTag() const {
+  return makeTag(catalogVersion.load());
+}
+
+/**
+ * Drops the cached bodies of a course and of its department, and bumps both
+ * their versions and the catalog's.
+ *
+ * @param deptCode     the course's department
+ * @param courseNumber the course's number
+ */
+void ResponseCache::invalidateCourse(const std::string& deptCode,
+                                     int courseNumber) {
+  Shard& shard = shardFor(deptCode);
+  std::unique_lock<std::shared_timed_mutex> lock(shard.mutex);
+  Entry& entry = shard.departments[deptCode];
+  entry.department = Bodies();
+  ++entry.version;
+  CourseEntry& course = entry.courses[courseNumber];
+  course.bodies = Bodies();
+  ++course.version;
+  ++catalogVersion;
+}
+
+/**
+ * Drops every cached body and version and starts a new generation, for when
+ * the whole catalog is replaced.
+ */
+void ResponseCache::clear() {
+  ++generation;
+  for (auto& shard : shards) {
+    std::unique_lock<std::shared_timed_mutex> lock(shard.mutex);
+    shard.departments.clear();
+  }
+}
+
+/**
+ * Gets the number of lookups that found a cached body.
+ *
+ * @return the number of hits
+ */
+uint64_t ResponseCache::getHitCount() const {
+  return static_cast<uint64_t>(hits.load());
+}
+
+/**
+ * Gets the number of lookups that found nothing cached.
+ *
+ * @return the number of misses
+ */
+uint64_t ResponseCache::getMissCount() const {
+  return static_cast<uint64_t>(misses.load());
+}
+
+/**
+ * Gets the number of cached bodies.
+ *
+ * @return the number of bodies held, counting each coding of a body
+ */
+size_t ResponseCache::size() const {
+  size_t total = 0;
+  for (const auto& shard : shards) {
+    std::shared_lock<std::shared_timed_mutex> lock(shard.mutex);
+    for (const auto& entry : shard.departments) {
+      for (const auto& body : entry.second.department) {
+        if (body) ++total;
+      }
+      for (const auto& course : entry.second.courses) {
+        for (const auto& body : course.second.bodies) {
+          if (body) ++total;
+        }
+      }
+    }
+  }
+  return total;
+}
+
+ResponseCache::Shard& ResponseCache::shardFor(
+    const std::string& deptCode) const {
+  return shards[std::hash<std::string>{}(deptCode) % kShards];
+}
+
+// Counts a lookup as a hit or a miss.
+ResponseCache::Body ResponseCache::count(Body body) const {
+  (body ? hits : misses).add(1);
+  return body;
+}
+
+std::string ResponseCache::makeTag(uint64_t version) const {
+  return "\"" + std::to_string(generation.load()) + "-" +
+         std::to_string(version) + "\"";
+}
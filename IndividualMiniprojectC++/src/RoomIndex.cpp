@@ -0,0 +1,194 @@
+// Copyright 2024 Maria Surani
+#include "RoomIndex.h"
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+bool startsEarlier(const ScheduledCourse& a, const ScheduledCourse& b) {
+  const TimeSlot& x = a.timeSlot;
+  const TimeSlot& y = b.timeSlot;
+  if (x.getStartMinute() != y.getStartMinute()) {
+    return x.getStartMinute() < y.getStartMinute();
+  }
+  if (a.deptCode != b.deptCode) return a.deptCode < b.deptCode;
+  return a.courseNumber < b.courseNumber;
+}
+
+}  // namespace
+
+RoomIndex::RoomIndex() : hasPending(false) {}
+
+/**
+ * Replaces the contents of the index when it is next used.
+ *
+ * @param bookings the location of every course
+ */
+void RoomIndex::rebuild(std::vector<Booking> bookings) {
+  std::unique_lock<std::shared_timed_mutex> lock(mutex);
+  rooms.clear();
+  pending = std::move(bookings);
+  hasPending = true;
+}
+
+/**
+ * Moves a course to a new location and time slot, either of which may be
+ * unchanged. With rejectConflicts set, nothing is changed if the course
+ * would then overlap another course in its new location.
+ *
+ * @param deptCode        the course's department
+ * @param courseNumber    the course's number
+ * @param oldLocation     the location it is indexed under
+ * @param newLocation     its new location
+ * @param newSlot         its new time slot
+ * @param rejectConflicts true to refuse a change that double-books a room
+ * @return false if the change was refused, true if it was applied
+ */
+bool RoomIndex::update(const std::string& deptCode, int courseNumber,
+                       const std::string& oldLocation,
+                       const std::string& newLocation, const TimeSlot& newSlot,
+                       bool rejectConflicts) {
+  std::unique_lock<std::shared_timed_mutex> lock(mutex);
+  buildPendingUnlocked();
+  auto isCourse = [&](const ScheduledCourse& course) {
+    return course.courseNumber == courseNumber && course.deptCode == deptCode;
+  };
+
+  if (rejectConflicts && !newLocation.empty()) {
+    auto room = rooms.find(newLocation);
+    if (room != rooms.end()) {
+      for (const auto& other : room->second) {
+        if (!isCourse(other) && other.timeSlot.overlaps(newSlot)) return false;
+      }
+    }
+  }
+
+  auto oldRoom = rooms.find(oldLocation);
+  if (oldRoom != rooms.end()) {
+    auto& courses = oldRoom->second;
+    courses.erase(std::remove_if(courses.begin(), courses.end(), isCourse),
+                  courses.end());
+    if (courses.empty()) rooms.erase(oldRoom);
+  }
+  if (!newLocation.empty()) {
+    rooms[newLocation].push_back({deptCode, courseNumber, newSlot});
+  }
+  return true;
+}
+
+/**
+ * Finds the courses held in a location.
+ *
+ * @param location the location, e.g. "417 IAB"
+ * @return the courses, ordered by start time
+ */
+std::vector<ScheduledCourse> RoomIndex::findCourses(
+    const std::string& location) const {
+  std::vector<ScheduledCourse> result;
+  {
+    auto lock = lockForQuery();
+    auto room = rooms.find(location);
+    if (room != rooms.end()) result = room->second;
+  }
+  std::sort(result.begin(), result.end(), startsEarlier);
+  return result;
+}
+
+/**
+ * Finds the pairs of courses that overlap in a location.
+ *
+ * @param location the location, e.g. "417 IAB"
+ * @return the conflicts, ordered by the start time of the earlier course
+ */
+std::vector<RoomConflict> RoomIndex::findConflicts(
+    const std::string& location) const {
+  std::vector<RoomConflict> result;
+  appendConflicts(location, findCourses(location), &result);
+  return result;
+}
+
+/**
+ * Finds the pairs of courses that overlap in any location.
+ *
+ * @return the conflicts, ordered by location and then by start time
+ */
+std::vector<RoomConflict> RoomIndex::findAllConflicts() const {
+  std::vector<std::pair<std::string, std::vector<ScheduledCourse>>> snapshot;
+  {
+    auto lock = lockForQuery();
+    snapshot.assign(rooms.begin(), rooms.end());
+  }
+  std::sort(snapshot.begin(), snapshot.end(),
+            [](const std::pair<std::string, std::vector<ScheduledCourse>>& a,
+               const std::pair<std::string, std::vector<ScheduledCourse>>& b) {
+              return a.first < b.first;
+            });
+  std::vector<RoomConflict> result;
+  for (auto& room : snapshot) {
+    std::sort(room.second.begin(), room.second.end(), startsEarlier);
+    appendConflicts(room.first, std::move(room.second), &result);
+  }
+  return result;
+}
+
+/**
+ * Gets the number of locations with at least one course.
+ *
+ * @return the number of indexed locations
+ */
+size_t RoomIndex::getRoomCount() const {
+  auto lock = lockForQuery();
+  return rooms.size();
+}
+
+// Groups the bookings passed to rebuild() by room, if there are any. The
+// caller must hold the lock exclusively.
+void RoomIndex::buildPendingUnlocked() const {
+  if (!hasPending) return;
+  for (auto& booking : pending) {
+    if (!booking.location.empty()) {
+      rooms[booking.location].push_back(std::move(booking.course));
+    }
+  }
+  pending.clear();
+  pending.shrink_to_fit();
+  hasPending = false;
+}
+
+// Takes the lock for a query, first grouping any pending bookings.
+std::shared_lock<std::shared_timed_mutex> RoomIndex::lockForQuery() const {
+  while (true) {
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+    if (!hasPending) return lock;
+    lock.unlock();
+    std::unique_lock<std::shared_timed_mutex> exclusive(mutex);
+    buildPendingUnlocked();
+  }
+}
+
+// Sweeps courses sorted by start time, pairing each one with the later
+// courses that start before it ends.
+void RoomIndex::appendConflicts(const std::string& location,
+                                std::vector<ScheduledCourse> courses,
+                                std::vector<RoomConflict>* out) {
+  courses.erase(std::remove_if(courses.begin(), courses.end(),
+                               [](const ScheduledCourse& course) {
+                                 return !course.timeSlot.isValid();
+                               }),
+                courses.end());
+  for (size_t i = 0; i < courses.size(); ++i) {
+    const TimeSlot& slot = courses[i].timeSlot;
+    for (size_t j = i + 1; j < courses.size() &&
+                           courses[j].timeSlot.getStartMinute() <
+                               slot.getEndMinute();
+         ++j) {
+      if (slot.overlaps(courses[j].timeSlot)) {
+        out->push_back({location, courses[i], courses[j]});
+      }
+    }
+  }
+}
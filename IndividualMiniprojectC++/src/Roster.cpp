@@ -0,0 +1,134 @@
+// Copyright 2024 Maria Surani
+#include "Roster.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Checks whether a student is on the roster.
+ *
+ * @param studentId the student's ID
+ * @return true if the student is enrolled
+ */
+bool Roster::contains(uint32_t studentId) const {
+  return std::binary_search(studentIds.begin(), studentIds.end(), studentId);
+}
+
+/**
+ * Adds a student to the roster.
+ *
+ * @param studentId the student's ID
+ * @return true if the student was added, false if already on the roster
+ */
+bool Roster::add(uint32_t studentId) {
+  auto it = std::lower_bound(studentIds.begin(), studentIds.end(), studentId);
+  if (it != studentIds.end() && *it == studentId) return false;
+  studentIds.insert(it, studentId);
+  return true;
+}
+
+/**
+ * Removes a student from the roster.
+ *
+ * @param studentId the student's ID
+ * @return true if the student was removed, false if not on the roster
+ */
+bool Roster::remove(uint32_t studentId) {
+  auto it = std::lower_bound(studentIds.begin(), studentIds.end(), studentId);
+  if (it == studentIds.end() || *it != studentId) return false;
+  studentIds.erase(it);
+  return true;
+}
+
+/**
+ * Gets the number of students on the roster.
+ *
+ * @return the roster's size
+ */
+size_t Roster::size() const { return studentIds.size(); }
+
+/**
+ * Gets the IDs of the students on the roster.
+ *
+ * @return the IDs in ascending order
+ */
+const std::vector<uint32_t>& Roster::getStudentIds() const {
+  return studentIds;
+}
+
+/**
+ * Encodes the roster as the gaps between successive IDs, starting from 0,
+ * each written as a varint of seven bits per byte, low bits first.
+ *
+ * @return the encoded roster; empty for an empty roster
+ */
+std::string Roster::encode() const {
+  std::string out;
+  out.reserve(studentIds.size() * 2);
+  uint32_t previous = 0;
+  for (uint32_t studentId : studentIds) {
+    uint32_t gap = studentId - previous;
+    previous = studentId;
+    while (gap >= 0x80) {
+      out.push_back(static_cast<char>(gap | 0x80));
+      gap >>= 7;
+    }
+    out.push_back(static_cast<char>(gap));
+  }
+  return out;
+}
+
+/**
+ * Decodes a roster written by encode().
+ *
+ * @param data the encoded roster
+ * @param size the number of bytes
+ * @param out  set to the decoded roster
+ * @return false if the bytes are not a valid roster
+ */
+bool Roster::decode(const char* data, size_t size, Roster* out) {
+  std::vector<uint32_t> studentIds;
+  uint64_t previous = 0;
+  size_t i = 0;
+  while (i < size) {
+    uint64_t gap = 0;
+    int shift = 0;
+    unsigned char byte;
+    do {
+      if (i == size || shift > 28) return false;
+      byte = static_cast<unsigned char>(data[i++]);
+      gap |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      shift += 7;
+    } while (byte & 0x80);
+    // IDs are strictly increasing, so every gap but the first is positive
+    if ((gap == 0 && !studentIds.empty()) || previous + gap > UINT32_MAX) {
+      return false;
+    }
+    previous += gap;
+    studentIds.push_back(static_cast<uint32_t>(previous));
+  }
+  out->studentIds = std::move(studentIds);
+  return true;
+}
+
+/**
+ * Parses a student ID as written in requests and logs.
+ *
+ * @param text      the ID, in decimal
+ * @param studentId set to the parsed ID
+ * @return false if the text is not a decimal number that fits in 32 bits
+ */
+bool Roster::parseStudentId(const std::string& text, uint32_t* studentId) {
+  if (text.empty() || text.size() > 10) return false;
+  uint64_t value = 0;
+  for (char c : text) {
+    if (c < '0' || c > '9') return false;
+    value = value * 10 + (c - '0');
+  }
+  if (value > UINT32_MAX) return false;
+  *studentId = static_cast<uint32_t>(value);
+  return true;
+}
@@ -1,13 +1,29 @@
 // Copyright 2024 Maria Surani
 #include "RouteController.h"
 
+#include <unistd.h>
+
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
 #include <exception>
+#include <fstream>
 #include <iostream>
+#include <limits>
 #include <map>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "Compression.h"
 #include "Globals.h"
+#include "JsonWriter.h"
 #include "MyFileDatabase.h"
+#include "Roster.h"
 #include "crow.h"  // NOLINT
 
 // Utility function to handle exceptions
@@ -16,6 +32,354 @@ crow::response handleException(const std::exception& e) {
   return crow::response{500, "An error has occurred"};
 }
 
+// Whether a mutating request asked to refuse double-booking a room
+bool rejectsRoomConflicts(const crow::request& req) {
+  const char* value = req.url_params.get("rejectConflicts");
+  return value != nullptr && std::string(value) == "true";
+}
+
+// Whether a request's If-None-Match header lists an entity tag, compared
+// weakly as RFC 9110 asks for conditional GETs
+bool matchesEntityTag(const crow::request& req, const std::string& tag) {
+  const std::string& header = req.get_header_value("If-None-Match");
+  size_t start = 0;
+  while (start < header.size()) {
+    size_t end = header.find(',', start);
+    if (end == std::string::npos) end = header.size();
+    size_t first = header.find_first_not_of(" \t", start);
+    size_t last = header.find_last_not_of(" \t", end - 1);
+    if (first != std::string::npos && first < end && last >= first) {
+      std::string candidate = header.substr(first, last - first + 1);
+      if (candidate.compare(0, 2, "W/") == 0) candidate.erase(0, 2);
+      if (candidate == "*" || candidate == tag) return true;
+    }
+    start = end + 1;
+  }
+  return false;
+}
+
+// How well a media range from an Accept header matches a media type: 2 for
+// the type itself, 1 for its type/* range, 0 for */*, and -1 otherwise
+int mediaRangeMatch(const std::string& range, const std::string& type) {
+  if (range == type) return 2;
+  if (range == "*/*") return 0;
+  size_t slash = type.find('/');
+  return range == type.substr(0, slash) + "/*" ? 1 : -1;
+}
+
+// Whether a request's Accept header prefers application/json to
+// text/plain. Each type takes the q value of the most specific range that
+// matches it, and text wins ties so that clients sending */* keep getting
+// the text format.
+bool acceptsJson(const crow::request& req) {
+  const std::string& header = req.get_header_value("Accept");
+  const std::string types[] = {"application/json", "text/plain"};
+  int specificity[] = {-1, -1};
+  double quality[] = {0, 0};
+  size_t start = 0;
+  while (start < header.size()) {
+    size_t end = header.find(',', start);
+    if (end == std::string::npos) end = header.size();
+    std::string range = header.substr(start, end - start);
+    start = end + 1;
+
+    double q = 1;
+    size_t params = range.find(';');
+    if (params != std::string::npos) {
+      size_t qAt = range.find("q=", params);
+      if (qAt != std::string::npos) q = std::atof(range.c_str() + qAt + 2);
+      range.erase(params);
+    }
+    range.erase(0, range.find_first_not_of(" \t"));
+    range.erase(range.find_last_not_of(" \t") + 1);
+    for (int i = 0; i < 2; ++i) {
+      int match = mediaRangeMatch(range, types[i]);
+      if (match > specificity[i]) {
+        specificity[i] = match;
+        quality[i] = q;
+      }
+    }
+  }
+  return quality[0] > 0 && quality[0] > quality[1];
+}
+
+// The entity tag of the JSON form of a resource, which must differ from the
+// tag of its text form
+std::string jsonTag(std::string tag) {
+  tag.insert(tag.size() - 1, "-json");
+  return tag;
+}
+
+// Picks the coding to compress a response with from a request's
+// Accept-Encoding header: whichever of gzip and deflate has the higher q
+// value, gzip on ties, or identity if neither is accepted. Codings that are
+// not listed take the q value of *, if it is.
+ContentEncoding acceptedEncoding(const crow::request& req) {
+  const std::string& header = req.get_header_value("Accept-Encoding");
+  double gzip = -1;
+  double deflate = -1;
+  double any = -1;
+  size_t start = 0;
+  while (start < header.size()) {
+    size_t end = header.find(',', start);
+    if (end == std::string::npos) end = header.size();
+    std::string coding = header.substr(start, end - start);
+    start = end + 1;
+
+    double q = 1;
+    size_t params = coding.find(';');
+    if (params != std::string::npos) {
+      size_t qAt = coding.find("q=", params);
+      if (qAt != std::string::npos) q = std::atof(coding.c_str() + qAt + 2);
+      coding.erase(params);
+    }
+    coding.erase(0, coding.find_first_not_of(" \t"));
+    coding.erase(coding.find_last_not_of(" \t") + 1);
+    for (char& c : coding) c = std::tolower(static_cast<unsigned char>(c));
+    if (coding == "gzip" || coding == "x-gzip") {
+      gzip = q;
+    } else if (coding == "deflate") {
+      deflate = q;
+    } else if (coding == "*") {
+      any = q;
+    }
+  }
+  if (gzip < 0) gzip = any;
+  if (deflate < 0) deflate = any;
+  if (gzip > 0 && gzip >= deflate) return ContentEncoding::Gzip;
+  if (deflate > 0) return ContentEncoding::Deflate;
+  return ContentEncoding::Identity;
+}
+
+// The entity tag of a resource sent in a content coding, which must differ
+// from the tag of the uncompressed form
+std::string encodedTag(std::string tag, ContentEncoding encoding) {
+  if (encoding != ContentEncoding::Identity) {
+    tag.insert(tag.size() - 1,
+               std::string("-") + contentEncodingName(encoding));
+  }
+  return tag;
+}
+
+// Bodies smaller than this are sent uncompressed, since compressing them
+// saves too little to pay for itself
+const size_t kMinCompressedSize = 1024;
+
+// Compresses a response's body in place, if it is large enough and the
+// client accepts a compressed coding
+void compressBody(crow::response& res, ContentEncoding encoding) {
+  if (encoding == ContentEncoding::Identity ||
+      res.body.size() < kMinCompressedSize) {
+    return;
+  }
+  res.body = compress(res.body, encoding);
+  res.set_header("Content-Encoding", contentEncodingName(encoding));
+}
+
+// The most courses one /retrieveCourses request may ask for
+const size_t kMaxBatchCourses = 100;
+
+// A course named by a /retrieveCourses request
+struct CourseRef {
+  std::string deptCode;
+  int courseNumber;
+};
+
+// Reads the courses a /retrieveCourses request asks for, either from a JSON
+// body such as {"courses": [{"deptCode": "COMS", "courseCode": 1004}]} or
+// from a query such as ?courses=COMS:1004,PHYS:1001. Returns false if the
+// list is missing or malformed.
+bool parseCourseRefs(const crow::request& req, std::vector<CourseRef>* refs) {
+  if (!req.body.empty()) {
+    try {
+      crow::json::rvalue body = crow::json::load(req.body);
+      if (!body || !body.has("courses")) return false;
+      for (const auto& item : body["courses"]) {
+        refs->push_back({std::string(item["deptCode"].s()),
+                         static_cast<int>(item["courseCode"].i())});
+      }
+    } catch (const std::exception&) {
+      // Crow throws when a value is missing or has the wrong type
+      return false;
+    }
+    return !refs->empty();
+  }
+
+  const char* courses = req.url_params.get("courses");
+  if (courses == nullptr) return false;
+  std::string list = courses;
+  size_t start = 0;
+  while (start <= list.size()) {
+    size_t end = list.find(',', start);
+    if (end == std::string::npos) end = list.size();
+    std::string item = list.substr(start, end - start);
+    size_t colon = item.find(':');
+    CourseRef ref;
+    if (colon == 0 || colon == std::string::npos ||
+        !Department::parseCourseNumber(item.substr(colon + 1),
+                                       &ref.courseNumber)) {
+      return false;
+    }
+    ref.deptCode = item.substr(0, colon);
+    refs->push_back(std::move(ref));
+    start = end + 1;
+  }
+  return true;
+}
+
+// The most operations one /batchUpdate request may hold
+const size_t kMaxBatchOperations = 1000;
+
+// An operation /batchUpdate accepts: the route it does the work of, the
+// mutation it makes, and the field holding the new value, if there is one
+struct BatchOperation {
+  const char* name;
+  MutationType type;
+  const char* field;
+};
+
+const BatchOperation kBatchOperations[] = {
+    {"setEnrollmentCount", MutationType::SetEnrollmentCount, "count"},
+    {"changeCourseLocation", MutationType::ChangeLocation, "location"},
+    {"changeCourseTeacher", MutationType::ChangeInstructor, "instructor"},
+    {"changeCourseTime", MutationType::ChangeTime, "time"},
+    {"addMajorToDept", MutationType::AddMajor, nullptr},
+    {"removeMajorFromDept", MutationType::RemoveMajor, nullptr},
+    {"enrollStudentInCourse", MutationType::EnrollStudent, nullptr},
+    {"dropStudentFromCourse", MutationType::DropStudent, nullptr},
+    {"joinWaitlist", MutationType::JoinWaitlist, nullptr},
+    {"leaveWaitlist", MutationType::LeaveWaitlist, nullptr},
+};
+
+// Reads one operation of a /batchUpdate body, e.g. {"op":
+// "changeCourseLocation", "deptCode": "COMS", "courseCode": 1004,
+// "location": "417 IAB"}. Enrollments and drops may name the student with
+// "studentId", which waitlist operations require. Returns false if it is
+// malformed.
+bool parseBatchOperation(const crow::json::rvalue& item, Mutation* mutation) {
+  const BatchOperation* operation = nullptr;
+  std::string name(item["op"].s());
+  for (const auto& candidate : kBatchOperations) {
+    if (name == candidate.name) operation = &candidate;
+  }
+  if (operation == nullptr) return false;
+
+  mutation->type = operation->type;
+  mutation->deptCode = std::string(item["deptCode"].s());
+  if (operation->type != MutationType::AddMajor &&
+      operation->type != MutationType::RemoveMajor) {
+    mutation->courseCode = std::to_string(item["courseCode"].i());
+  }
+  if (operation->type == MutationType::SetEnrollmentCount) {
+    int64_t count = item["count"].i();
+    if (count < 0 || count > std::numeric_limits<int>::max()) return false;
+    mutation->value = std::to_string(count);
+  } else if (operation->field != nullptr) {
+    mutation->value = std::string(item[operation->field].s());
+  }
+  bool waitlist = operation->type == MutationType::JoinWaitlist ||
+                  operation->type == MutationType::LeaveWaitlist;
+  if (waitlist || operation->type == MutationType::EnrollStudent ||
+      operation->type == MutationType::DropStudent) {
+    if (!item.has("studentId")) return !waitlist;
+    int64_t studentId = item["studentId"].i();
+    if (studentId < 0 || studentId > std::numeric_limits<uint32_t>::max()) {
+      return false;
+    }
+    if (operation->type == MutationType::EnrollStudent) {
+      mutation->type = MutationType::EnrollStudentById;
+    } else if (operation->type == MutationType::DropStudent) {
+      mutation->type = MutationType::DropStudentById;
+    }
+    mutation->value = std::to_string(studentId);
+  }
+  mutation->rejectConflicts = item.has("rejectConflicts") &&
+                              item["rejectConflicts"].t() ==
+                                  crow::json::type::True;
+  return true;
+}
+
+// Describes the outcome of one /batchUpdate operation
+std::string describeStatus(MutationStatus status) {
+  switch (status) {
+    case MutationStatus::Applied:
+      return "Applied";
+    case MutationStatus::DepartmentNotFound:
+      return "Department Not Found";
+    case MutationStatus::CourseNotFound:
+      return "Course Not Found";
+    case MutationStatus::Rejected:
+      return "Rejected";
+    case MutationStatus::RoomConflict:
+      return "The room is already booked at that time.";
+    case MutationStatus::AlreadyEnrolled:
+      return "Student is already enrolled";
+    case MutationStatus::NotEnrolled:
+      return "Student is not enrolled";
+    case MutationStatus::AlreadyWaitlisted:
+      return "Student is already on the waitlist";
+    case MutationStatus::NotWaitlisted:
+      return "Student is not on the waitlist";
+    default:
+      return "Not applied";
+  }
+}
+
+// Lists courses one per line, e.g. "COMS 1004: 11:40-12:55"
+std::string listScheduledCourses(const std::vector<ScheduledCourse>& courses) {
+  std::string result;
+  for (const auto& course : courses) {
+    result += course.deptCode + " " + std::to_string(course.courseNumber) +
+              ": " + course.timeSlot.str() + "\n";
+  }
+  return result;
+}
+
+// Lists courses on one line, e.g. "COMS 1004, COMS 3157"
+template <typename CourseRef>
+std::string joinCourses(const std::vector<CourseRef>& courses) {
+  std::string result;
+  for (const auto& course : courses) {
+    if (!result.empty()) result += ", ";
+    result += course.deptCode + " " + std::to_string(course.courseNumber);
+  }
+  return result;
+}
+
+// Reads the optional studentId parameter of an enrollment or drop into
+// mutation, switching it to byId. Returns false if the ID is invalid.
+bool readStudentId(const crow::request& req, MutationType byId,
+                   Mutation* mutation) {
+  const char* param = req.url_params.get("studentId");
+  if (param == nullptr) return true;
+  uint32_t studentId;
+  if (!Roster::parseStudentId(param, &studentId)) return false;
+  mutation->type = byId;
+  mutation->value = std::to_string(studentId);
+  return true;
+}
+
+// Checks the deptCode, courseCode and studentId parameters every waitlist
+// route takes, answering 400 if one is missing or invalid.
+bool readWaitlistParams(const crow::request& req, crow::response& res,
+                        uint32_t* studentId) {
+  if (!req.url_params.get("deptCode") || !req.url_params.get("courseCode") ||
+      !req.url_params.get("studentId")) {
+    res.code = 400;
+    res.write(
+        "Department code, course code and student ID must be included in the "
+        "request.");
+  } else if (!Roster::parseStudentId(req.url_params.get("studentId"),
+                                     studentId)) {
+    res.code = 400;
+    res.write("Invalid student ID.");
+  } else {
+    return true;
+  }
+  res.end();
+  return false;
+}
+
 /**
  * Redirects to the homepage.
  *
@@ -38,7 +402,10 @@ void RouteController::index(crow::response& res) {
  *
  * @return A crow::response object containing either the details of the
  * Department and an HTTP 200 response or, an appropriate message indicating the
- * proper response.
+ * proper response. A found department's response carries its ETag, and a
+ * request whose If-None-Match lists that tag gets an empty HTTP 304 instead.
+ * A request whose Accept header prefers application/json gets the department
+ * as JSON, as written by Department::writeJson(), instead of text.
  */
 void RouteController::retrieveDepartment(const crow::request& req,
                                          crow::response& res) {
@@ -50,16 +417,49 @@ void RouteController::retrieveDepartment(const crow::request& req,
       res.end();
       return;
     }
-    auto departmentMapping = myFileDatabase->getDepartmentMapping();
-
-    auto it = departmentMapping.find(deptCode);
-    if (it == departmentMapping.end()) {
+    auto lock = myFileDatabase->acquireReadLock(deptCode);
+    const Department* department = myFileDatabase->findDepartment(deptCode);
+    if (department == nullptr) {
       res.code = 404;
       res.write("Department Not Found");
-    } else {
-      res.code = 200;
-      res.write(it->second.display());  // Use dot operator to access method
+      res.end();
+      return;
+    }
+    ResponseCache& cache = myFileDatabase->getResponseCache();
+    bool json = acceptsJson(req);
+    ContentEncoding encoding = acceptedEncoding(req);
+    std::string tag = cache.getDepartmentTag(deptCode);
+    if (json) tag = jsonTag(tag);
+    tag = encodedTag(tag, encoding);
+    res.set_header("ETag", tag);
+    res.set_header("Vary", "Accept, Accept-Encoding");
+    if (matchesEntityTag(req, tag)) {
+      res.code = 304;
+      res.end();
+      return;
+    }
+    res.code = 200;
+    if (json) {
+      res.set_header("Content-Type", "application/json");
+      JsonWriter writer(&res.body);
+      department->writeJson(writer);
+      compressBody(res, encoding);
+      res.end();
+      return;
+    }
+    ResponseCache::Body body = cache.findDepartment(deptCode);
+    if (!body) body = cache.storeDepartment(deptCode, department->display());
+    if (encoding != ContentEncoding::Identity &&
+        body->size() >= kMinCompressedSize) {
+      ResponseCache::Body compressed = cache.findDepartment(deptCode, encoding);
+      if (!compressed) {
+        compressed = cache.storeDepartment(
+            deptCode, compress(*body, encoding), encoding);
+      }
+      body = compressed;
+      res.set_header("Content-Encoding", contentEncodingName(encoding));
     }
+    res.write(*body);
     res.end();
   } catch (const std::exception& e) {
     res = handleException(e);
@@ -78,7 +478,10 @@ void RouteController::retrieveDepartment(const crow::request& req,
  *
  * @return           A crow::response object containing either the details of
  * the course and an HTTP 200 response or, an appropriate message indicating the
- *                   proper response.
+ *                   proper response. As for departments, the course's ETag
+ *                   lets a request with If-None-Match get HTTP 304 instead.
+ *                   As for departments, Accept may ask for JSON such as
+ *                   {"deptCode":"COMS","courseCode":1004,"instructor":...}.
  */
 void RouteController::retrieveCourse(const crow::request& req,
                                      crow::response& res) {
@@ -95,24 +498,246 @@ void RouteController::retrieveCourse(const crow::request& req,
     auto deptCode = req.url_params.get("deptCode");
     auto courseCode = std::stoi(req.url_params.get("courseCode"));
 
-    auto departmentMapping = myFileDatabase->getDepartmentMapping();
-    auto deptIt = departmentMapping.find(deptCode);
-
-    if (deptIt == departmentMapping.end()) {
+    auto lock = myFileDatabase->acquireReadLock(deptCode);
+    const Department* department = myFileDatabase->findDepartment(deptCode);
+    const Course* course =
+        department ? department->findCourse(courseCode) : nullptr;
+    if (course == nullptr) {
       res.code = 404;
-      res.write("Department Not Found");
-    } else {
-      auto coursesMapping = deptIt->second.getCourseSelection();
-      auto courseIt = coursesMapping.find(std::to_string(courseCode));
+      res.write(department ? "Course Not Found" : "Department Not Found");
+      res.end();
+      return;
+    }
+    ResponseCache& cache = myFileDatabase->getResponseCache();
+    bool json = acceptsJson(req);
+    ContentEncoding encoding = acceptedEncoding(req);
+    std::string tag = cache.getCourseTag(deptCode, courseCode);
+    if (json) tag = jsonTag(tag);
+    tag = encodedTag(tag, encoding);
+    res.set_header("ETag", tag);
+    res.set_header("Vary", "Accept, Accept-Encoding");
+    if (matchesEntityTag(req, tag)) {
+      res.code = 304;
+      res.end();
+      return;
+    }
+    res.code = 200;
+    if (json) {
+      res.set_header("Content-Type", "application/json");
+      JsonWriter writer(&res.body);
+      writer.beginObject().key("deptCode").value(deptCode);
+      writer.key("courseCode").value(courseCode);
+      course->writeJsonFields(writer);
+      writer.endObject();
+      compressBody(res, encoding);
+      res.end();
+      return;
+    }
+    ResponseCache::Body body = cache.findCourse(deptCode, courseCode);
+    if (!body) {
+      body = cache.storeCourse(deptCode, courseCode, course->display());
+    }
+    if (encoding != ContentEncoding::Identity &&
+        body->size() >= kMinCompressedSize) {
+      ResponseCache::Body compressed =
+          cache.findCourse(deptCode, courseCode, encoding);
+      if (!compressed) {
+        compressed = cache.storeCourse(deptCode, courseCode,
+                                       compress(*body, encoding), encoding);
+      }
+      body = compressed;
+      res.set_header("Content-Encoding", contentEncodingName(encoding));
+    }
+    res.write(*body);
+    res.end();
+  } catch (const std::exception& e) {
+    res = handleException(e);
+  }
+}
 
-      if (courseIt == coursesMapping.end()) {
-        res.code = 404;
-        res.write("Course Not Found");
-      } else {
-        res.code = 200;
-        res.write(
-            courseIt->second->display());  // Use dot operator to access method
+/**
+ * Displays the details of several courses, and whether each is full, in one
+ * response. The courses are given as a query such as
+ * ?courses=COMS:1004,PHYS:1001 or as a JSON body such as
+ * {"courses": [{"deptCode": "COMS", "courseCode": 1004}]}, and are all read
+ * under one set of department locks, so they reflect a single moment.
+ *
+ * @return A crow::response object containing, for each requested course in
+ * order, its details and "Full: true" or "Full: false", or why it was not
+ * found, with an HTTP 200 response; or an HTTP 400 response if the list is
+ * missing or malformed, or 413 if it names more than 100 courses.
+ * If Accept prefers application/json, the courses are listed as JSON,
+ * {"courses":[...]}, each with its codes and either its details and "full",
+ * or an "error".
+ */
+void RouteController::retrieveCourses(const crow::request& req,
+                                      crow::response& res) {
+  try {
+    std::vector<CourseRef> refs;
+    if (!parseCourseRefs(req, &refs)) {
+      res.code = 400;
+      res.write(
+          "Courses must be listed as courses=DEPT:NUMBER,... or in a JSON "
+          "body.");
+      res.end();
+      return;
+    }
+    if (refs.size() > kMaxBatchCourses) {
+      res.code = 413;
+      res.write("At most " + std::to_string(kMaxBatchCourses) +
+                " courses may be requested at once.");
+      res.end();
+      return;
+    }
+
+    std::vector<std::string> deptCodes;
+    deptCodes.reserve(refs.size());
+    for (const auto& ref : refs) deptCodes.push_back(ref.deptCode);
+    auto locks = myFileDatabase->acquireReadLocks(deptCodes);
+    ResponseCache& cache = myFileDatabase->getResponseCache();
+    ContentEncoding encoding = acceptedEncoding(req);
+    res.set_header("Vary", "Accept, Accept-Encoding");
+
+    if (acceptsJson(req)) {
+      res.code = 200;
+      res.set_header("Content-Type", "application/json");
+      JsonWriter writer(&res.body);
+      writer.beginObject().key("courses").beginArray();
+      for (const auto& ref : refs) {
+        writer.beginObject().key("deptCode").value(ref.deptCode);
+        writer.key("courseCode").value(ref.courseNumber);
+        const Department* department =
+            myFileDatabase->findDepartment(ref.deptCode);
+        const Course* course =
+            department ? department->findCourse(ref.courseNumber) : nullptr;
+        if (course == nullptr) {
+          writer.key("error").value(department ? "Course Not Found"
+                                               : "Department Not Found");
+        } else {
+          course->writeJsonFields(writer);
+          writer.key("full").value(course->isCourseFull());
+        }
+        writer.endObject();
+      }
+      writer.endArray().endObject();
+      compressBody(res, encoding);
+      res.end();
+      return;
+    }
+
+    std::string result;
+    for (const auto& ref : refs) {
+      result += ref.deptCode + " " + std::to_string(ref.courseNumber) + ": ";
+      const Department* department =
+          myFileDatabase->findDepartment(ref.deptCode);
+      const Course* course =
+          department ? department->findCourse(ref.courseNumber) : nullptr;
+      if (course == nullptr) {
+        result += department ? "Course Not Found\n" : "Department Not Found\n";
+        continue;
+      }
+      ResponseCache::Body body = cache.findCourse(ref.deptCode,
+                                                  ref.courseNumber);
+      if (!body) {
+        body = cache.storeCourse(ref.deptCode, ref.courseNumber,
+                                 course->display());
+      }
+      result += *body;
+      result += course->isCourseFull() ? "\nFull: true\n" : "\nFull: false\n";
+    }
+    res.code = 200;
+    res.write(result);
+    compressBody(res, encoding);
+    res.end();
+  } catch (const std::exception& e) {
+    res = handleException(e);
+  }
+}
+
+// How long a replaced catalog export is kept for responses still sending it
+const std::chrono::minutes kRetiredExportLifetime(1);
+
+// Creates a directory of its own for this process's catalog exports in the
+// system's temporary directory, where a killed process's files are cleaned
+// up with the rest.
+std::string makeExportDirectory() {
+  const char* base = std::getenv("TMPDIR");
+  std::string pattern =
+      std::string(base != nullptr && *base != '\0' ? base : "/tmp") +
+      "/catalog-export-XXXXXX";
+  std::vector<char> name(pattern.begin(), pattern.end());
+  name.push_back('\0');
+  if (::mkdtemp(name.data()) == nullptr) {
+    throw std::runtime_error("Could not create " + pattern);
+  }
+  return name.data();
+}
+
+// Gets the tag of the catalog export in the given format and coding.
+std::string catalogExportTag(const MyFileDatabase& database, bool json,
+                             ContentEncoding encoding) {
+  std::string tag = database.getResponseCache().getCatalogTag();
+  if (json) tag = jsonTag(tag);
+  return encodedTag(tag, encoding);
+}
+
+/**
+ * Exports the whole catalog, every department as /retrieveDept renders it,
+ * from a single snapshot. A request whose tag is current is answered before
+ * any lock is taken. Otherwise every department is locked for reading only
+ * while the snapshot is taken, which shares the blocks the last checkpoint
+ * kept and copies only the departments changed since, so both the time
+ * writers wait and the snapshot's memory grow with the changes rather than
+ * the catalog, up to a full copy before the first checkpoint. The snapshot
+ * is then rendered, compressed and written to a file one department at a
+ * time, holding only the lock of the requested format and coding, and the
+ * file is sent in fixed-size chunks as it is read, so no step holds the
+ * rendered catalog in memory. The file is reused until the catalog changes.
+ *
+ * @return A crow::response streaming the catalog as text, or as JSON,
+ * {"departments":[...]}, if Accept prefers application/json, with an HTTP
+ * 200 response. The export's ETag changes with any department's, and a
+ * request whose If-None-Match lists it gets an empty HTTP 304 instead. If
+ * Accept-Encoding allows, the export is compressed as it is written.
+ */
+void RouteController::exportCatalog(const crow::request& req,
+                                    crow::response& res) {
+  try {
+    bool json = acceptsJson(req);
+    ContentEncoding encoding = acceptedEncoding(req);
+    res.set_header("Vary", "Accept, Accept-Encoding");
+    std::string tag = catalogExportTag(*myFileDatabase, json, encoding);
+    if (matchesEntityTag(req, tag)) {
+      res.set_header("ETag", tag);
+      res.code = 304;
+      res.end();
+      return;
+    }
+
+    CatalogExport& current = catalogExports[(json ? kContentEncodings : 0) +
+                                            static_cast<size_t>(encoding)];
+    std::string path;
+    {
+      std::lock_guard<std::mutex> exportLock(current.mutex);
+      if (current.tag != tag) {
+        MyFileDatabase::CatalogSnapshot snapshot;
+        {
+          auto locks = myFileDatabase->acquireAllReadLocks();
+          tag = catalogExportTag(*myFileDatabase, json, encoding);
+          if (current.tag != tag) snapshot = myFileDatabase->snapshotCatalog();
+        }
+        if (current.tag != tag) {
+          writeCatalogExport(current, tag, snapshot, json, encoding);
+        }
       }
+      tag = current.tag;
+      path = current.path;
+    }
+    res.set_header("ETag", tag);
+    res.set_static_file_info_unsafe(path);
+    res.set_header("Content-Type", json ? "application/json" : "text/plain");
+    if (encoding != ContentEncoding::Identity) {
+      res.set_header("Content-Encoding", contentEncodingName(encoding));
     }
     res.end();
   } catch (const std::exception& e) {
@@ -120,6 +745,62 @@ void RouteController::retrieveCourse(const crow::request& req,
   }
 }
 
+/**
+ * Writes a catalog snapshot to a new export file and makes it the current
+ * one of its format and coding, retiring the file it replaces. The caller
+ * must hold the export's mutex.
+ *
+ * @param current  the export to replace
+ * @param tag      the ETag of the snapshot in this format and coding
+ * @param snapshot the catalog returned by MyFileDatabase::snapshotCatalog()
+ * @param json     whether to write JSON instead of text
+ * @param encoding the content coding to compress the file with
+ */
+void RouteController::writeCatalogExport(
+    CatalogExport& current, const std::string& tag,
+    const MyFileDatabase::CatalogSnapshot& snapshot, bool json,
+    ContentEncoding encoding) {
+  std::string directory;
+  {
+    std::lock_guard<std::mutex> filesLock(exportFilesMutex);
+    if (exportDirectory.empty()) exportDirectory = makeExportDirectory();
+    directory = exportDirectory;
+  }
+  std::string path = directory + "/catalog-" + tag.substr(1, tag.size() - 2) +
+                     (json ? ".json" : ".txt");
+  std::string temporaryPath = path + ".tmp";
+  std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+  if (encoding == ContentEncoding::Identity) {
+    MyFileDatabase::writeCatalog(out, snapshot, json);
+  } else {
+    CompressingStreamBuf compressor(out.rdbuf(), encoding);
+    std::ostream compressed(&compressor);
+    MyFileDatabase::writeCatalog(compressed, snapshot, json);
+    if (!compressed || !compressor.finish()) {
+      out.setstate(std::ios::badbit);
+    }
+  }
+  out.close();
+  if (!out || std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+    std::remove(temporaryPath.c_str());
+    throw std::runtime_error("Could not write " + path);
+  }
+
+  std::lock_guard<std::mutex> filesLock(exportFilesMutex);
+  auto now = std::chrono::steady_clock::now();
+  for (auto it = retiredExports.begin(); it != retiredExports.end();) {
+    if (now - it->second < kRetiredExportLifetime) {
+      ++it;
+      continue;
+    }
+    std::remove(it->first.c_str());
+    it = retiredExports.erase(it);
+  }
+  if (!current.path.empty()) retiredExports[current.path] = now;
+  current.path = path;
+  current.tag = tag;
+}
+
 /**
  * Displays whether the course has at minimum reached its enrollmentCapacity.
  *
@@ -148,21 +829,19 @@ void RouteController::isCourseFull(const crow::request& req,
     auto deptCode = req.url_params.get("deptCode");
     auto courseCode = std::stoi(req.url_params.get("courseCode"));
 
-    auto departmentMapping = myFileDatabase->getDepartmentMapping();
-    auto deptIt = departmentMapping.find(deptCode);
+    auto lock = myFileDatabase->acquireReadLock(deptCode);
+    const Department* department = myFileDatabase->findDepartment(deptCode);
 
-    if (deptIt == departmentMapping.end()) {
+    if (department == nullptr) {
       res.code = 404;
       res.write("Department Not Found");
     } else {
-      auto coursesMapping = deptIt->second.getCourseSelection();
-      auto courseIt = coursesMapping.find(std::to_string(courseCode));
+      const Course* course = department->findCourse(courseCode);
 
-      if (courseIt == coursesMapping.end()) {
+      if (course == nullptr) {
         res.code = 404;
         res.write("Course Not Found");
       } else {
-        auto course = courseIt->second;
         res.code = 200;
         res.write(course->isCourseFull()
                       ? "true"
@@ -175,6 +854,113 @@ void RouteController::isCourseFull(const crow::request& req,
   }
 }
 
+/**
+ * Displays whether a student is on the roster of the specified course.
+ *
+ * @param deptCode   A {@code String} representing the department the user
+ * wishes to find the course in.
+ *
+ * @param courseCode A {@code int} representing the course the user wishes
+ *                   to check.
+ *
+ * @param studentId  A {@code int} with the student's ID.
+ *
+ * @return           A crow::response object containing either "true" or
+ * "false" and an HTTP 200 response or, an appropriate message indicating the
+ * proper response.
+ */
+void RouteController::isStudentEnrolled(const crow::request& req,
+                                        crow::response& res) {
+  try {
+    if (!req.url_params.get("deptCode") || !req.url_params.get("courseCode") ||
+        !req.url_params.get("studentId")) {
+      res.code = 400;
+      res.write(
+          "Department code, course code and student ID must be included in "
+          "the request.");
+      res.end();
+      return;
+    }
+
+    auto deptCode = req.url_params.get("deptCode");
+    auto courseCode = std::stoi(req.url_params.get("courseCode"));
+    uint32_t studentId;
+    if (!Roster::parseStudentId(req.url_params.get("studentId"), &studentId)) {
+      res.code = 400;
+      res.write("Invalid student ID.");
+      res.end();
+      return;
+    }
+
+    auto lock = myFileDatabase->acquireReadLock(deptCode);
+    const Department* department = myFileDatabase->findDepartment(deptCode);
+
+    if (department == nullptr) {
+      res.code = 404;
+      res.write("Department Not Found");
+    } else {
+      const Course* course = department->findCourse(courseCode);
+
+      if (course == nullptr) {
+        res.code = 404;
+        res.write("Course Not Found");
+      } else {
+        res.code = 200;
+        res.write(course->isStudentEnrolled(studentId) ? "true" : "false");
+      }
+    }
+    res.end();
+  } catch (const std::exception& e) {
+    res = handleException(e);
+  }
+}
+
+/**
+ * Displays every course a student is enrolled in by ID, using the student
+ * index instead of searching every roster.
+ *
+ * @param studentId A {@code int} with the student's ID.
+ *
+ * @return          A crow::response object containing either the courses,
+ * one per line as e.g. "COMS 1004", and an HTTP 200 response or, an
+ * appropriate message indicating the proper response.
+ */
+void RouteController::retrieveStudentCourses(const crow::request& req,
+                                             crow::response& res) {
+  try {
+    if (!req.url_params.get("studentId")) {
+      res.code = 400;
+      res.write("Student ID must be included in the request.");
+      res.end();
+      return;
+    }
+
+    uint32_t studentId;
+    if (!Roster::parseStudentId(req.url_params.get("studentId"), &studentId)) {
+      res.code = 400;
+      res.write("Invalid student ID.");
+    } else {
+      auto courses = myFileDatabase->getStudentIndex().findCourses(studentId);
+      if (courses.empty()) {
+        res.code = 404;
+        res.write("Student Not Found");
+      } else {
+        std::string result;
+        for (const auto& course : courses) {
+          result +=
+              course.deptCode + " " + std::to_string(course.courseNumber) +
+              "\n";
+        }
+        res.code = 200;
+        res.write(result);
+      }
+    }
+    res.end();
+  } catch (const std::exception& e) {
+    res = handleException(e);
+  }
+}
+
 /**
  * Displays the number of majors in the specified department.
  *
@@ -196,16 +982,16 @@ void RouteController::getMajorCountFromDept(const crow::request& req,
     }
     auto deptCode = req.url_params.get("deptCode");
 
-    auto departmentMapping = myFileDatabase->getDepartmentMapping();
-    auto deptIt = departmentMapping.find(deptCode);
+    auto lock = myFileDatabase->acquireReadLock(deptCode);
+    const Department* department = myFileDatabase->findDepartment(deptCode);
 
-    if (deptIt == departmentMapping.end()) {
+    if (department == nullptr) {
       res.code = 404;
       res.write("Department Not Found");
     } else {
       res.code = 200;
       res.write(
-          "There are: " + std::to_string(deptIt->second.getNumberOfMajors()) +
+          "There are: " + std::to_string(department->getNumberOfMajors()) +
           " majors in the department");  // Use dot operator to call method
     }
     res.end();
@@ -235,16 +1021,16 @@ void RouteController::identifyDeptChair(const crow::request& req,
     }
     auto deptCode = req.url_params.get("deptCode");
 
-    auto departmentMapping = myFileDatabase->getDepartmentMapping();
-    auto deptIt = departmentMapping.find(deptCode);
+    auto lock = myFileDatabase->acquireReadLock(deptCode);
+    const Department* department = myFileDatabase->findDepartment(deptCode);
 
-    if (deptIt == departmentMapping.end()) {
+    if (department == nullptr) {
       res.code = 404;
       res.write("Department Not Found");
     } else {
       res.code = 200;
       res.write(
-          deptIt->second.getDepartmentChair() +
+          department->getDepartmentChair() +
           " is the department chair.");  // Use dot operator to call method
     }
     res.end();
@@ -281,21 +1067,19 @@ void RouteController::findCourseLocation(const crow::request& req,
     auto deptCode = req.url_params.get("deptCode");
     auto courseCode = std::stoi(req.url_params.get("courseCode"));
 
-    auto departmentMapping = myFileDatabase->getDepartmentMapping();
-    auto deptIt = departmentMapping.find(deptCode);
+    auto lock = myFileDatabase->acquireReadLock(deptCode);
+    const Department* department = myFileDatabase->findDepartment(deptCode);
 
-    if (deptIt == departmentMapping.end()) {
+    if (department == nullptr) {
       res.code = 404;
       res.write("Department Not Found");
     } else {
-      auto coursesMapping = deptIt->second.getCourseSelection();
-      auto courseIt = coursesMapping.find(std::to_string(courseCode));
+      const Course* course = department->findCourse(courseCode);
 
-      if (courseIt == coursesMapping.end()) {
+      if (course == nullptr) {
         res.code = 404;
         res.write("Course Not Found");
       } else {
-        auto course = courseIt->second;
         res.code = 200;
         res.write(course->getCourseLocation() +
                   " is where the course is located.");  // Use dot operator to
@@ -336,21 +1120,19 @@ void RouteController::findCourseInstructor(const crow::request& req,
     auto deptCode = req.url_params.get("deptCode");
     auto courseCode = std::stoi(req.url_params.get("courseCode"));
 
-    auto departmentMapping = myFileDatabase->getDepartmentMapping();
-    auto deptIt = departmentMapping.find(deptCode);
+    auto lock = myFileDatabase->acquireReadLock(deptCode);
+    const Department* department = myFileDatabase->findDepartment(deptCode);
 
-    if (deptIt == departmentMapping.end()) {
+    if (department == nullptr) {
       res.code = 404;
       res.write("Department Not Found");
     } else {
-      auto coursesMapping = deptIt->second.getCourseSelection();
-      auto courseIt = coursesMapping.find(std::to_string(courseCode));
+      const Course* course = department->findCourse(courseCode);
 
-      if (courseIt == coursesMapping.end()) {
+      if (course == nullptr) {
         res.code = 404;
         res.write("Course Not Found");
       } else {
-        auto course = courseIt->second;
         res.code = 200;
         res.write(course->getInstructorName() +
                   " is the instructor for the course.");  // Use dot operator to
@@ -391,21 +1173,19 @@ void RouteController::findCourseTime(const crow::request& req,
     auto deptCode = req.url_params.get("deptCode");
     auto courseCode = std::stoi(req.url_params.get("courseCode"));
 
-    auto departmentMapping = myFileDatabase->getDepartmentMapping();
-    auto deptIt = departmentMapping.find(deptCode);
+    auto lock = myFileDatabase->acquireReadLock(deptCode);
+    const Department* department = myFileDatabase->findDepartment(deptCode);
 
-    if (deptIt == departmentMapping.end()) {
+    if (department == nullptr) {
       res.code = 404;
       res.write("Department Not Found");
     } else {
-      auto coursesMapping = deptIt->second.getCourseSelection();
-      auto courseIt = coursesMapping.find(std::to_string(courseCode));
+      const Course* course = department->findCourse(courseCode);
 
-      if (courseIt == coursesMapping.end()) {
+      if (course == nullptr) {
         res.code = 404;
         res.write("Course Not Found");
       } else {
-        auto course = courseIt->second;
         res.code = 200;
         res.write("The course meets at: " + course->getCourseTimeSlot());
       }
@@ -417,36 +1197,43 @@ void RouteController::findCourseTime(const crow::request& req,
 }
 
 /**
- * Attempts to add a student to the specified department.
+ * Displays every course in session at the given time, optionally only on
+ * the given days, using the time slot index instead of scanning the catalog.
  *
- * @param deptCode       A {@code String} representing the department.
+ * @param time A {@code String} with the time of day, e.g. "11:45".
  *
- * @return               A crow::response object containing an HTTP 200
- *                       response with an appropriate message or the proper
- * status code in tune with what has happened.
+ * @param day  An optional {@code String} of day letters, e.g. "MW".
+ *
+ * @return     A crow::response object containing either the matching courses
+ * and an HTTP 200 response or, an appropriate message indicating the proper
+ * response.
  */
-void RouteController::addMajorToDept(const crow::request& req,
-                                     crow::response& res) {
+void RouteController::findCoursesMeetingAt(const crow::request& req,
+                                           crow::response& res) {
   try {
-    if (!req.url_params.get("deptCode")) {
+    if (!req.url_params.get("time")) {
       res.code = 400;
-      res.write("Department code must be included in the request.");
+      res.write("Time must be included in the request.");
       res.end();
       return;
     }
 
-    auto deptCode = req.url_params.get("deptCode");
-
-    auto departmentMapping = myFileDatabase->getDepartmentMapping();
-    auto deptIt = departmentMapping.find(deptCode);
-
-    if (deptIt == departmentMapping.end()) {
-      res.code = 404;
-      res.write("Department Not Found");
+    std::string time = req.url_params.get("time");
+    int minute;
+    uint8_t days = TimeSlot::kEveryDay;
+    if (!TimeSlot::parseTime(time, &minute)) {
+      res.code = 400;
+      res.write("Invalid time.");
+    } else if (req.url_params.get("day") &&
+               !TimeSlot::parseDays(req.url_params.get("day"), &days)) {
+      res.code = 400;
+      res.write("Invalid day.");
     } else {
-      deptIt->second.addPersonToMajor();  // Use dot operator to call method
+      auto courses =
+          myFileDatabase->getTimeSlotIndex().findMeetingAt(minute, days);
       res.code = 200;
-      res.write("Attribute was updated successfully");
+      res.write(courses.empty() ? "No courses meet at " + time
+                                : listScheduledCourses(courses));
     }
     res.end();
   } catch (const std::exception& e) {
@@ -454,14 +1241,296 @@ void RouteController::addMajorToDept(const crow::request& req,
   }
 }
 
-// Set Enrollment Count
-void RouteController::setEnrollmentCount(const crow::request& req,
-                                         crow::response& res) {
-  try {
-    if (!req.url_params.get("deptCode") || !req.url_params.get("courseCode") ||
-        !req.url_params.get("count")) {
-      res.code = 400;
-      res.write(
+/**
+ * Displays every other course in session at the same time as the specified
+ * course.
+ *
+ * @param deptCode   A {@code String} representing the department the user
+ * wishes to find the course in.
+ *
+ * @param courseCode A {@code int} representing the course the user wishes
+ *                   to find conflicts for.
+ *
+ * @return           A crow::response object containing either the conflicting
+ * courses and an HTTP 200 response or, an appropriate message indicating the
+ *                   proper response.
+ */
+void RouteController::findCourseConflicts(const crow::request& req,
+                                          crow::response& res) {
+  try {
+    if (!req.url_params.get("deptCode") || !req.url_params.get("courseCode")) {
+      res.code = 400;
+      res.write(
+          "Both department code and course code must be included in the "
+          "request.");
+      res.end();
+      return;
+    }
+
+    std::string deptCode = req.url_params.get("deptCode");
+    auto courseCode = std::stoi(req.url_params.get("courseCode"));
+
+    TimeSlot slot;
+    {
+      auto lock = myFileDatabase->acquireReadLock(deptCode);
+      const Department* department = myFileDatabase->findDepartment(deptCode);
+      const Course* course =
+          department == nullptr ? nullptr : department->findCourse(courseCode);
+      if (course == nullptr) {
+        res.code = 404;
+        res.write(department == nullptr ? "Department Not Found"
+                                        : "Course Not Found");
+        res.end();
+        return;
+      }
+      slot = course->getTimeSlot();
+    }
+
+    auto overlapping = myFileDatabase->getTimeSlotIndex().findOverlapping(slot);
+    std::vector<ScheduledCourse> conflicts;
+    for (auto& other : overlapping) {
+      if (other.deptCode != deptCode || other.courseNumber != courseCode) {
+        conflicts.push_back(std::move(other));
+      }
+    }
+    res.code = 200;
+    if (!slot.isValid()) {
+      res.write("The course does not have a valid time slot.");
+    } else if (conflicts.empty()) {
+      res.write("No conflicts found.");
+    } else {
+      res.write(listScheduledCourses(conflicts));
+    }
+    res.end();
+  } catch (const std::exception& e) {
+    res = handleException(e);
+  }
+}
+
+/**
+ * Displays the courses booked in the same room at overlapping times, for one
+ * room or for every room, using the room index instead of scanning the
+ * catalog.
+ *
+ * @param location An optional {@code String} with the room, e.g. "310 FAY".
+ *
+ * @return         A crow::response object containing the conflicts and an
+ * HTTP 200 response, or an appropriate message indicating the proper response.
+ */
+void RouteController::findRoomConflicts(const crow::request& req,
+                                        crow::response& res) {
+  try {
+    const RoomIndex& roomIndex = myFileDatabase->getRoomIndex();
+    const char* location = req.url_params.get("location");
+    std::vector<RoomConflict> conflicts =
+        location == nullptr ? roomIndex.findAllConflicts()
+                            : roomIndex.findConflicts(location);
+
+    res.code = 200;
+    if (conflicts.empty()) {
+      res.write("No room conflicts found.");
+    }
+    for (const auto& conflict : conflicts) {
+      res.write(conflict.location + ": " + conflict.first.deptCode + " " +
+                std::to_string(conflict.first.courseNumber) + " (" +
+                conflict.first.timeSlot.str() + ") overlaps " +
+                conflict.second.deptCode + " " +
+                std::to_string(conflict.second.courseNumber) + " (" +
+                conflict.second.timeSlot.str() + ")\n");
+    }
+    res.end();
+  } catch (const std::exception& e) {
+    res = handleException(e);
+  }
+}
+
+/**
+ * Displays every course taught by an instructor, using the instructor index
+ * instead of scanning the catalog.
+ *
+ * @param instructor A {@code String} with the instructor's name, e.g.
+ *                   "Adam Cannon".
+ *
+ * @return           A crow::response object containing either the courses,
+ * one per line as e.g. "COMS 1004", and an HTTP 200 response or, an
+ * appropriate message indicating the proper response.
+ */
+void RouteController::coursesByInstructor(const crow::request& req,
+                                          crow::response& res) {
+  try {
+    if (!req.url_params.get("instructor")) {
+      res.code = 400;
+      res.write("Instructor must be included in the request.");
+      res.end();
+      return;
+    }
+
+    auto courses = myFileDatabase->getInstructorIndex().findCourses(
+        req.url_params.get("instructor"));
+    if (courses.empty()) {
+      res.code = 404;
+      res.write("Instructor Not Found");
+    } else {
+      std::string result;
+      for (const auto& course : courses) {
+        result +=
+            course.deptCode + " " + std::to_string(course.courseNumber) + "\n";
+      }
+      res.code = 200;
+      res.write(result);
+    }
+    res.end();
+  } catch (const std::exception& e) {
+    res = handleException(e);
+  }
+}
+
+/**
+ * Displays every course held in a location, using the room index instead
+ * of scanning the catalog.
+ *
+ * @param location A {@code String} with the room, e.g. "417 IAB".
+ *
+ * @return         A crow::response object containing either the courses,
+ * one per line by start time as e.g. "COMS 1004: 11:40-12:55", and an HTTP
+ * 200 response or, an appropriate message indicating the proper response.
+ */
+void RouteController::coursesByLocation(const crow::request& req,
+                                        crow::response& res) {
+  try {
+    if (!req.url_params.get("location")) {
+      res.code = 400;
+      res.write("Location must be included in the request.");
+      res.end();
+      return;
+    }
+
+    auto courses = myFileDatabase->getRoomIndex().findCourses(
+        req.url_params.get("location"));
+    if (courses.empty()) {
+      res.code = 404;
+      res.write("Location Not Found");
+    } else {
+      res.code = 200;
+      res.write(listScheduledCourses(courses));
+    }
+    res.end();
+  } catch (const std::exception& e) {
+    res = handleException(e);
+  }
+}
+
+/**
+ * Searches instructor names or course locations for a text that may be
+ * misspelled or only partly typed, for type-ahead, and lists the courses of
+ * each match.
+ *
+ * @param field A {@code String} naming what to search, "instructor" or
+ *              "location".
+ *
+ * @param q     A {@code String} with the text typed so far, e.g. "chorom".
+ *
+ * @param limit An optional {@code int} with the most matches to return,
+ *              from 1 to 100; 10 by default.
+ *
+ * @return      A crow::response object containing either the matches, best
+ * first and one per line as e.g. "Adam Cannon: COMS 1004", and an HTTP 200
+ * response or, an appropriate message indicating the proper response.
+ */
+void RouteController::search(const crow::request& req, crow::response& res) {
+  try {
+    if (!req.url_params.get("field") || !req.url_params.get("q")) {
+      res.code = 400;
+      res.write("Both field and q must be included in the request.");
+      res.end();
+      return;
+    }
+
+    std::string field = req.url_params.get("field");
+    int limit = req.url_params.get("limit")
+                    ? std::stoi(req.url_params.get("limit"))
+                    : 10;
+    if (field != "instructor" && field != "location") {
+      res.code = 400;
+      res.write("Field must be instructor or location.");
+    } else if (limit < 1 || limit > 100) {
+      res.code = 400;
+      res.write("Limit must be between 1 and 100.");
+    } else {
+      bool byInstructor = field == "instructor";
+      const SearchIndex& index = byInstructor
+                                     ? myFileDatabase->getInstructorSearch()
+                                     : myFileDatabase->getLocationSearch();
+      std::string result;
+      for (const auto& match :
+           index.search(req.url_params.get("q"), limit)) {
+        std::string courses =
+            byInstructor
+                ? joinCourses(myFileDatabase->getInstructorIndex().findCourses(
+                      match.value))
+                : joinCourses(
+                      myFileDatabase->getRoomIndex().findCourses(match.value));
+        result += match.value + ": " + courses + "\n";
+      }
+      if (result.empty()) {
+        res.code = 404;
+        res.write("No Matches Found");
+      } else {
+        res.code = 200;
+        res.write(result);
+      }
+    }
+    res.end();
+  } catch (const std::exception& e) {
+    res = handleException(e);
+  }
+}
+
+/**
+ * Attempts to add a student to the specified department.
+ *
+ * @param deptCode       A {@code String} representing the department.
+ *
+ * @return               A crow::response object containing an HTTP 200
+ *                       response with an appropriate message or the proper
+ * status code in tune with what has happened.
+ */
+void RouteController::addMajorToDept(const crow::request& req,
+                                     crow::response& res) {
+  try {
+    if (!req.url_params.get("deptCode")) {
+      res.code = 400;
+      res.write("Department code must be included in the request.");
+      res.end();
+      return;
+    }
+
+    auto deptCode = req.url_params.get("deptCode");
+
+    MutationStatus status = myFileDatabase->applyMutation(
+        {MutationType::AddMajor, deptCode, "", ""});
+
+    if (status == MutationStatus::Applied) {
+      res.code = 200;
+      res.write("Attribute was updated successfully");
+    } else {
+      res.code = 404;
+      res.write("Department Not Found");
+    }
+    res.end();
+  } catch (const std::exception& e) {
+    res = handleException(e);
+  }
+}
+
+// Set Enrollment Count
+void RouteController::setEnrollmentCount(const crow::request& req,
+                                         crow::response& res) {
+  try {
+    if (!req.url_params.get("deptCode") || !req.url_params.get("courseCode") ||
+        !req.url_params.get("count")) {
+      res.code = 400;
+      res.write(
           "Department code, course code and new count must ALL be included in "
           "the request.");
       res.end();
@@ -472,21 +1541,24 @@ void RouteController::setEnrollmentCount(const crow::request& req,
     auto courseCode = std::stoi(req.url_params.get("courseCode"));
     auto count = std::stoi(req.url_params.get("count"));
 
-    auto departmentMapping = myFileDatabase->getDepartmentMapping();
-    auto deptIt = departmentMapping.find(deptCode);
+    MutationStatus status = myFileDatabase->applyMutation(
+        {MutationType::SetEnrollmentCount, deptCode, std::to_string(courseCode),
+         std::to_string(count)});
 
-    if (deptIt != departmentMapping.end()) {
-      auto coursesMapping = deptIt->second.getCourseSelection();
-      auto courseIt = coursesMapping.find(std::to_string(courseCode));
-
-      if (courseIt != coursesMapping.end()) {
-        courseIt->second->setEnrolledStudentCount(count);
-        res.code = 200;
-        res.write("Attribute was updated successfully.");
-      } else {
-        res.code = 404;
-        res.write("Course Not Found");
-      }
+    if (status == MutationStatus::Applied) {
+      res.code = 200;
+      res.write("Attribute was updated successfully.");
+    } else if (status == MutationStatus::CourseNotFound) {
+      res.code = 404;
+      res.write("Course Not Found");
+    } else if (status == MutationStatus::Rejected && count < 0) {
+      res.code = 400;
+      res.write("Count cannot be negative.");
+    } else if (status == MutationStatus::Rejected) {
+      res.code = 409;
+      res.write(
+          "Count cannot be below the number of students enrolled by ID; drop "
+          "them instead.");
     } else {
       res.code = 404;
       res.write("Department Not Found");
@@ -515,21 +1587,19 @@ void RouteController::setCourseLocation(const crow::request& req,
     auto courseCode = std::stoi(req.url_params.get("courseCode"));
     auto location = req.url_params.get("location");
 
-    auto departmentMapping = myFileDatabase->getDepartmentMapping();
-    auto deptIt = departmentMapping.find(deptCode);
-
-    if (deptIt != departmentMapping.end()) {
-      auto coursesMapping = deptIt->second.getCourseSelection();
-      auto courseIt = coursesMapping.find(std::to_string(courseCode));
+    MutationStatus status = myFileDatabase->applyMutation(
+        {MutationType::ChangeLocation, deptCode, std::to_string(courseCode),
+         location, rejectsRoomConflicts(req)});
 
-      if (courseIt != coursesMapping.end()) {
-        courseIt->second->reassignLocation(location);
-        res.code = 200;
-        res.write("Attribute was updated successfully.");
-      } else {
-        res.code = 404;
-        res.write("Course Not Found");
-      }
+    if (status == MutationStatus::Applied) {
+      res.code = 200;
+      res.write("Attribute was updated successfully.");
+    } else if (status == MutationStatus::CourseNotFound) {
+      res.code = 404;
+      res.write("Course Not Found");
+    } else if (status == MutationStatus::RoomConflict) {
+      res.code = 409;
+      res.write("The room is already booked at that time.");
     } else {
       res.code = 404;
       res.write("Department Not Found");
@@ -559,21 +1629,16 @@ void RouteController::setCourseInstructor(const crow::request& req,
 
     int courseCode = std::stoi(courseCodeStr);
 
-    auto departmentMapping = myFileDatabase->getDepartmentMapping();
-    auto deptIt = departmentMapping.find(deptCode);
-
-    if (deptIt != departmentMapping.end()) {
-      auto coursesMapping = deptIt->second.getCourseSelection();
-      auto courseIt = coursesMapping.find(std::to_string(courseCode));
+    MutationStatus status = myFileDatabase->applyMutation(
+        {MutationType::ChangeInstructor, deptCode, std::to_string(courseCode),
+         instructor});
 
-      if (courseIt != coursesMapping.end()) {
-        courseIt->second->reassignInstructor(instructor);
-        res.code = 200;
-        res.write("Attribute was updated successfully.");
-      } else {
-        res.code = 404;
-        res.write("Course Not Found");
-      }
+    if (status == MutationStatus::Applied) {
+      res.code = 200;
+      res.write("Attribute was updated successfully.");
+    } else if (status == MutationStatus::CourseNotFound) {
+      res.code = 404;
+      res.write("Course Not Found");
     } else {
       res.code = 404;
       res.write("Department Not Found");
@@ -602,21 +1667,22 @@ void RouteController::setCourseTime(const crow::request& req,
     auto courseCode = std::stoi(req.url_params.get("courseCode"));
     auto time = req.url_params.get("time");
 
-    auto departmentMapping = myFileDatabase->getDepartmentMapping();
-    auto deptIt = departmentMapping.find(deptCode);
+    MutationStatus status = myFileDatabase->applyMutation(
+        {MutationType::ChangeTime, deptCode, std::to_string(courseCode),
+         time, rejectsRoomConflicts(req)});
 
-    if (deptIt != departmentMapping.end()) {
-      auto coursesMapping = deptIt->second.getCourseSelection();
-      auto courseIt = coursesMapping.find(std::to_string(courseCode));
-
-      if (courseIt != coursesMapping.end()) {
-        courseIt->second->reassignTime(time);
-        res.code = 200;
-        res.write("Attribute was updated successfully.");
-      } else {
-        res.code = 404;
-        res.write("Course Not Found");
-      }
+    if (status == MutationStatus::Applied) {
+      res.code = 200;
+      res.write("Attribute was updated successfully.");
+    } else if (status == MutationStatus::CourseNotFound) {
+      res.code = 404;
+      res.write("Course Not Found");
+    } else if (status == MutationStatus::Rejected) {
+      res.code = 400;
+      res.write("Invalid time slot.");
+    } else if (status == MutationStatus::RoomConflict) {
+      res.code = 409;
+      res.write("The room is already booked at that time.");
     } else {
       res.code = 404;
       res.write("Department Not Found");
@@ -647,16 +1713,15 @@ void RouteController::removeMajorFromDept(const crow::request& req,
     }
     auto deptCode = req.url_params.get("deptCode");
 
-    auto departmentMapping = myFileDatabase->getDepartmentMapping();
-    auto deptIt = departmentMapping.find(deptCode);
+    MutationStatus status = myFileDatabase->applyMutation(
+        {MutationType::RemoveMajor, deptCode, "", ""});
 
-    if (deptIt == departmentMapping.end()) {
-      res.code = 404;
-      res.write("Department Not Found");
-    } else {
-      deptIt->second.dropPersonFromMajor();
+    if (status == MutationStatus::Applied) {
       res.code = 200;
       res.write("Attribute was updated successfully");
+    } else {
+      res.code = 404;
+      res.write("Department Not Found");
     }
     res.end();
   } catch (const std::exception& e) {
@@ -665,13 +1730,18 @@ void RouteController::removeMajorFromDept(const crow::request& req,
 }
 
 /**
- * Attempts to remove a student from the specified department.
+ * Attempts to remove a student from the specified department. With a
+ * student ID, that student is removed from the course's roster; without
+ * one, the enrolled student count is decremented for a student enrolled
+ * without an ID.
  *
  * @param deptCode       A {@code String} representing the department.
  *
  * @param courseCode     A {@code int} representing the course the user wishes
  *                       to find information about.
  *
+ * @param studentId      An optional {@code int} with the student's ID.
+ *
  * @return               A crow::response object containing an HTTP 200
  *                       response with an appropriate message or the proper
  * status code in tune with what has happened.
@@ -691,27 +1761,259 @@ void RouteController::dropStudentFromCourse(const crow::request& req,
     auto deptCode = req.url_params.get("deptCode");
     auto courseCode = std::stoi(req.url_params.get("courseCode"));
 
-    auto departmentMapping = myFileDatabase->getDepartmentMapping();
-    auto deptIt = departmentMapping.find(deptCode);
+    Mutation mutation{MutationType::DropStudent, deptCode,
+                      std::to_string(courseCode), ""};
+    if (!readStudentId(req, MutationType::DropStudentById, &mutation)) {
+      res.code = 400;
+      res.write("Invalid student ID.");
+      res.end();
+      return;
+    }
+    MutationStatus status = myFileDatabase->applyMutation(mutation);
+
+    if (status == MutationStatus::Applied) {
+      res.code = 200;
+      res.write("Student has been dropped");
+    } else if (status == MutationStatus::NotEnrolled) {
+      res.code = 404;
+      res.write("Student is not enrolled in the course");
+    } else if (status == MutationStatus::Rejected) {
+      res.code = 400;
+      res.write("Student has not been dropped");
+    } else if (status == MutationStatus::CourseNotFound) {
+      res.code = 404;
+      res.write("Course Not Found");
+    } else {
+      res.code = 404;
+      res.write("Department Not Found");
+    }
+    res.end();
+  } catch (const std::exception& e) {
+    res = handleException(e);
+  }
+}
+
+/**
+ * Attempts to enroll a student in the specified course. Concurrent requests
+ * for the same course are admitted without locking and can never enroll
+ * more students than the course capacity. With a student ID, the student is
+ * also added to the course's roster, under the department's write lock.
+ *
+ * @param deptCode       A {@code String} representing the department.
+ *
+ * @param courseCode     A {@code int} representing the course the user wishes
+ *                       to enroll in.
+ *
+ * @param studentId      An optional {@code int} with the student's ID.
+ *
+ * @return               A crow::response object containing an HTTP 200
+ *                       response with an appropriate message or the proper
+ * status code in tune with what has happened.
+ */
+void RouteController::enrollStudentInCourse(const crow::request& req,
+                                            crow::response& res) {
+  try {
+    if (!req.url_params.get("deptCode") || !req.url_params.get("courseCode")) {
+      res.code = 400;
+      res.write(
+          "Both department code and course code must be included in the "
+          "request.");
+      res.end();
+      return;
+    }
+
+    auto deptCode = req.url_params.get("deptCode");
+    auto courseCode = std::stoi(req.url_params.get("courseCode"));
+
+    Mutation mutation{MutationType::EnrollStudent, deptCode,
+                      std::to_string(courseCode), ""};
+    if (!readStudentId(req, MutationType::EnrollStudentById, &mutation)) {
+      res.code = 400;
+      res.write("Invalid student ID.");
+      res.end();
+      return;
+    }
+    MutationStatus status = myFileDatabase->applyMutation(mutation);
+
+    if (status == MutationStatus::Applied) {
+      res.code = 200;
+      res.write("Student has been enrolled");
+    } else if (status == MutationStatus::AlreadyEnrolled) {
+      res.code = 409;
+      res.write("Student is already enrolled in the course");
+    } else if (status == MutationStatus::Rejected) {
+      res.code = 400;
+      res.write("Student has not been enrolled, the course is full");
+    } else if (status == MutationStatus::CourseNotFound) {
+      res.code = 404;
+      res.write("Course Not Found");
+    } else {
+      res.code = 404;
+      res.write("Department Not Found");
+    }
+    res.end();
+  } catch (const std::exception& e) {
+    res = handleException(e);
+  }
+}
+
+/**
+ * Puts a student on the waitlist of a full course. The student is enrolled
+ * as soon as a drop frees a seat, in the order students joined, so a client
+ * makes one request instead of retrying /enrollStudentInCourse.
+ *
+ * @param deptCode   A {@code String} representing the department.
+ *
+ * @param courseCode A {@code int} representing the course the user wishes
+ *                   to wait for.
+ *
+ * @param studentId  A {@code int} with the student's ID.
+ *
+ * @return           A crow::response object containing the student's
+ * position and an HTTP 200 response or, the proper status code in tune with
+ * what has happened.
+ */
+void RouteController::joinWaitlist(const crow::request& req,
+                                   crow::response& res) {
+  try {
+    uint32_t studentId;
+    if (!readWaitlistParams(req, res, &studentId)) return;
 
-    if (deptIt == departmentMapping.end()) {
+    auto deptCode = req.url_params.get("deptCode");
+    auto courseCode = std::stoi(req.url_params.get("courseCode"));
+
+    MutationStatus status = myFileDatabase->applyMutation(
+        {MutationType::JoinWaitlist, deptCode, std::to_string(courseCode),
+         std::to_string(studentId)});
+
+    if (status == MutationStatus::Applied) {
+      size_t position = 0;
+      {
+        auto lock = myFileDatabase->acquireReadLock(deptCode);
+        const Course* course =
+            myFileDatabase->findDepartment(deptCode)->findCourse(courseCode);
+        position = course->getWaitlistPosition(studentId);
+      }
+      res.code = 200;
+      // A drop may have promoted the student already
+      res.write(position == 0 ? "Student has been enrolled"
+                              : "Student is number " +
+                                    std::to_string(position) +
+                                    " on the waitlist");
+    } else if (status == MutationStatus::AlreadyEnrolled) {
+      res.code = 409;
+      res.write("Student is already enrolled in the course");
+    } else if (status == MutationStatus::AlreadyWaitlisted) {
+      res.code = 409;
+      res.write("Student is already on the waitlist");
+    } else if (status == MutationStatus::Rejected) {
+      res.code = 409;
+      res.write("The course is not full, enroll instead");
+    } else if (status == MutationStatus::CourseNotFound) {
+      res.code = 404;
+      res.write("Course Not Found");
+    } else {
       res.code = 404;
       res.write("Department Not Found");
+    }
+    res.end();
+  } catch (const std::exception& e) {
+    res = handleException(e);
+  }
+}
+
+/**
+ * Takes a student off a course's waitlist.
+ *
+ * @param deptCode   A {@code String} representing the department.
+ *
+ * @param courseCode A {@code int} representing the course.
+ *
+ * @param studentId  A {@code int} with the student's ID.
+ *
+ * @return           A crow::response object containing an HTTP 200 response
+ * with an appropriate message or the proper status code in tune with what
+ * has happened.
+ */
+void RouteController::leaveWaitlist(const crow::request& req,
+                                    crow::response& res) {
+  try {
+    uint32_t studentId;
+    if (!readWaitlistParams(req, res, &studentId)) return;
+
+    auto deptCode = req.url_params.get("deptCode");
+    auto courseCode = std::stoi(req.url_params.get("courseCode"));
+
+    MutationStatus status = myFileDatabase->applyMutation(
+        {MutationType::LeaveWaitlist, deptCode, std::to_string(courseCode),
+         std::to_string(studentId)});
+
+    if (status == MutationStatus::Applied) {
+      res.code = 200;
+      res.write("Student has left the waitlist");
+    } else if (status == MutationStatus::NotWaitlisted) {
+      res.code = 404;
+      res.write("Student is not on the waitlist");
+    } else if (status == MutationStatus::CourseNotFound) {
+      res.code = 404;
+      res.write("Course Not Found");
     } else {
-      auto coursesMapping = deptIt->second.getCourseSelection();
-      auto courseIt = coursesMapping.find(std::to_string(courseCode));
+      res.code = 404;
+      res.write("Department Not Found");
+    }
+    res.end();
+  } catch (const std::exception& e) {
+    res = handleException(e);
+  }
+}
 
-      if (courseIt == coursesMapping.end()) {
+/**
+ * Displays a student's place on a course's waitlist and the waitlist's
+ * length, e.g. "2 of 5".
+ *
+ * @param deptCode   A {@code String} representing the department.
+ *
+ * @param courseCode A {@code int} representing the course.
+ *
+ * @param studentId  A {@code int} with the student's ID.
+ *
+ * @return           A crow::response object containing either the position
+ * and an HTTP 200 response or, an appropriate message indicating the proper
+ * response.
+ */
+void RouteController::getWaitlistPosition(const crow::request& req,
+                                          crow::response& res) {
+  try {
+    uint32_t studentId;
+    if (!readWaitlistParams(req, res, &studentId)) return;
+
+    auto deptCode = req.url_params.get("deptCode");
+    auto courseCode = std::stoi(req.url_params.get("courseCode"));
+
+    auto lock = myFileDatabase->acquireReadLock(deptCode);
+    const Department* department = myFileDatabase->findDepartment(deptCode);
+
+    if (department == nullptr) {
+      res.code = 404;
+      res.write("Department Not Found");
+    } else {
+      const Course* course = department->findCourse(courseCode);
+
+      if (course == nullptr) {
         res.code = 404;
         res.write("Course Not Found");
+      } else if (course->isStudentEnrolled(studentId)) {
+        res.code = 200;
+        res.write("Student is enrolled");
       } else {
-        bool isStudentDropped = courseIt->second->dropStudent();
-        if (isStudentDropped) {
-          res.code = 200;
-          res.write("Student has been dropped");
+        size_t position = course->getWaitlistPosition(studentId);
+        if (position == 0) {
+          res.code = 404;
+          res.write("Student is not on the waitlist");
         } else {
-          res.code = 400;
-          res.write("Student has not been dropped");
+          res.code = 200;
+          res.write(std::to_string(position) + " of " +
+                    std::to_string(course->getWaitlist().size()));
         }
       }
     }
@@ -721,94 +2023,418 @@ void RouteController::dropStudentFromCourse(const crow::request& req,
   }
 }
 
+/**
+ * Applies a list of changes as one transaction: either all of them are
+ * made, durably and with one write-ahead log record, or none is. The body
+ * is JSON such as {"operations": [{"op": "changeCourseLocation",
+ * "deptCode": "COMS", "courseCode": 1004, "location": "417 IAB"}]}, where
+ * "op" names the route whose work the operation does and the remaining
+ * fields are that route's parameters; "rejectConflicts": true may be added
+ * to location and time changes, and "studentId" to enrollments and drops.
+ * "joinWaitlist" and "leaveWaitlist" take "studentId".
+ *
+ * @return A crow::response object listing the outcome of each operation as
+ * "index: outcome", with an HTTP 200 response if all were applied, or the
+ * status code of the first operation that failed, in which case every other
+ * operation is "Not applied"; or an HTTP 400 response if the body is
+ * malformed, or 413 if it holds more than 1000 operations.
+ */
+void RouteController::batchUpdate(const crow::request& req,
+                                  crow::response& res) {
+  try {
+    std::vector<Mutation> mutations;
+    std::string error;
+    try {
+      crow::json::rvalue body = crow::json::load(req.body);
+      if (!body || !body.has("operations")) {
+        error =
+            "Operations must be given as a JSON body {\"operations\": [...]}.";
+      } else {
+        for (const auto& item : body["operations"]) {
+          Mutation mutation;
+          if (!parseBatchOperation(item, &mutation)) {
+            error = "Operation " + std::to_string(mutations.size()) +
+                    " is malformed.";
+            break;
+          }
+          mutations.push_back(std::move(mutation));
+        }
+        if (error.empty() && mutations.empty()) {
+          error = "At least one operation must be given.";
+        }
+      }
+    } catch (const std::exception&) {
+      // Crow throws when a field is missing or has the wrong type
+      error =
+          "Operation " + std::to_string(mutations.size()) + " is malformed.";
+    }
+    if (!error.empty()) {
+      res.code = 400;
+      res.write(error);
+      res.end();
+      return;
+    }
+    if (mutations.size() > kMaxBatchOperations) {
+      res.code = 413;
+      res.write("At most " + std::to_string(kMaxBatchOperations) +
+                " operations may be applied at once.");
+      res.end();
+      return;
+    }
+
+    std::vector<MutationStatus> statuses;
+    bool applied = myFileDatabase->applyMutations(mutations, &statuses);
+    res.code = 200;
+    std::string result;
+    for (size_t i = 0; i < statuses.size(); ++i) {
+      result += std::to_string(i) + ": " + describeStatus(statuses[i]) + "\n";
+      if (applied) continue;
+      if (statuses[i] == MutationStatus::Rejected) {
+        res.code = 400;
+      } else if (statuses[i] == MutationStatus::RoomConflict ||
+                 statuses[i] == MutationStatus::AlreadyEnrolled ||
+                 statuses[i] == MutationStatus::AlreadyWaitlisted) {
+        res.code = 409;
+      } else if (statuses[i] != MutationStatus::Aborted) {
+        res.code = 404;
+      }
+    }
+    res.write(result);
+    res.end();
+  } catch (const std::exception& e) {
+    res = handleException(e);
+  }
+}
+
+/**
+ * Reports request counts and latencies for every route and the size and
+ * checkpoint state of the database, in the Prometheus text format.
+ *
+ * @return A crow::response with the metrics and an HTTP 200 response.
+ */
+void RouteController::exportMetrics(crow::response& res) {
+  std::string body = metrics.render();
+  if (myFileDatabase) {
+    body +=
+        "# HELP catalog_departments Departments in the catalog.\n"
+        "# TYPE catalog_departments gauge\n"
+        "catalog_departments " +
+        std::to_string(myFileDatabase->getDepartmentCount()) +
+        "\n"
+        "# HELP catalog_courses Courses in the catalog.\n"
+        "# TYPE catalog_courses gauge\n"
+        "catalog_courses " +
+        std::to_string(myFileDatabase->getCourseCount()) +
+        "\n"
+        "# HELP catalog_unsaved_changes Whether changes await a checkpoint.\n"
+        "# TYPE catalog_unsaved_changes gauge\n"
+        "catalog_unsaved_changes " +
+        (myFileDatabase->hasUnsavedChanges() ? "1" : "0") +
+        "\n"
+        "# HELP catalog_checkpoints_total Checkpoints written since startup.\n"
+        "# TYPE catalog_checkpoints_total counter\n"
+        "catalog_checkpoints_total " +
+        std::to_string(myFileDatabase->getCheckpointCount()) +
+        "\n"
+        "# HELP catalog_last_checkpoint_duration_seconds Time taken by the "
+        "last checkpoint.\n"
+        "# TYPE catalog_last_checkpoint_duration_seconds gauge\n"
+        "catalog_last_checkpoint_duration_seconds " +
+        std::to_string(
+            myFileDatabase->getLastCheckpointDuration().count() / 1e6) +
+        "\n";
+    const ResponseCache& cache = myFileDatabase->getResponseCache();
+    body +=
+        "# HELP response_cache_hits_total Department and course bodies served "
+        "from the cache.\n"
+        "# TYPE response_cache_hits_total counter\n"
+        "response_cache_hits_total " +
+        std::to_string(cache.getHitCount()) +
+        "\n"
+        "# HELP response_cache_misses_total Department and course bodies not "
+        "found in the cache.\n"
+        "# TYPE response_cache_misses_total counter\n"
+        "response_cache_misses_total " +
+        std::to_string(cache.getMissCount()) +
+        "\n"
+        "# HELP response_cache_entries Bodies held in the cache.\n"
+        "# TYPE response_cache_entries gauge\n"
+        "response_cache_entries " +
+        std::to_string(cache.size()) + "\n";
+  }
+  res.set_header("Content-Type", "text/plain; version=0.0.4");
+  res.write(body);
+  res.end();
+}
+
 // Initialize API Routes
 void RouteController::initRoutes(crow::App<>& app) {
   CROW_ROUTE(app, "/").methods(crow::HTTPMethod::GET)(
-      [this](const crow::request& req, crow::response& res) { index(res); });
+      [this, route = metrics.addRoute("/")](const crow::request&,
+                                            crow::response& res) {
+        Metrics::Timer timer(&metrics, route, &res.code);
+        index(res);
+      });
+
+  CROW_ROUTE(app, "/metrics")
+      .methods(crow::HTTPMethod::GET)(
+          [this, route = metrics.addRoute("/metrics")](
+              const crow::request&, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
+            exportMetrics(res);
+          });
 
   CROW_ROUTE(app, "/retrieveDept")
       .methods(crow::HTTPMethod::GET)(
-          [this](const crow::request& req, crow::response& res) {
+          [this, route = metrics.addRoute("/retrieveDept")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
             retrieveDepartment(req, res);
           });
 
   CROW_ROUTE(app, "/retrieveCourse")
       .methods(crow::HTTPMethod::GET)(
-          [this](const crow::request& req, crow::response& res) {
+          [this, route = metrics.addRoute("/retrieveCourse")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
             retrieveCourse(req, res);
           });
 
+  CROW_ROUTE(app, "/retrieveCourses")
+      .methods(crow::HTTPMethod::GET, crow::HTTPMethod::POST)(
+          [this, route = metrics.addRoute("/retrieveCourses")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
+            retrieveCourses(req, res);
+          });
+
+  CROW_ROUTE(app, "/catalog")
+      .methods(crow::HTTPMethod::GET)(
+          [this, route = metrics.addRoute("/catalog")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
+            exportCatalog(req, res);
+          });
+
   CROW_ROUTE(app, "/isCourseFull")
       .methods(crow::HTTPMethod::GET)(
-          [this](const crow::request& req, crow::response& res) {
+          [this, route = metrics.addRoute("/isCourseFull")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
             isCourseFull(req, res);
           });
 
+  CROW_ROUTE(app, "/isStudentEnrolled")
+      .methods(crow::HTTPMethod::GET)(
+          [this, route = metrics.addRoute("/isStudentEnrolled")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
+            isStudentEnrolled(req, res);
+          });
+
+  CROW_ROUTE(app, "/retrieveStudentCourses")
+      .methods(crow::HTTPMethod::GET)(
+          [this, route = metrics.addRoute("/retrieveStudentCourses")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
+            retrieveStudentCourses(req, res);
+          });
+
   CROW_ROUTE(app, "/getMajorCountFromDept")
       .methods(crow::HTTPMethod::GET)(
-          [this](const crow::request& req, crow::response& res) {
+          [this, route = metrics.addRoute("/getMajorCountFromDept")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
             getMajorCountFromDept(req, res);
           });
 
   CROW_ROUTE(app, "/idDeptChair")
       .methods(crow::HTTPMethod::GET)(
-          [this](const crow::request& req, crow::response& res) {
+          [this, route = metrics.addRoute("/idDeptChair")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
             identifyDeptChair(req, res);
           });
 
   CROW_ROUTE(app, "/findCourseLocation")
       .methods(crow::HTTPMethod::GET)(
-          [this](const crow::request& req, crow::response& res) {
+          [this, route = metrics.addRoute("/findCourseLocation")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
             findCourseLocation(req, res);
           });
 
   CROW_ROUTE(app, "/findCourseInstructor")
       .methods(crow::HTTPMethod::GET)(
-          [this](const crow::request& req, crow::response& res) {
+          [this, route = metrics.addRoute("/findCourseInstructor")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
             findCourseInstructor(req, res);
           });
 
   CROW_ROUTE(app, "/findCourseTime")
       .methods(crow::HTTPMethod::GET)(
-          [this](const crow::request& req, crow::response& res) {
+          [this, route = metrics.addRoute("/findCourseTime")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
             findCourseTime(req, res);
           });
 
+  CROW_ROUTE(app, "/findCoursesMeetingAt")
+      .methods(crow::HTTPMethod::GET)(
+          [this, route = metrics.addRoute("/findCoursesMeetingAt")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
+            findCoursesMeetingAt(req, res);
+          });
+
+  CROW_ROUTE(app, "/findCourseConflicts")
+      .methods(crow::HTTPMethod::GET)(
+          [this, route = metrics.addRoute("/findCourseConflicts")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
+            findCourseConflicts(req, res);
+          });
+
+  CROW_ROUTE(app, "/findRoomConflicts")
+      .methods(crow::HTTPMethod::GET)(
+          [this, route = metrics.addRoute("/findRoomConflicts")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
+            findRoomConflicts(req, res);
+          });
+
+  CROW_ROUTE(app, "/coursesByInstructor")
+      .methods(crow::HTTPMethod::GET)(
+          [this, route = metrics.addRoute("/coursesByInstructor")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
+            coursesByInstructor(req, res);
+          });
+
+  CROW_ROUTE(app, "/coursesByLocation")
+      .methods(crow::HTTPMethod::GET)(
+          [this, route = metrics.addRoute("/coursesByLocation")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
+            coursesByLocation(req, res);
+          });
+
+  CROW_ROUTE(app, "/search")
+      .methods(crow::HTTPMethod::GET)(
+          [this, route = metrics.addRoute("/search")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
+            search(req, res);
+          });
+
   CROW_ROUTE(app, "/addMajorToDept")
       .methods(crow::HTTPMethod::GET)(
-          [this](const crow::request& req, crow::response& res) {
+          [this, route = metrics.addRoute("/addMajorToDept")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
             addMajorToDept(req, res);
           });
 
   CROW_ROUTE(app, "/removeMajorFromDept")
       .methods(crow::HTTPMethod::GET)(
-          [this](const crow::request& req, crow::response& res) {
+          [this, route = metrics.addRoute("/removeMajorFromDept")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
             removeMajorFromDept(req, res);
           });
 
   CROW_ROUTE(app, "/changeCourseLocation")
       .methods(crow::HTTPMethod::PATCH)(
-          [this](const crow::request& req, crow::response& res) {
+          [this, route = metrics.addRoute("/changeCourseLocation")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
             setCourseLocation(req, res);
           });
 
   CROW_ROUTE(app, "/changeCourseTeacher")
       .methods(crow::HTTPMethod::PATCH)(
-          [this](const crow::request& req, crow::response& res) {
+          [this, route = metrics.addRoute("/changeCourseTeacher")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
             setCourseInstructor(req, res);
           });
 
   CROW_ROUTE(app, "/changeCourseTime")
       .methods(crow::HTTPMethod::PATCH)(
-          [this](const crow::request& req, crow::response& res) {
+          [this, route = metrics.addRoute("/changeCourseTime")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
             setCourseTime(req, res);
           });
 
   CROW_ROUTE(app, "/setEnrollmentCount")
       .methods(crow::HTTPMethod::PATCH)(
-          [this](const crow::request& req, crow::response& res) {
+          [this, route = metrics.addRoute("/setEnrollmentCount")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
             setEnrollmentCount(req, res);
           });
+
+  CROW_ROUTE(app, "/batchUpdate")
+      .methods(crow::HTTPMethod::POST, crow::HTTPMethod::PATCH)(
+          [this, route = metrics.addRoute("/batchUpdate")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
+            batchUpdate(req, res);
+          });
+
+  CROW_ROUTE(app, "/enrollStudentInCourse")
+      .methods(crow::HTTPMethod::PATCH)(
+          [this, route = metrics.addRoute("/enrollStudentInCourse")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
+            enrollStudentInCourse(req, res);
+          });
+
+  CROW_ROUTE(app, "/dropStudentFromCourse")
+      .methods(crow::HTTPMethod::PATCH)(
+          [this, route = metrics.addRoute("/dropStudentFromCourse")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
+            dropStudentFromCourse(req, res);
+          });
+
+  CROW_ROUTE(app, "/joinWaitlist")
+      .methods(crow::HTTPMethod::PATCH)(
+          [this, route = metrics.addRoute("/joinWaitlist")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
+            joinWaitlist(req, res);
+          });
+
+  CROW_ROUTE(app, "/leaveWaitlist")
+      .methods(crow::HTTPMethod::PATCH)(
+          [this, route = metrics.addRoute("/leaveWaitlist")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
+            leaveWaitlist(req, res);
+          });
+
+  CROW_ROUTE(app, "/getWaitlistPosition")
+      .methods(crow::HTTPMethod::GET)(
+          [this, route = metrics.addRoute("/getWaitlistPosition")](
+              const crow::request& req, crow::response& res) {
+            Metrics::Timer timer(&metrics, route, &res.code);
+            getWaitlistPosition(req, res);
+          });
+}
+
+// Removes the catalog export files this controller wrote, and their
+// directory.
+RouteController::~RouteController() {
+  for (const auto& current : catalogExports) {
+    if (!current.path.empty()) std::remove(current.path.c_str());
+  }
+  for (const auto& retired : retiredExports) {
+    std::remove(retired.first.c_str());
+  }
+  if (!exportDirectory.empty()) ::rmdir(exportDirectory.c_str());
 }
 
 void RouteController::setDatabase(MyFileDatabase* db) {
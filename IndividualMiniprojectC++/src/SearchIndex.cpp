@@ -0,0 +1,256 @@
+// Copyright 2024 Maria Surani
+#include "SearchIndex.h"
+
+#include <algorithm>
+#include <cctype>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Letters, digits and any byte of a multi-byte UTF-8 character belong to
+// words; everything else separates them.
+bool isWordByte(unsigned char c) { return c >= 0x80 || std::isalnum(c); }
+
+uint32_t packTrigram(const std::string& padded, size_t i) {
+  return static_cast<uint32_t>(static_cast<unsigned char>(padded[i])) << 16 |
+         static_cast<uint32_t>(static_cast<unsigned char>(padded[i + 1]))
+             << 8 |
+         static_cast<uint32_t>(static_cast<unsigned char>(padded[i + 2]));
+}
+
+// The number of the query's trigrams each value shares, by value id. Kept
+// per thread across searches and zeroed again only where a search counted,
+// so a search costs the postings it reads and not the number of values.
+thread_local std::vector<uint32_t> sharedCounts;
+
+}  // namespace
+
+constexpr double SearchIndex::kMinScore;
+
+SearchIndex::SearchIndex() : hasPending(false) {}
+
+/**
+ * Replaces the contents of the index when it is next used.
+ *
+ * @param values the value of every course, repeated once per course; empty
+ *               values are skipped
+ */
+void SearchIndex::rebuild(std::vector<std::string> values) {
+  std::unique_lock<std::shared_timed_mutex> lock(mutex);
+  entries.clear();
+  freeIds.clear();
+  ids.clear();
+  postings.clear();
+  pending = std::move(values);
+  hasPending = true;
+}
+
+/**
+ * Records that one more course has a value.
+ *
+ * @param value the value; an empty one is ignored
+ */
+void SearchIndex::add(const std::string& value) {
+  std::unique_lock<std::shared_timed_mutex> lock(mutex);
+  buildPendingUnlocked();
+  addUnlocked(value, 1);
+}
+
+/**
+ * Records that one course no longer has a value. The value is removed from
+ * the index once no course has it.
+ *
+ * @param value the value
+ */
+void SearchIndex::remove(const std::string& value) {
+  std::unique_lock<std::shared_timed_mutex> lock(mutex);
+  buildPendingUnlocked();
+  removeUnlocked(value);
+}
+
+/**
+ * Records that a course's value changed.
+ *
+ * @param oldValue the course's current value
+ * @param newValue the value it is about to get
+ */
+void SearchIndex::update(const std::string& oldValue,
+                         const std::string& newValue) {
+  if (oldValue == newValue) return;
+  std::unique_lock<std::shared_timed_mutex> lock(mutex);
+  buildPendingUnlocked();
+  removeUnlocked(oldValue);
+  addUnlocked(newValue, 1);
+}
+
+/**
+ * Finds the values that best match a query, which may be misspelled or
+ * still being typed.
+ *
+ * @param query the text typed so far, e.g. "kryzstof chorom"
+ * @param limit the largest number of values to return
+ * @return the matching values, best first; ties are ordered by value
+ */
+std::vector<SearchIndex::Match> SearchIndex::search(const std::string& query,
+                                                    size_t limit) const {
+  std::vector<Match> result;
+  std::vector<uint32_t> trigrams = trigramsOf(query, true);
+  if (trigrams.empty() || limit == 0) return result;
+
+  struct Ranked {
+    uint32_t id;
+    double score;
+    // Shared trigrams over all trigrams of the query and value, so that of
+    // two values containing the query the shorter ranks first
+    double similarity;
+  };
+  auto lock = lockForQuery();
+  if (sharedCounts.size() < entries.size()) {
+    sharedCounts.resize(entries.size(), 0);
+  }
+  // The values sharing a trigram with the query
+  std::vector<uint32_t> touched;
+  std::vector<Ranked> ranked;
+  try {
+    for (uint32_t trigram : trigrams) {
+      auto it = postings.find(trigram);
+      if (it == postings.end()) continue;
+      for (uint32_t id : it->second) {
+        if (sharedCounts[id] == 0) touched.push_back(id);
+        ++sharedCounts[id];
+      }
+    }
+    for (uint32_t id : touched) {
+      uint32_t shared = sharedCounts[id];
+      sharedCounts[id] = 0;
+      double score = static_cast<double>(shared) / trigrams.size();
+      if (score < kMinScore) continue;
+      ranked.push_back(
+          {id, score,
+           static_cast<double>(shared) /
+               (trigrams.size() + entries[id].trigramCount - shared)});
+    }
+  } catch (...) {
+    for (uint32_t id : touched) sharedCounts[id] = 0;
+    throw;
+  }
+  auto better = [this](const Ranked& a, const Ranked& b) {
+    if (a.score != b.score) return a.score > b.score;
+    if (a.similarity != b.similarity) return a.similarity > b.similarity;
+    return entries[a.id].value < entries[b.id].value;
+  };
+  size_t count = std::min(limit, ranked.size());
+  std::partial_sort(ranked.begin(), ranked.begin() + count, ranked.end(),
+                    better);
+  result.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    result.push_back({entries[ranked[i].id].value, ranked[i].score});
+  }
+  return result;
+}
+
+/**
+ * Gets the number of distinct values held by at least one course.
+ *
+ * @return the number of values in the index
+ */
+size_t SearchIndex::size() const {
+  auto lock = lockForQuery();
+  return ids.size();
+}
+
+// The distinct trigrams of text's words, sorted. With prefix, a last word
+// not followed by a separator is taken as unfinished and not padded behind.
+std::vector<uint32_t> SearchIndex::trigramsOf(const std::string& text,
+                                              bool prefix) {
+  std::vector<uint32_t> trigrams;
+  std::string padded;
+  for (size_t i = 0; i < text.size();) {
+    if (!isWordByte(text[i])) {
+      ++i;
+      continue;
+    }
+    padded = "  ";
+    while (i < text.size() && isWordByte(text[i])) {
+      padded += static_cast<char>(
+          std::tolower(static_cast<unsigned char>(text[i])));
+      ++i;
+    }
+    if (!prefix || i < text.size()) padded += ' ';
+    for (size_t j = 0; j + 3 <= padded.size(); ++j) {
+      trigrams.push_back(packTrigram(padded, j));
+    }
+  }
+  std::sort(trigrams.begin(), trigrams.end());
+  trigrams.erase(std::unique(trigrams.begin(), trigrams.end()),
+                 trigrams.end());
+  return trigrams;
+}
+
+void SearchIndex::addUnlocked(const std::string& value, int count) const {
+  if (value.empty()) return;
+  auto existing = ids.find(value);
+  if (existing != ids.end()) {
+    entries[existing->second].count += count;
+    return;
+  }
+  std::vector<uint32_t> trigrams = trigramsOf(value, false);
+  uint32_t id;
+  if (freeIds.empty()) {
+    id = static_cast<uint32_t>(entries.size());
+    entries.push_back({});
+  } else {
+    id = freeIds.back();
+    freeIds.pop_back();
+  }
+  entries[id] = {value, count, static_cast<uint32_t>(trigrams.size())};
+  ids[value] = id;
+  for (uint32_t trigram : trigrams) {
+    auto& list = postings[trigram];
+    list.insert(std::lower_bound(list.begin(), list.end(), id), id);
+  }
+}
+
+void SearchIndex::removeUnlocked(const std::string& value) {
+  auto existing = ids.find(value);
+  if (existing == ids.end()) return;
+  uint32_t id = existing->second;
+  if (--entries[id].count > 0) return;
+  for (uint32_t trigram : trigramsOf(value, false)) {
+    auto list = postings.find(trigram);
+    auto it = std::lower_bound(list->second.begin(), list->second.end(), id);
+    list->second.erase(it);
+    if (list->second.empty()) postings.erase(list);
+  }
+  ids.erase(existing);
+  entries[id] = {"", 0, 0};
+  freeIds.push_back(id);
+}
+
+// Indexes the values passed to rebuild(), if there are any. The caller must
+// hold the lock exclusively.
+void SearchIndex::buildPendingUnlocked() const {
+  if (!hasPending) return;
+  std::unordered_map<std::string, int> counts;
+  for (const auto& value : pending) {
+    if (!value.empty()) counts[value]++;
+  }
+  for (const auto& it : counts) addUnlocked(it.first, it.second);
+  pending.clear();
+  pending.shrink_to_fit();
+  hasPending = false;
+}
+
+// Takes the lock for a query, first indexing any pending values.
+std::shared_lock<std::shared_timed_mutex> SearchIndex::lockForQuery() const {
+  while (true) {
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+    if (!hasPending) return lock;
+    lock.unlock();
+    std::unique_lock<std::shared_timed_mutex> exclusive(mutex);
+    buildPendingUnlocked();
+  }
+}
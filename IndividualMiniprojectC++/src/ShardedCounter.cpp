@@ -0,0 +1,79 @@
+// Copyright 2024 Maria Surani
+#include "ShardedCounter.h"
+
+namespace {
+
+// Hands out slots to threads round robin, so that up to kSlots threads each
+// get a slot of their own
+std::atomic<unsigned> nextSlot(0);
+
+}  // namespace
+
+const int ShardedCounter::kSlots;
+
+/**
+ * Constructs a counter holding the given value.
+ *
+ * @param value the initial value
+ */
+ShardedCounter::ShardedCounter(int64_t value) { store(value); }
+
+/**
+ * Copies a counter, taking a snapshot of its value.
+ *
+ * @param other The counter to copy.
+ */
+ShardedCounter::ShardedCounter(const ShardedCounter& other) {
+  store(other.load());
+}
+
+/**
+ * Replaces this counter's value with a snapshot of another's.
+ *
+ * @param other The counter to copy.
+ * @return A reference to this counter.
+ */
+ShardedCounter& ShardedCounter::operator=(const ShardedCounter& other) {
+  store(other.load());
+  return *this;
+}
+
+/**
+ * Adds to the counter, touching only the calling thread's slot.
+ *
+ * @param delta the amount to add, which may be negative
+ */
+void ShardedCounter::add(int64_t delta) {
+  slots[localSlot()].value.fetch_add(delta, std::memory_order_relaxed);
+}
+
+/**
+ * Gets the value of the counter, the sum of its slots.
+ *
+ * @return the value
+ */
+int64_t ShardedCounter::load() const {
+  int64_t total = 0;
+  for (const auto& slot : slots) {
+    total += slot.value.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+/**
+ * Sets the value of the counter. Must not race with add().
+ *
+ * @param value the new value
+ */
+void ShardedCounter::store(int64_t value) {
+  slots[0].value.store(value, std::memory_order_relaxed);
+  for (int i = 1; i < kSlots; ++i) {
+    slots[i].value.store(0, std::memory_order_relaxed);
+  }
+}
+
+// The slot the calling thread adds to.
+int ShardedCounter::localSlot() {
+  thread_local int slot = static_cast<int>(nextSlot++ % kSlots);
+  return slot;
+}
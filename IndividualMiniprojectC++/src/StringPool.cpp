@@ -0,0 +1,129 @@
+// Copyright 2024 Maria Surani
+#include "StringPool.h"
+
+#include <algorithm>
+#include <mutex>
+#include <tuple>
+
+namespace {
+
+// Fewest strings added between two sweeps, so small pools are not swept on
+// every new string
+const size_t kMinSweepInterval = 1024;
+
+}  // namespace
+
+/**
+ * Gets the pool shared by the whole process.
+ *
+ * @return the global string pool
+ */
+StringPool& StringPool::global() {
+  static StringPool* pool = new StringPool();  // never destroyed
+  return *pool;
+}
+
+/**
+ * Returns the pooled copy of a string, adding it if it is new, and counts
+ * one more reference to it. Lookups of known strings only take a shared
+ * lock, so concurrent requests interning the same values do not serialize.
+ *
+ * @param value the string to intern
+ * @return the pooled string, valid until release() is called for it
+ */
+StringPool::Entry* StringPool::acquire(const std::string& value) {
+  {
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+    auto it = strings.find(value);
+    if (it != strings.end()) {
+      it->second.fetch_add(1, std::memory_order_relaxed);
+      return &*it;
+    }
+  }
+  std::unique_lock<std::shared_timed_mutex> lock(mutex);
+  auto it = strings.find(value);
+  if (it != strings.end()) {
+    it->second.fetch_add(1, std::memory_order_relaxed);
+    return &*it;
+  }
+  if (++addedSinceSweep > std::max(sweepInterval, kMinSweepInterval)) {
+    sweepUnlocked();
+  }
+  return &*strings
+               .emplace(std::piecewise_construct, std::forward_as_tuple(value),
+                        std::forward_as_tuple(1))
+               .first;
+}
+
+/**
+ * Counts one reference fewer to a pooled string. A string left without
+ * references stays in the pool, where acquire() can still find it, until
+ * the next sweep.
+ *
+ * @param entry the string returned by acquire()
+ */
+void StringPool::release(Entry* entry) {
+  entry->second.fetch_sub(1, std::memory_order_release);
+}
+
+/**
+ * Frees every string no handle refers to.
+ */
+void StringPool::sweep() {
+  std::unique_lock<std::shared_timed_mutex> lock(mutex);
+  sweepUnlocked();
+}
+
+/**
+ * Gets the number of distinct strings in the pool, including those without
+ * references that were not swept yet.
+ *
+ * @return the pool size
+ */
+size_t StringPool::size() const {
+  std::shared_lock<std::shared_timed_mutex> lock(mutex);
+  return strings.size();
+}
+
+// Frees the strings without references. References are only added under a
+// lock, and a string without any cannot gain one from a handle, so no
+// count changes from 0 while the lock is held exclusively.
+void StringPool::sweepUnlocked() {
+  for (auto it = strings.begin(); it != strings.end();) {
+    if (it->second.load(std::memory_order_acquire) == 0) {
+      it = strings.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  addedSinceSweep = 0;
+  sweepInterval = strings.size();
+}
+
+/**
+ * Constructs a handle to the empty string.
+ */
+InternedString::InternedString()
+    : entry(StringPool::global().acquire(std::string())) {}
+
+/**
+ * Constructs a handle to the pooled copy of a string.
+ *
+ * @param value the string to intern
+ */
+InternedString::InternedString(const std::string& value)
+    : entry(StringPool::global().acquire(value)) {}
+
+InternedString::InternedString(const InternedString& other)
+    : entry(other.entry) {
+  entry->second.fetch_add(1, std::memory_order_relaxed);
+}
+
+InternedString& InternedString::operator=(const InternedString& other) {
+  other.entry->second.fetch_add(1, std::memory_order_relaxed);
+  StringPool::release(entry);
+  entry = other.entry;
+  return *this;
+}
+
+InternedString::~InternedString() { StringPool::release(entry); }
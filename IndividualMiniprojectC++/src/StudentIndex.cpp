@@ -0,0 +1,114 @@
+// Copyright 2024 Maria Surani
+#include "StudentIndex.h"
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Replaces the contents of the index.
+ *
+ * @param records every student's enrollment in every course, in any order
+ */
+void StudentIndex::rebuild(const std::vector<Record>& records) {
+  std::unique_lock<std::shared_timed_mutex> lock(mutex);
+  students.clear();
+  for (const auto& record : records) {
+    addUnlocked(record.studentId, record.course.deptCode,
+                record.course.courseNumber);
+  }
+}
+
+/**
+ * Records that a student enrolled in a course.
+ *
+ * @param studentId    the student's ID
+ * @param deptCode     the course's department
+ * @param courseNumber the course's number
+ */
+void StudentIndex::add(uint32_t studentId, const std::string& deptCode,
+                       int courseNumber) {
+  std::unique_lock<std::shared_timed_mutex> lock(mutex);
+  addUnlocked(studentId, deptCode, courseNumber);
+}
+
+/**
+ * Records that a student dropped a course. A student left without courses
+ * is removed from the index.
+ *
+ * @param studentId    the student's ID
+ * @param deptCode     the course's department
+ * @param courseNumber the course's number
+ */
+void StudentIndex::remove(uint32_t studentId, const std::string& deptCode,
+                          int courseNumber) {
+  std::unique_lock<std::shared_timed_mutex> lock(mutex);
+  auto student = students.find(studentId);
+  if (student == students.end()) return;
+  auto& entries = student->second;
+  auto it = std::lower_bound(entries.begin(), entries.end(), deptCode,
+                             [courseNumber](const Entry& entry,
+                                            const std::string& code) {
+                               return comesBefore(entry, code, courseNumber);
+                             });
+  if (it == entries.end() || it->deptCode.str() != deptCode ||
+      it->courseNumber != courseNumber) {
+    return;
+  }
+  entries.erase(it);
+  if (entries.empty()) students.erase(student);
+}
+
+/**
+ * Finds the courses a student is enrolled in.
+ *
+ * @param studentId the student's ID
+ * @return the courses, sorted by department code and course number; empty
+ * if the student is enrolled in none
+ */
+std::vector<StudentIndex::Enrollment> StudentIndex::findCourses(
+    uint32_t studentId) const {
+  std::shared_lock<std::shared_timed_mutex> lock(mutex);
+  std::vector<Enrollment> result;
+  auto student = students.find(studentId);
+  if (student == students.end()) return result;
+  result.reserve(student->second.size());
+  for (const auto& entry : student->second) {
+    result.push_back({entry.deptCode.str(), entry.courseNumber});
+  }
+  return result;
+}
+
+/**
+ * Gets the number of students enrolled in at least one course.
+ *
+ * @return the number of students in the index
+ */
+size_t StudentIndex::getStudentCount() const {
+  std::shared_lock<std::shared_timed_mutex> lock(mutex);
+  return students.size();
+}
+
+// Whether an entry sorts before a course, by department code and then
+// course number.
+bool StudentIndex::comesBefore(const Entry& entry, const std::string& deptCode,
+                               int courseNumber) {
+  int cmp = entry.deptCode.str().compare(deptCode);
+  return cmp < 0 || (cmp == 0 && entry.courseNumber < courseNumber);
+}
+
+void StudentIndex::addUnlocked(uint32_t studentId, const std::string& deptCode,
+                               int courseNumber) {
+  auto& entries = students[studentId];
+  auto it = std::lower_bound(entries.begin(), entries.end(), deptCode,
+                             [courseNumber](const Entry& entry,
+                                            const std::string& code) {
+                               return comesBefore(entry, code, courseNumber);
+                             });
+  if (it != entries.end() && it->deptCode.str() == deptCode &&
+      it->courseNumber == courseNumber) {
+    return;
+  }
+  entries.insert(it, {InternedString(deptCode), courseNumber});
+}
@@ -0,0 +1,142 @@
+// Copyright 2024 Maria Surani
+#include "TimeSlot.h"
+
+#include <cstring>
+#include <string>
+
+namespace {
+
+const char kDayLetters[] = "MTWRFSU";
+
+// Parses "H:MM" or "HH:MM" without interpreting the hour.
+bool parseClock(const std::string& text, int* hour, int* minute) {
+  size_t colon = text.find(':');
+  if (colon == std::string::npos || colon == 0 || colon > 2 ||
+      text.size() != colon + 3) {
+    return false;
+  }
+  int value = 0;
+  for (size_t i = 0; i < text.size(); ++i) {
+    if (i == colon) continue;
+    if (text[i] < '0' || text[i] > '9') return false;
+    value = value * 10 + (text[i] - '0');
+  }
+  *hour = value / 100;
+  *minute = value % 100;
+  return *hour <= 24 && *minute < 60;
+}
+
+bool isTwelveHour(int hour) { return hour >= 1 && hour <= 12; }
+
+// Minutes after midnight for a start time, see the class comment.
+int startMinuteOf(int hour, int minute) {
+  if (hour >= 1 && hour <= 7) hour += 12;
+  return hour * 60 + minute;
+}
+
+// Minutes after midnight for the first end time after start.
+int endMinuteOf(int hour, int minute, int start) {
+  if (!isTwelveHour(hour)) return hour * 60 + minute;
+  int end = (hour % 12) * 60 + minute;
+  while (end <= start) end += 12 * 60;
+  return end;
+}
+
+}  // namespace
+
+const uint8_t TimeSlot::kEveryDay;
+const int TimeSlot::kMinutesPerDay;
+
+/**
+ * Constructs an empty, invalid time slot.
+ */
+TimeSlot::TimeSlot() : startMinute(0), endMinute(0), days(0) {}
+
+/**
+ * Constructs a time slot from its text, parsing it if it is well formed.
+ *
+ * @param text The time slot as written, e.g. "MW 11:40-12:55".
+ */
+TimeSlot::TimeSlot(const std::string& text)
+    : text(text), startMinute(0), endMinute(0), days(0) {
+  uint8_t parsedDays = kEveryDay;
+  std::string range = text;
+  size_t space = text.find(' ');
+  if (space != std::string::npos) {
+    if (!parseDays(text.substr(0, space), &parsedDays)) return;
+    range = text.substr(space + 1);
+  }
+
+  size_t dash = range.find('-');
+  if (dash == std::string::npos) return;
+  int startHour, startMin, endHour, endMin;
+  if (!parseClock(range.substr(0, dash), &startHour, &startMin) ||
+      !parseClock(range.substr(dash + 1), &endHour, &endMin)) {
+    return;
+  }
+  int start = startMinuteOf(startHour, startMin);
+  int end = endMinuteOf(endHour, endMin, start);
+  if (start >= end || end > kMinutesPerDay) return;
+
+  startMinute = static_cast<int16_t>(start);
+  endMinute = static_cast<int16_t>(end);
+  days = parsedDays;
+}
+
+/**
+ * Parses a single time of day, read the same way as the start of a slot.
+ *
+ * @param text   The time, e.g. "11:45" or "4:10".
+ * @param minute Set to the minutes after midnight on success.
+ * @return true if the time is well formed.
+ */
+bool TimeSlot::parseTime(const std::string& text, int* minute) {
+  int hour, min;
+  if (!parseClock(text, &hour, &min)) return false;
+  int value = startMinuteOf(hour, min);
+  if (value >= kMinutesPerDay) return false;
+  *minute = value;
+  return true;
+}
+
+/**
+ * Parses a set of day letters such as "MW" or "TR".
+ *
+ * @param text The letters, each one of M T W R F S U.
+ * @param days Set to the bit mask of the days on success.
+ * @return true if the text is a non-empty set of day letters.
+ */
+bool TimeSlot::parseDays(const std::string& text, uint8_t* days) {
+  if (text.empty()) return false;
+  uint8_t mask = 0;
+  for (char c : text) {
+    const char* letter = c == '\0' ? nullptr : std::strchr(kDayLetters, c);
+    if (letter == nullptr) return false;
+    mask |= static_cast<uint8_t>(1 << (letter - kDayLetters));
+  }
+  *days = mask;
+  return true;
+}
+
+/**
+ * Checks whether the course is in session at a given minute.
+ *
+ * @param minute The minutes after midnight.
+ * @param onDays The days to check, any of which counts.
+ * @return true if the slot is valid and covers the minute on one of the days.
+ */
+bool TimeSlot::meetsAt(int minute, uint8_t onDays) const {
+  return (days & onDays) != 0 && startMinute <= minute && minute < endMinute;
+}
+
+/**
+ * Checks whether two courses are in session at the same time. Slots that
+ * only touch, one ending as the other starts, do not overlap.
+ *
+ * @param other The other time slot.
+ * @return true if both slots are valid and share a day and some minutes.
+ */
+bool TimeSlot::overlaps(const TimeSlot& other) const {
+  return (days & other.days) != 0 && startMinute < other.endMinute &&
+         other.startMinute < endMinute;
+}
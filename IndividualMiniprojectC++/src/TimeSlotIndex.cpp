@@ -0,0 +1,274 @@
+// Copyright 2024 Maria Surani
+#include "TimeSlotIndex.h"
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Orders courses by start minute, which the interval tree relies on, then by
+// end minute and days, and courses in the same slot by department and number.
+bool keyLess(const ScheduledCourse& a, const ScheduledCourse& b) {
+  const TimeSlot& x = a.timeSlot;
+  const TimeSlot& y = b.timeSlot;
+  if (x.getStartMinute() != y.getStartMinute()) {
+    return x.getStartMinute() < y.getStartMinute();
+  }
+  if (x.getEndMinute() != y.getEndMinute()) {
+    return x.getEndMinute() < y.getEndMinute();
+  }
+  if (x.getDays() != y.getDays()) return x.getDays() < y.getDays();
+  if (a.deptCode != b.deptCode) return a.deptCode < b.deptCode;
+  return a.courseNumber < b.courseNumber;
+}
+
+// Priorities of nodes created by rebuild() count down from the top of the
+// range, and those of inserted nodes are drawn below them, so inserts never
+// rotate the balanced tree that rebuild() produced.
+const uint32_t kBuildPriority = std::numeric_limits<uint32_t>::max();
+const uint32_t kMaxInsertPriority = 1u << 31;
+
+}  // namespace
+
+struct TimeSlotIndex::Node {
+  explicit Node(ScheduledCourse course, uint32_t priority)
+      : course(std::move(course)),
+        priority(priority),
+        maxEnd(this->course.timeSlot.getEndMinute()) {}
+
+  // Recomputes maxEnd after a child changed.
+  void update() {
+    maxEnd = course.timeSlot.getEndMinute();
+    if (left) maxEnd = std::max(maxEnd, left->maxEnd);
+    if (right) maxEnd = std::max(maxEnd, right->maxEnd);
+  }
+
+  ScheduledCourse course;
+  uint32_t priority;
+  int maxEnd;
+  NodePtr left;
+  NodePtr right;
+};
+
+TimeSlotIndex::TimeSlotIndex() : hasPending(false), count(0) {}
+
+TimeSlotIndex::~TimeSlotIndex() = default;
+
+/**
+ * Replaces the contents of the index. The tree is built bottom-up from the
+ * sorted courses, which is much faster than inserting them one at a time,
+ * when the index is next used.
+ *
+ * @param courses every course to index
+ */
+void TimeSlotIndex::rebuild(std::vector<ScheduledCourse> courses) {
+  std::unique_lock<std::shared_timed_mutex> lock(mutex);
+  root.reset();
+  count = 0;
+  pending = std::move(courses);
+  hasPending = true;
+}
+
+/**
+ * Adds a course to the index. Courses without a valid time slot are ignored.
+ *
+ * @param course the course to add
+ */
+void TimeSlotIndex::insert(const ScheduledCourse& course) {
+  std::unique_lock<std::shared_timed_mutex> lock(mutex);
+  buildPendingUnlocked();
+  insertUnlocked(course);
+}
+
+/**
+ * Removes a course from the index.
+ *
+ * @param course the course to remove, with the time slot it was indexed under
+ * @return true if the course was in the index
+ */
+bool TimeSlotIndex::erase(const ScheduledCourse& course) {
+  std::unique_lock<std::shared_timed_mutex> lock(mutex);
+  buildPendingUnlocked();
+  if (!eraseFrom(&root, course)) return false;
+  --count;
+  return true;
+}
+
+/**
+ * Moves a course to a new time slot in a single step, so no query sees it
+ * in neither or both slots.
+ *
+ * @param deptCode     the course's department
+ * @param courseNumber the course's number
+ * @param oldSlot      the time slot it is indexed under
+ * @param newSlot      its new time slot
+ */
+void TimeSlotIndex::update(const std::string& deptCode, int courseNumber,
+                           const TimeSlot& oldSlot, const TimeSlot& newSlot) {
+  std::unique_lock<std::shared_timed_mutex> lock(mutex);
+  buildPendingUnlocked();
+  if (eraseFrom(&root, {deptCode, courseNumber, oldSlot})) --count;
+  insertUnlocked({deptCode, courseNumber, newSlot});
+}
+
+/**
+ * Finds the courses in session at a given minute.
+ *
+ * @param minute the minutes after midnight
+ * @param days   the days to look at, any of which counts
+ * @return the matching courses, ordered by start time
+ */
+std::vector<ScheduledCourse> TimeSlotIndex::findMeetingAt(int minute,
+                                                          uint8_t days) const {
+  std::vector<ScheduledCourse> result;
+  auto lock = lockForQuery();
+  collect(root.get(), minute, minute + 1, days, &result);
+  return result;
+}
+
+/**
+ * Finds the courses in session at the same time as a time slot.
+ *
+ * @param slot the time slot to check
+ * @return the overlapping courses, ordered by start time; empty if the slot
+ *         is not valid
+ */
+std::vector<ScheduledCourse> TimeSlotIndex::findOverlapping(
+    const TimeSlot& slot) const {
+  std::vector<ScheduledCourse> result;
+  if (!slot.isValid()) return result;
+  auto lock = lockForQuery();
+  collect(root.get(), slot.getStartMinute(), slot.getEndMinute(),
+          slot.getDays(), &result);
+  return result;
+}
+
+/**
+ * Gets the number of indexed courses.
+ *
+ * @return the number of courses with a valid time slot
+ */
+size_t TimeSlotIndex::size() const {
+  auto lock = lockForQuery();
+  return count;
+}
+
+// Builds the tree from the courses passed to rebuild(), if any. The caller
+// must hold the lock exclusively.
+void TimeSlotIndex::buildPendingUnlocked() const {
+  if (!hasPending) return;
+  std::vector<ScheduledCourse> courses = std::move(pending);
+  pending.clear();
+  courses.erase(std::remove_if(courses.begin(), courses.end(),
+                               [](const ScheduledCourse& course) {
+                                 return !course.timeSlot.isValid();
+                               }),
+                courses.end());
+  std::sort(courses.begin(), courses.end(), keyLess);
+  root = build(&courses, 0, courses.size(), kBuildPriority);
+  count = courses.size();
+  hasPending = false;
+}
+
+// Takes the lock for a query, first building any pending tree.
+std::shared_lock<std::shared_timed_mutex> TimeSlotIndex::lockForQuery() const {
+  while (true) {
+    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+    if (!hasPending) return lock;
+    lock.unlock();
+    std::unique_lock<std::shared_timed_mutex> exclusive(mutex);
+    buildPendingUnlocked();
+  }
+}
+
+TimeSlotIndex::NodePtr TimeSlotIndex::build(
+    std::vector<ScheduledCourse>* courses, size_t begin, size_t end,
+    uint32_t priority) {
+  if (begin == end) return nullptr;
+  size_t middle = begin + (end - begin) / 2;
+  NodePtr node(new Node(std::move((*courses)[middle]), priority));
+  node->left = build(courses, begin, middle, priority - 1);
+  node->right = build(courses, middle + 1, end, priority - 1);
+  node->update();
+  return node;
+}
+
+// Splits a subtree into the nodes ordered before key and all the others.
+void TimeSlotIndex::split(NodePtr node, const ScheduledCourse& key,
+                          NodePtr* less, NodePtr* rest) {
+  if (!node) {
+    less->reset();
+    rest->reset();
+    return;
+  }
+  if (keyLess(node->course, key)) {
+    NodePtr right = std::move(node->right);
+    split(std::move(right), key, &node->right, rest);
+    node->update();
+    *less = std::move(node);
+  } else {
+    NodePtr left = std::move(node->left);
+    split(std::move(left), key, less, &node->left);
+    node->update();
+    *rest = std::move(node);
+  }
+}
+
+// Joins two subtrees where every node of first is ordered before second.
+TimeSlotIndex::NodePtr TimeSlotIndex::merge(NodePtr first, NodePtr second) {
+  if (!first) return second;
+  if (!second) return first;
+  if (first->priority > second->priority) {
+    first->right = merge(std::move(first->right), std::move(second));
+    first->update();
+    return first;
+  }
+  second->left = merge(std::move(first), std::move(second->left));
+  second->update();
+  return second;
+}
+
+bool TimeSlotIndex::eraseFrom(NodePtr* node, const ScheduledCourse& key) {
+  Node* current = node->get();
+  if (current == nullptr) return false;
+  bool erased;
+  if (keyLess(key, current->course)) {
+    erased = eraseFrom(&current->left, key);
+  } else if (keyLess(current->course, key)) {
+    erased = eraseFrom(&current->right, key);
+  } else {
+    *node = merge(std::move(current->left), std::move(current->right));
+    return true;
+  }
+  if (erased) current->update();
+  return erased;
+}
+
+// Appends the courses meeting on one of days that overlap [start, end).
+void TimeSlotIndex::collect(const Node* node, int start, int end, uint8_t days,
+                            std::vector<ScheduledCourse>* out) {
+  // Nothing below this node is still in session at start
+  if (node == nullptr || node->maxEnd <= start) return;
+  collect(node->left.get(), start, end, days, out);
+  // This node and everything to its right start too late
+  const TimeSlot& slot = node->course.timeSlot;
+  if (slot.getStartMinute() >= end) return;
+  if (slot.getEndMinute() > start && (slot.getDays() & days) != 0) {
+    out->push_back(node->course);
+  }
+  collect(node->right.get(), start, end, days, out);
+}
+
+void TimeSlotIndex::insertUnlocked(const ScheduledCourse& course) {
+  if (!course.timeSlot.isValid()) return;
+  NodePtr less, rest;
+  split(std::move(root), course, &less, &rest);
+  uint32_t priority = static_cast<uint32_t>(random()) % kMaxInsertPriority;
+  NodePtr node(new Node(course, priority));
+  root = merge(merge(std::move(less), std::move(node)), std::move(rest));
+  ++count;
+}
@@ -0,0 +1,188 @@
+// Copyright 2024 Maria Surani
+#include "Waitlist.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "Roster.h"
+
+namespace {
+
+// Whether a list of IDs holds one twice.
+bool hasDuplicates(const std::vector<uint32_t>& studentIds) {
+  std::unordered_set<uint32_t> seen;
+  for (uint32_t studentId : studentIds) {
+    if (!seen.insert(studentId).second) return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+/**
+ * Adds a student to the end of the waitlist.
+ *
+ * @param studentId the student's ID
+ * @return true if the student joined, false if already waiting
+ */
+bool Waitlist::join(uint32_t studentId) {
+  if (getPosition(studentId) != 0) return false;
+  studentIds.push_back(studentId);
+  return true;
+}
+
+/**
+ * Removes a student from the waitlist. Everyone behind them moves up.
+ *
+ * @param studentId the student's ID
+ * @return true if the student left, false if not waiting
+ */
+bool Waitlist::leave(uint32_t studentId) {
+  auto it = std::find(studentIds.begin(), studentIds.end(), studentId);
+  if (it == studentIds.end()) return false;
+  studentIds.erase(it);
+  return true;
+}
+
+/**
+ * Gets a student's place in the waitlist.
+ *
+ * @param studentId the student's ID
+ * @return the position, 1 for the next student to be enrolled, or 0 if the
+ * student is not waiting
+ */
+size_t Waitlist::getPosition(uint32_t studentId) const {
+  auto it = std::find(studentIds.begin(), studentIds.end(), studentId);
+  if (it == studentIds.end()) return 0;
+  return static_cast<size_t>(it - studentIds.begin()) + 1;
+}
+
+/**
+ * Gets the student who has waited longest. The waitlist must not be empty.
+ *
+ * @return the first student's ID
+ */
+uint32_t Waitlist::front() const { return studentIds.front(); }
+
+/**
+ * Removes the student who has waited longest. The waitlist must not be
+ * empty.
+ */
+void Waitlist::popFront() { studentIds.erase(studentIds.begin()); }
+
+/**
+ * Checks whether anyone is waiting.
+ *
+ * @return true if the waitlist is empty
+ */
+bool Waitlist::empty() const { return studentIds.empty(); }
+
+/**
+ * Gets the number of students waiting.
+ *
+ * @return the waitlist's length
+ */
+size_t Waitlist::size() const { return studentIds.size(); }
+
+/**
+ * Gets the IDs of the students waiting.
+ *
+ * @return the IDs in the order the students joined
+ */
+const std::vector<uint32_t>& Waitlist::getStudentIds() const {
+  return studentIds;
+}
+
+/**
+ * Writes the waitlist as comma-separated IDs, as held by a SetWaitlist
+ * mutation, e.g. "4156,17".
+ *
+ * @return the IDs in order; empty for an empty waitlist
+ */
+std::string Waitlist::str() const {
+  std::string out;
+  for (uint32_t studentId : studentIds) {
+    if (!out.empty()) out += ',';
+    out += std::to_string(studentId);
+  }
+  return out;
+}
+
+/**
+ * Parses a waitlist written by str().
+ *
+ * @param text the comma-separated IDs
+ * @param out  set to the parsed waitlist
+ * @return false if an ID is invalid or repeated
+ */
+bool Waitlist::parse(const std::string& text, Waitlist* out) {
+  std::vector<uint32_t> studentIds;
+  size_t start = 0;
+  while (start < text.size()) {
+    size_t end = text.find(',', start);
+    if (end == std::string::npos) end = text.size();
+    uint32_t studentId;
+    if (!Roster::parseStudentId(text.substr(start, end - start),
+                                &studentId)) {
+      return false;
+    }
+    studentIds.push_back(studentId);
+    if (end + 1 == text.size()) return false;  // trailing comma
+    start = end + 1;
+  }
+  if (hasDuplicates(studentIds)) return false;
+  out->studentIds = std::move(studentIds);
+  return true;
+}
+
+/**
+ * Encodes the waitlist as one varint per ID, seven bits per byte, low bits
+ * first. Unlike a roster's, the IDs are not sorted, so they are not
+ * written as gaps.
+ *
+ * @return the encoded waitlist; empty for an empty waitlist
+ */
+std::string Waitlist::encode() const {
+  std::string out;
+  for (uint32_t studentId : studentIds) {
+    while (studentId >= 0x80) {
+      out.push_back(static_cast<char>(studentId | 0x80));
+      studentId >>= 7;
+    }
+    out.push_back(static_cast<char>(studentId));
+  }
+  return out;
+}
+
+/**
+ * Decodes a waitlist written by encode().
+ *
+ * @param data the encoded waitlist
+ * @param size the number of bytes
+ * @param out  set to the decoded waitlist
+ * @return false if the bytes are not a valid waitlist
+ */
+bool Waitlist::decode(const char* data, size_t size, Waitlist* out) {
+  std::vector<uint32_t> studentIds;
+  size_t i = 0;
+  while (i < size) {
+    uint64_t studentId = 0;
+    int shift = 0;
+    unsigned char byte;
+    do {
+      if (i == size || shift > 28) return false;
+      byte = static_cast<unsigned char>(data[i++]);
+      studentId |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      shift += 7;
+    } while (byte & 0x80);
+    if (studentId > UINT32_MAX) return false;
+    studentIds.push_back(static_cast<uint32_t>(studentId));
+  }
+  if (hasDuplicates(studentIds)) return false;
+  out->studentIds = std::move(studentIds);
+  return true;
+}
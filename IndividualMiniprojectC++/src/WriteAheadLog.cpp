@@ -0,0 +1,385 @@
+// Copyright 2024 Maria Surani
+#include "WriteAheadLog.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Crc32.h"
+
+namespace {
+
+// Each record is framed as [payload length][CRC-32 of payload][payload], so
+// a record torn by a crash mid-write is detected and ignored on replay.
+const size_t kFrameHeaderSize = 2 * sizeof(uint32_t);
+
+// Takes the place of the mutation type in a record holding several
+// mutations, which is followed by their count and then the mutations.
+const uint8_t kBatchRecord = 0;
+
+const char* const kFailedMessage =
+    "Write-ahead log: a failed write could not be undone";
+
+template <typename T>
+void putValue(std::string& out, T value) {
+  out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void putString(std::string& out, const std::string& value) {
+  putValue(out, static_cast<uint32_t>(value.size()));
+  out.append(value);
+}
+
+template <typename T>
+bool getValue(const std::string& in, size_t& pos, T& value) {
+  if (in.size() - pos < sizeof(value)) return false;
+  std::memcpy(&value, in.data() + pos, sizeof(value));
+  pos += sizeof(value);
+  return true;
+}
+
+bool getString(const std::string& in, size_t& pos, std::string& value) {
+  uint32_t len;
+  if (!getValue(in, pos, len) || in.size() - pos < len) return false;
+  value.assign(in, pos, len);
+  pos += len;
+  return true;
+}
+
+void putMutation(std::string& out, const Mutation& mutation) {
+  putValue(out, static_cast<uint8_t>(mutation.type));
+  putString(out, mutation.deptCode);
+  putString(out, mutation.courseCode);
+  putString(out, mutation.value);
+}
+
+// Reads the fields that follow a mutation's type.
+bool getMutationFields(const std::string& in, size_t& pos,
+                       Mutation& mutation) {
+  return getString(in, pos, mutation.deptCode) &&
+         getString(in, pos, mutation.courseCode) &&
+         getString(in, pos, mutation.value);
+}
+
+std::runtime_error logError(const std::string& what) {
+  return std::runtime_error("Write-ahead log: " + what + ": " +
+                            std::strerror(errno));
+}
+
+}  // namespace
+
+/**
+ * Opens (creating if needed) the log file at the given path. Nothing is
+ * replayed until replay() is called.
+ *
+ * @param logPath the path of the log file
+ */
+WriteAheadLog::WriteAheadLog(const std::string& logPath)
+    : logPath(logPath),
+      fd(-1),
+      lastLsn(0),
+      durableLsn(0),
+      flushInProgress(false),
+      failed(false) {
+  fd = ::open(logPath.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+  if (fd < 0) throw logError("cannot open " + logPath);
+}
+
+WriteAheadLog::~WriteAheadLog() {
+  if (fd >= 0) ::close(fd);
+}
+
+/**
+ * Buffers a mutation and assigns it the next LSN. The record is not durable
+ * until waitForDurable() returns for its LSN.
+ *
+ * @param mutation the mutation that was applied
+ * @return the LSN of the new record
+ */
+uint64_t WriteAheadLog::append(const Mutation& mutation) {
+  std::string body;
+  putMutation(body, mutation);
+  return appendRecord(body);
+}
+
+/**
+ * Buffers several mutations as a single record with a single LSN, so that
+ * replay sees either all of them or, if the record was torn, none.
+ *
+ * @param mutations the mutations that were applied, in order
+ * @return the LSN of the new record
+ */
+uint64_t WriteAheadLog::append(const std::vector<Mutation>& mutations) {
+  std::string body;
+  putValue(body, kBatchRecord);
+  putValue(body, static_cast<uint32_t>(mutations.size()));
+  for (const auto& mutation : mutations) putMutation(body, mutation);
+  return appendRecord(body);
+}
+
+// Frames a record body behind the next LSN and buffers it.
+uint64_t WriteAheadLog::appendRecord(const std::string& body) {
+  std::string payload;
+  std::lock_guard<std::mutex> guard(mutex);
+  if (failed) throw std::runtime_error(kFailedMessage);
+  uint64_t lsn = ++lastLsn;
+  putValue(payload, lsn);
+  payload.append(body);
+
+  putValue(pendingRecords, static_cast<uint32_t>(payload.size()));
+  putValue(pendingRecords, crc32(payload.data(), payload.size()));
+  pendingRecords.append(payload);
+  return lsn;
+}
+
+/**
+ * Blocks until the record with the given LSN is on stable storage. If no
+ * flush is running, the caller becomes the leader and flushes every record
+ * buffered so far with a single write and fsync; otherwise it waits for the
+ * running flush, which is how concurrent commits share one fsync. If the
+ * flush fails, its records are buffered again in front of any appended
+ * meanwhile, so the next flush retries them, and the error is thrown.
+ *
+ * @param lsn the LSN returned by append()
+ */
+void WriteAheadLog::waitForDurable(uint64_t lsn) {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (durableLsn < lsn) {
+    if (failed) throw std::runtime_error(kFailedMessage);
+    if (flushInProgress) {
+      flushed.wait(lock);
+      continue;
+    }
+    flushInProgress = true;
+    std::string batch;
+    batch.swap(pendingRecords);
+    uint64_t batchLsn = lastLsn;
+    lock.unlock();
+    try {
+      writeBatch(batch);
+    } catch (...) {
+      lock.lock();
+      pendingRecords.insert(0, batch);
+      flushInProgress = false;
+      flushed.notify_all();
+      throw;
+    }
+    lock.lock();
+    flushInProgress = false;
+    if (batchLsn > durableLsn) durableLsn = batchLsn;
+    flushed.notify_all();
+  }
+}
+
+/**
+ * Writes one batch of framed records and forces it to disk. If that fails,
+ * whatever part of the batch was written is cut off again, so that a later
+ * batch does not land behind a torn record, which replay would discard
+ * together with everything after it. If even that fails, the log is marked
+ * failed and refuses all further records.
+ *
+ * @param batch the encoded records
+ */
+void WriteAheadLog::writeBatch(const std::string& batch) {
+  off_t start = ::lseek(fd, 0, SEEK_END);
+  if (start < 0) throw logError("cannot find end of " + logPath);
+  try {
+    size_t written = 0;
+    while (written < batch.size()) {
+      ssize_t n = ::write(fd, batch.data() + written, batch.size() - written);
+      if (n < 0) {
+        if (errno == EINTR) continue;
+        throw logError("write failed");
+      }
+      written += static_cast<size_t>(n);
+    }
+    if (::fsync(fd) != 0) throw logError("fsync failed");
+  } catch (...) {
+    if (::ftruncate(fd, start) != 0 || ::fsync(fd) != 0) failed = true;
+    throw;
+  }
+}
+
+/**
+ * Reads the log from the start and hands every intact record with an LSN
+ * greater than afterLsn to the callback, in log order. A log rotated away by
+ * an unfinished checkpoint is replayed first. A torn or corrupt record ends
+ * the replay and is cut off so that new records follow the last good one.
+ *
+ * @param afterLsn the LSN already contained in the data file
+ * @param apply    called once for each record to re-apply
+ */
+void WriteAheadLog::replay(
+    uint64_t afterLsn, const std::function<void(const Mutation&)>& apply) {
+  std::lock_guard<std::mutex> guard(mutex);
+  replayFile(getRotatedPath(), afterLsn, apply);
+  size_t logSize = 0;
+  size_t validSize = replayFile(logPath, afterLsn, apply, &logSize);
+  if (validSize < logSize &&
+      ::ftruncate(fd, static_cast<off_t>(validSize)) != 0) {
+    throw logError("cannot cut off torn record");
+  }
+  durableLsn = lastLsn;
+}
+
+/**
+ * Replays the records of one log file. The caller must hold the mutex.
+ *
+ * @param path     the log file to read, which may not exist
+ * @param afterLsn records with an LSN up to this one are skipped
+ * @param apply    called once for each record to re-apply
+ * @param fileSize set to the size of the file, if not null
+ * @return the length of the intact prefix of the file
+ */
+size_t WriteAheadLog::replayFile(
+    const std::string& path, uint64_t afterLsn,
+    const std::function<void(const Mutation&)>& apply, size_t* fileSize) {
+  std::ifstream inFile(path, std::ios::binary);
+  std::ostringstream contents;
+  contents << inFile.rdbuf();
+  const std::string log = contents.str();
+  if (fileSize != nullptr) *fileSize = log.size();
+
+  size_t pos = 0;
+  while (log.size() - pos >= kFrameHeaderSize) {
+    size_t framePos = pos;
+    uint32_t payloadLen;
+    uint32_t checksum;
+    getValue(log, pos, payloadLen);
+    getValue(log, pos, checksum);
+    if (log.size() - pos < payloadLen) {
+      pos = framePos;
+      break;
+    }
+    std::string payload = log.substr(pos, payloadLen);
+    if (crc32(payload.data(), payload.size()) != checksum) {
+      pos = framePos;
+      break;
+    }
+    pos += payloadLen;
+
+    size_t fieldPos = 0;
+    uint64_t lsn;
+    uint8_t type;
+    uint32_t count = 1;
+    bool valid = getValue(payload, fieldPos, lsn) &&
+                 getValue(payload, fieldPos, type);
+    bool batch = valid && type == kBatchRecord;
+    if (batch) valid = getValue(payload, fieldPos, count);
+    std::vector<Mutation> mutations;
+    for (uint32_t i = 0; valid && i < count; ++i) {
+      if (batch) valid = getValue(payload, fieldPos, type);
+      Mutation mutation;
+      mutation.type = static_cast<MutationType>(type);
+      valid = valid && getMutationFields(payload, fieldPos, mutation);
+      mutations.push_back(std::move(mutation));
+    }
+    if (!valid) {
+      pos = framePos;
+      break;
+    }
+    if (lsn > lastLsn) lastLsn = lsn;
+    if (lsn > afterLsn) {
+      for (const auto& mutation : mutations) apply(mutation);
+    }
+  }
+  return pos;
+}
+
+/**
+ * Empties the log once its records are contained in a saved data file. The
+ * caller must make sure no mutation is applied concurrently.
+ */
+void WriteAheadLog::truncate() {
+  std::unique_lock<std::mutex> lock(mutex);
+  flushed.wait(lock, [this]() { return !flushInProgress; });
+  pendingRecords.clear();
+  if (::ftruncate(fd, 0) != 0 || ::fsync(fd) != 0) {
+    throw logError("cannot truncate " + logPath);
+  }
+  ::unlink(getRotatedPath().c_str());
+  durableLsn = lastLsn;
+  flushed.notify_all();
+}
+
+/**
+ * Starts a new log file for a checkpoint. Buffered records are flushed, the
+ * current file is renamed to the rotated path and an empty file takes its
+ * place, so every record appended afterwards has a larger LSN than the one
+ * returned. If a rotated file from an unfinished checkpoint still exists it
+ * is kept and no rotation happens; replay skips checkpointed records by LSN
+ * either way. The caller must make sure no mutation is applied concurrently.
+ *
+ * @return the LSN of the last record written before the rotation
+ */
+uint64_t WriteAheadLog::rotate() {
+  std::unique_lock<std::mutex> lock(mutex);
+  flushed.wait(lock, [this]() { return !flushInProgress; });
+  if (!pendingRecords.empty()) {
+    writeBatch(pendingRecords);
+    pendingRecords.clear();
+  }
+  durableLsn = lastLsn;
+  flushed.notify_all();
+
+  const std::string rotatedPath = getRotatedPath();
+  struct stat rotatedStat;
+  if (::stat(rotatedPath.c_str(), &rotatedStat) != 0) {
+    if (::rename(logPath.c_str(), rotatedPath.c_str()) != 0) {
+      throw logError("cannot rotate " + logPath);
+    }
+    int newFd = ::open(logPath.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (newFd < 0) throw logError("cannot open " + logPath);
+    ::close(fd);
+    fd = newFd;
+  }
+  return lastLsn;
+}
+
+/**
+ * Deletes the rotated log once a checkpoint containing all of its records
+ * is durable.
+ */
+void WriteAheadLog::discardRotated() {
+  if (::unlink(getRotatedPath().c_str()) != 0 && errno != ENOENT) {
+    throw logError("cannot delete " + getRotatedPath());
+  }
+}
+
+/**
+ * Gets the path a log file is moved to by rotate().
+ *
+ * @return the rotated log path
+ */
+std::string WriteAheadLog::getRotatedPath() const { return logPath + ".old"; }
+
+/**
+ * Gets the LSN of the most recently appended record.
+ *
+ * @return the last assigned LSN, 0 if none was ever assigned
+ */
+uint64_t WriteAheadLog::getLastLsn() const {
+  std::lock_guard<std::mutex> guard(mutex);
+  return lastLsn;
+}
+
+/**
+ * Moves the LSN counter forward, e.g. past the LSN stored in the data file,
+ * so that new records are never mistaken for ones already checkpointed.
+ *
+ * @param lsn the smallest value the last LSN may have
+ */
+void WriteAheadLog::advanceLastLsn(uint64_t lsn) {
+  std::lock_guard<std::mutex> guard(mutex);
+  if (lsn > lastLsn) lastLsn = lsn;
+  if (lsn > durableLsn) durableLsn = lsn;
+}
@@ -12,16 +12,6 @@
 #include "RouteController.h"
 #include "crow.h"  // NOLINT
 
-/**
- *  Method to handle proper termination protocols
- */
-void signalHandler(int signal) {
-  if (signal == SIGINT || signal == SIGTERM) {
-    MyApp::onTermination();
-    std::exit(signal);
-  }
-}
-
 /**
  *  Sets up the HTTP server and runs the program
  */
@@ -29,14 +19,16 @@ int main(int argc, char* argv[]) {
   std::string mode = argc > 1 ? argv[1] : "run";
   MyApp::run(mode);
 
+  // Crow stops the server on these signals from its own event loop rather
+  // than inside a signal handler, and run() then returns, so the final
+  // checkpoint runs here on the main thread with no request in flight
   crow::SimpleApp app;
-  app.signal_clear();
-  std::signal(SIGINT, signalHandler);
-  std::signal(SIGTERM, signalHandler);
+  app.signal_clear().signal_add(SIGINT).signal_add(SIGTERM);
 
   RouteController routeController;
   routeController.initRoutes(app);
   routeController.setDatabase(MyApp::getDatabase());
   app.port(8080).multithreaded().run();
+  MyApp::onTermination();
   return 0;
 }
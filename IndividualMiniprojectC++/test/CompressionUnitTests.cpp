@@ -0,0 +1,88 @@
+// Copyright 2024 Maria Surani
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "Compression.h"
+
+namespace {
+
+// Decompresses gzip or zlib data, telling them apart by their headers
+std::string decompress(const std::string& data) {
+  z_stream stream{};
+  EXPECT_EQ(inflateInit2(&stream, 15 + 32), Z_OK);
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+  stream.avail_in = static_cast<uInt>(data.size());
+  std::string result;
+  char block[4096];
+  int status;
+  do {
+    stream.next_out = reinterpret_cast<Bytef*>(block);
+    stream.avail_out = sizeof(block);
+    status = inflate(&stream, Z_NO_FLUSH);
+    result.append(block, sizeof(block) - stream.avail_out);
+  } while (status == Z_OK);
+  inflateEnd(&stream);
+  EXPECT_EQ(status, Z_STREAM_END);
+  return result;
+}
+
+std::string catalogText(int courses) {
+  std::string text;
+  for (int i = 0; i < courses; ++i) {
+    text += "COMS " + std::to_string(1000 + i) +
+            ": \nInstructor: Adam Cannon; Location: 417 IAB; Time: "
+            "11:40-12:55\n";
+  }
+  return text;
+}
+
+}  // namespace
+
+TEST(CompressionUnitTests, CompressTest) {
+  std::string text = catalogText(100);
+  std::string gzip = compress(text, ContentEncoding::Gzip);
+  std::string deflate = compress(text, ContentEncoding::Deflate);
+
+  // gzip starts with its magic bytes, zlib's deflate with its own header
+  ASSERT_GE(gzip.size(), 2u);
+  EXPECT_EQ(static_cast<unsigned char>(gzip[0]), 0x1f);
+  EXPECT_EQ(static_cast<unsigned char>(gzip[1]), 0x8b);
+  EXPECT_EQ(static_cast<unsigned char>(deflate[0]) & 0x0f, 8);
+  EXPECT_LT(gzip.size(), text.size() / 5);
+  EXPECT_EQ(decompress(gzip), text);
+  EXPECT_EQ(decompress(deflate), text);
+
+  EXPECT_EQ(compress(text, ContentEncoding::Identity), text);
+  EXPECT_EQ(decompress(compress("", ContentEncoding::Gzip)), "");
+  EXPECT_STREQ(contentEncodingName(ContentEncoding::Gzip), "gzip");
+  EXPECT_STREQ(contentEncodingName(ContentEncoding::Deflate), "deflate");
+  EXPECT_STREQ(contentEncodingName(ContentEncoding::Identity), "identity");
+}
+
+TEST(CompressionUnitTests, CompressingStreamBufTest) {
+  // Written in pieces, and larger than one block of output
+  std::string text = catalogText(20000);
+  for (ContentEncoding encoding :
+       {ContentEncoding::Gzip, ContentEncoding::Deflate}) {
+    std::ostringstream sink;
+    CompressingStreamBuf compressor(sink.rdbuf(), encoding);
+    std::ostream out(&compressor);
+    for (size_t i = 0; i < text.size(); i += 1000) {
+      out.write(text.data() + i, std::min<size_t>(1000, text.size() - i));
+    }
+    out.put('!');
+    ASSERT_TRUE(compressor.finish());
+    EXPECT_GT(sink.str().size(), 16384u);
+    EXPECT_EQ(decompress(sink.str()), text + "!");
+  }
+
+  std::ostringstream sink;
+  EXPECT_THROW(CompressingStreamBuf(sink.rdbuf(), ContentEncoding::Identity),
+               std::invalid_argument);
+}
@@ -0,0 +1,79 @@
+// Copyright 2024 Maria Surani
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "CourseIndex.h"
+
+namespace {
+
+std::vector<std::string> describe(
+    const std::vector<CourseIndex::Match>& courses) {
+  std::vector<std::string> result;
+  for (const auto& course : courses) {
+    result.push_back(course.deptCode + " " +
+                     std::to_string(course.courseNumber));
+  }
+  return result;
+}
+
+std::map<std::string, Department> makeDepartments() {
+  std::map<std::string, Department> departments;
+  departments["COMS"] = Department(
+      "COMS",
+      {{4156, Course(120, "Gail Kaiser", "501 NWC", "10:10-11:25")},
+       {1004, Course(400, "Adam Cannon", "417 IAB", "11:40-12:55")},
+       {6156, Course(40, "Gail Kaiser", "", "2:40-3:55")}},
+      "Luca Carloni", 2700);
+  departments["CHEM"] = Department(
+      "CHEM", {{1403, Course(120, "Gail Kaiser", "309 HAV", "6:10-7:25")}},
+      "Laura J. Kaufman", 250);
+  return departments;
+}
+
+}  // namespace
+
+TEST(CourseIndexUnitTests, RebuildTest) {
+  CourseIndex instructors(&Course::getInstructorName);
+  instructors.rebuild(makeDepartments());
+  EXPECT_EQ(instructors.getValueCount(), 2u);
+  EXPECT_EQ(describe(instructors.findCourses("Gail Kaiser")),
+            (std::vector<std::string>{"CHEM 1403", "COMS 4156", "COMS 6156"}));
+  EXPECT_TRUE(instructors.findCourses("Jae Lee").empty());
+
+  // Courses without a value are not indexed
+  CourseIndex locations(&Course::getCourseLocation);
+  locations.rebuild(makeDepartments());
+  EXPECT_EQ(locations.getValueCount(), 3u);
+  EXPECT_TRUE(locations.findCourses("").empty());
+
+  instructors.rebuild({});
+  EXPECT_EQ(instructors.getValueCount(), 0u);
+}
+
+TEST(CourseIndexUnitTests, UpdateTest) {
+  auto departments = makeDepartments();
+  CourseIndex instructors(&Course::getInstructorName);
+  instructors.rebuild(departments);
+
+  Course* course = departments["COMS"].findCourse(1004);
+  instructors.update("COMS", 1004, *course, "Gail Kaiser");
+  course->reassignInstructor("Gail Kaiser");
+  EXPECT_EQ(describe(instructors.findCourses("Gail Kaiser")),
+            (std::vector<std::string>{"CHEM 1403", "COMS 1004", "COMS 4156",
+                                      "COMS 6156"}));
+  // A value left without courses is removed
+  EXPECT_TRUE(instructors.findCourses("Adam Cannon").empty());
+  EXPECT_EQ(instructors.getValueCount(), 1u);
+
+  // Setting the same value changes nothing
+  instructors.update("COMS", 1004, *course, "Gail Kaiser");
+  EXPECT_EQ(instructors.findCourses("Gail Kaiser").size(), 4u);
+
+  instructors.update("COMS", 1004, *course, "");
+  course->reassignInstructor("");
+  EXPECT_EQ(instructors.findCourses("Gail Kaiser").size(), 3u);
+  EXPECT_EQ(instructors.getValueCount(), 1u);
+}
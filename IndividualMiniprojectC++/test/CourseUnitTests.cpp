@@ -22,18 +22,87 @@ TEST_F(CourseUnitTests, ToStringTest) {
   ASSERT_EQ(expectedResult, course->display());
 }
 
+TEST_F(CourseUnitTests, WriteJsonFieldsTest) {
+  std::string json;
+  JsonWriter writer(&json);
+  writer.beginObject();
+  course->writeJsonFields(writer);
+  writer.endObject();
+  ASSERT_EQ(json,
+            "{\"instructor\":\"Griffin Newbold\",\"location\":\"417 IAB\","
+            "\"time\":\"11:40-12:55\"}");
+}
+
 TEST_F(CourseUnitTests, EnrollStudentTest) {
   course->setEnrolledStudentCount(249);
   course->enrollStudent();
   ASSERT_TRUE(course->isCourseFull());
 }
 
+TEST_F(CourseUnitTests, EnrollStudentReturnTest) {
+  course->setEnrolledStudentCount(249);
+  ASSERT_TRUE(course->enrollStudent());
+  ASSERT_EQ(course->getEnrolledStudentCount(), 250);
+  ASSERT_FALSE(course->enrollStudent());
+  ASSERT_EQ(course->getEnrolledStudentCount(), 250);
+}
+
 TEST_F(CourseUnitTests, DropStudentTest) {
   course->setEnrolledStudentCount(250);
   course->dropStudent();
   ASSERT_FALSE(course->isCourseFull());
 }
 
+TEST_F(CourseUnitTests, DropStudentNeverNegativeTest) {
+  course->setEnrolledStudentCount(0);
+  ASSERT_FALSE(course->dropStudent());
+  ASSERT_EQ(course->getEnrolledStudentCount(), 0);
+}
+
+TEST_F(CourseUnitTests, EnrollStudentByIdTest) {
+  Course small(2, "Griffin Newbold", "417 IAB", "11:40-12:55");
+  ASSERT_TRUE(small.enrollStudent(4156));
+  ASSERT_FALSE(small.enrollStudent(4156));
+  ASSERT_TRUE(small.isStudentEnrolled(4156));
+  ASSERT_TRUE(small.enrollStudent());
+  // A full course takes no one, by ID or not
+  ASSERT_FALSE(small.enrollStudent(17));
+  ASSERT_FALSE(small.isStudentEnrolled(17));
+  ASSERT_EQ(small.getEnrolledStudentCount(), 2);
+  ASSERT_EQ(small.getRoster().size(), 1u);
+}
+
+TEST_F(CourseUnitTests, DropStudentByIdTest) {
+  Course small(2, "Griffin Newbold", "417 IAB", "11:40-12:55");
+  small.enrollStudent(4156);
+  ASSERT_FALSE(small.dropStudent(17));
+  // Students on the roster can only be dropped by ID
+  ASSERT_FALSE(small.dropStudent());
+  ASSERT_TRUE(small.dropStudent(4156));
+  ASSERT_FALSE(small.isStudentEnrolled(4156));
+  ASSERT_EQ(small.getEnrolledStudentCount(), 0);
+}
+
+TEST_F(CourseUnitTests, WaitlistTest) {
+  Course small(1, "Griffin Newbold", "417 IAB", "11:40-12:55");
+  small.enrollStudent(4156);
+  ASSERT_FALSE(small.joinWaitlist(4156));
+  ASSERT_TRUE(small.joinWaitlist(17));
+  ASSERT_TRUE(small.joinWaitlist(18));
+  ASSERT_FALSE(small.joinWaitlist(18));
+  ASSERT_EQ(small.getWaitlistPosition(18), 2u);
+
+  uint32_t promoted = 0;
+  ASSERT_FALSE(small.promoteFromWaitlist(&promoted));
+  ASSERT_TRUE(small.dropStudent(4156));
+  ASSERT_TRUE(small.promoteFromWaitlist(&promoted));
+  ASSERT_EQ(promoted, 17u);
+  ASSERT_TRUE(small.isStudentEnrolled(17));
+  ASSERT_EQ(small.getWaitlistPosition(18), 1u);
+  ASSERT_TRUE(small.leaveWaitlist(18));
+  ASSERT_TRUE(small.getWaitlist().empty());
+}
+
 TEST_F(CourseUnitTests, GetCourseLocationTest) {
   ASSERT_EQ(course->getCourseLocation(), "417 IAB");
 }
@@ -57,7 +126,11 @@ TEST_F(CourseUnitTests, ReassignLocationTest) {
 }
 
 TEST_F(CourseUnitTests, ReassignTimeTest) {
-  course->reassignTime("13:00-14:00");
+  ASSERT_TRUE(course->reassignTime("13:00-14:00"));
+  ASSERT_EQ(course->getCourseTimeSlot(), "13:00-14:00");
+  ASSERT_EQ(course->getTimeSlot().getStartMinute(), 13 * 60);
+
+  ASSERT_FALSE(course->reassignTime("sometime"));
   ASSERT_EQ(course->getCourseTimeSlot(), "13:00-14:00");
 }
 
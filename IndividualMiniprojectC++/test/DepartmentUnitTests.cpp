@@ -1,7 +1,7 @@
 // Copyright 2024 Maria Surani
 #include <gtest/gtest.h>
-#include <memory>
 #include <sstream>
+#include <vector>
 
 #include "Department.h"
 #include "Course.h"
@@ -11,11 +11,10 @@ using namespace std;
 class DepartmentUnitTests : public ::testing::Test {
  protected:
   static Department* testDepartment;
-  static shared_ptr<Course> testCourse;
 
   static void SetUpTestSuite() {
-    testCourse = make_shared<Course>(250, "Griffin Newbold", "417 IAB", "11:40-12:55");
-    testDepartment = new Department("COMS", {{"1001", testCourse}}, "John Doe", 500);
+    Course testCourse(250, "Griffin Newbold", "417 IAB", "11:40-12:55");
+    testDepartment = new Department("COMS", {{1001, testCourse}}, "John Doe", 500);
   }
 
   static void TearDownTestSuite() {
@@ -24,7 +23,6 @@ class DepartmentUnitTests : public ::testing::Test {
 };
 
 Department* DepartmentUnitTests::testDepartment = nullptr;
-shared_ptr<Course> DepartmentUnitTests::testCourse = nullptr;
 
 TEST_F(DepartmentUnitTests, GetNumberOfMajorsTest) {
   ASSERT_EQ(testDepartment->getNumberOfMajors(), 500);
@@ -34,10 +32,31 @@ TEST_F(DepartmentUnitTests, GetDepartmentChairTest) {
   ASSERT_EQ(testDepartment->getDepartmentChair(), "John Doe");
 }
 
+TEST_F(DepartmentUnitTests, WriteJsonTest) {
+  std::string json;
+  JsonWriter writer(&json);
+  testDepartment->writeJson(writer);
+  ASSERT_EQ(json,
+            "{\"deptCode\":\"COMS\",\"courses\":[{\"courseCode\":1001,"
+            "\"instructor\":\"Griffin Newbold\",\"location\":\"417 IAB\","
+            "\"time\":\"11:40-12:55\"}]}");
+}
+
 TEST_F(DepartmentUnitTests, GetCourseSelectionTest) {
-  auto courses = testDepartment->getCourseSelection();
-  ASSERT_EQ(courses.size(), 1);
-  ASSERT_EQ(courses["1001"], testCourse);
+  ASSERT_EQ(testDepartment->getCourseNumbers(), vector<int>({1001}));
+  ASSERT_EQ(testDepartment->getCourses().size(), 1);
+  ASSERT_EQ(testDepartment->getCourses()[0].getInstructorName(), "Griffin Newbold");
+}
+
+TEST_F(DepartmentUnitTests, FindCourseTest) {
+  const Course* course = testDepartment->findCourse(1001);
+  ASSERT_NE(course, nullptr);
+  ASSERT_EQ(course, &testDepartment->getCourses()[0]);
+  ASSERT_EQ(testDepartment->findCourse("1001"), course);
+  ASSERT_EQ(testDepartment->findCourse(9999), nullptr);
+  ASSERT_EQ(testDepartment->findCourse("9999"), nullptr);
+  ASSERT_EQ(testDepartment->findCourse("10a1"), nullptr);
+  ASSERT_EQ(testDepartment->findCourse(""), nullptr);
 }
 
 TEST_F(DepartmentUnitTests, AddPersonToMajorTest) {
@@ -54,20 +73,18 @@ TEST_F(DepartmentUnitTests, DropPersonFromMajorTest) {
 }
 
 TEST_F(DepartmentUnitTests, AddCourseTest) {
-  auto newCourse = make_shared<Course>(100, "Maria Surani", "301 URIS", "10:00-11:00");
-  testDepartment->addCourse("2002", newCourse);
+  Course newCourse(100, "Maria Surani", "301 URIS", "10:00-11:00");
+  testDepartment->addCourse(2002, newCourse);
   
-  auto courses = testDepartment->getCourseSelection();
-  ASSERT_EQ(courses.size(), 2);
-  ASSERT_EQ(courses["2002"], newCourse);
+  ASSERT_EQ(testDepartment->getCourses().size(), 2);
+  ASSERT_EQ(testDepartment->findCourse(2002)->getInstructorName(), "Maria Surani");
 }
 
 TEST_F(DepartmentUnitTests, CreateCourseTest) {
-  testDepartment->createCourse("2003", "Jane Doe", "101 IAB", "2:00-3:00", 150);
+  testDepartment->createCourse(2003, "Jane Doe", "101 IAB", "2:00-3:00", 150);
 
-  auto courses = testDepartment->getCourseSelection();
-  ASSERT_EQ(courses.size(), 3);
-  ASSERT_EQ(courses["2003"]->getInstructorName(), "Jane Doe");
+  ASSERT_EQ(testDepartment->getCourses().size(), 3);
+  ASSERT_EQ(testDepartment->findCourse(2003)->getInstructorName(), "Jane Doe");
 }
 
 TEST_F(DepartmentUnitTests, DisplayTest) {
@@ -89,9 +106,22 @@ TEST_F(DepartmentUnitTests, SerializeDeserializeTest) {
   ASSERT_EQ(deserializedDepartment.getDepartmentChair(), testDepartment->getDepartmentChair());
   ASSERT_EQ(deserializedDepartment.getNumberOfMajors(), testDepartment->getNumberOfMajors());
 
-  auto deserializedCourses = deserializedDepartment.getCourseSelection();
-  auto originalCourses = testDepartment->getCourseSelection();
-  ASSERT_EQ(deserializedCourses.size(), originalCourses.size());
-  ASSERT_EQ(deserializedCourses["1001"]->getInstructorName(), originalCourses["1001"]->getInstructorName());
-  ASSERT_EQ(deserializedCourses["1001"]->getCourseLocation(), originalCourses["1001"]->getCourseLocation());
+  ASSERT_EQ(deserializedDepartment.getCourseNumbers(), testDepartment->getCourseNumbers());
+  const Course* deserializedCourse = deserializedDepartment.findCourse(1001);
+  const Course* originalCourse = testDepartment->findCourse(1001);
+  ASSERT_EQ(deserializedCourse->getInstructorName(), originalCourse->getInstructorName());
+  ASSERT_EQ(deserializedCourse->getCourseLocation(), originalCourse->getCourseLocation());
+}
+
+TEST_F(DepartmentUnitTests, CoursesStaySortedTest) {
+  Department dept("MATH", {}, "Jane Doe", 10);
+  dept.createCourse(3000, "A", "1 MATH", "1:10-2:25", 10);
+  dept.createCourse(999, "B", "2 MATH", "1:10-2:25", 10);
+  dept.createCourse(1500, "C", "3 MATH", "1:10-2:25", 10);
+  dept.createCourse(999, "D", "4 MATH", "1:10-2:25", 10);
+
+  ASSERT_EQ(dept.getCourseNumbers(), vector<int>({999, 1500, 3000}));
+  ASSERT_EQ(dept.findCourse(999)->getInstructorName(), "D");
+  ASSERT_EQ(dept.findCourse(1500)->getInstructorName(), "C");
+  ASSERT_EQ(dept.findCourse(3000)->getInstructorName(), "A");
 }
@@ -0,0 +1,47 @@
+// Copyright 2024 Maria Surani
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "JsonWriter.h"
+
+TEST(JsonWriterUnitTests, NestingAndCommasTest) {
+  std::string out = "prefix:";
+  JsonWriter writer(&out);
+  writer.beginObject().key("deptCode").value("COMS");
+  writer.key("courses").beginArray();
+  writer.beginObject().key("courseCode").value(1004).endObject();
+  writer.beginObject().key("courseCode").value(3157).endObject();
+  writer.endArray();
+  writer.key("empty").beginArray().endArray();
+  writer.key("full").value(true).key("open").value(false);
+  writer.endObject();
+  EXPECT_EQ(out,
+            "prefix:{\"deptCode\":\"COMS\",\"courses\":[{\"courseCode\":1004},"
+            "{\"courseCode\":3157}],\"empty\":[],\"full\":true,"
+            "\"open\":false}");
+}
+
+TEST(JsonWriterUnitTests, NumbersTest) {
+  std::string out;
+  JsonWriter writer(&out);
+  writer.beginArray().value(0).value(-42).value(
+      std::numeric_limits<int64_t>::min());
+  writer.value(std::numeric_limits<int64_t>::max()).endArray();
+  EXPECT_EQ(out,
+            "[0,-42,-9223372036854775808,9223372036854775807]");
+}
+
+TEST(JsonWriterUnitTests, EscapingTest) {
+  std::string out;
+  JsonWriter writer(&out);
+  writer.beginArray();
+  writer.value(std::string("say \"hi\"\\ \n\t\r\x01 \xc3\xa9"));
+  writer.value(std::string("no escapes"));
+  writer.endArray();
+  EXPECT_EQ(out,
+            "[\"say \\\"hi\\\"\\\\ \\n\\t\\r\\u0001 \xc3\xa9\","
+            "\"no escapes\"]");
+}
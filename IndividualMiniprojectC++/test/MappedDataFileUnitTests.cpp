@@ -0,0 +1,252 @@
+// Copyright 2024 Maria Surani
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Crc32.h"
+#include "MappedDataFile.h"
+
+namespace {
+
+const char* kDataPath = "mapped_unit_test.bin";
+
+std::map<std::string, Department> makeMapping() {
+  Course coms1004(400, "Adam Cannon", "417 IAB", "11:40-12:55");
+  coms1004.setEnrolledStudentCount(249);
+  Course coms3134(250, "Brian Borowski", "301 URIS", "4:10-5:25");
+  Course coms4995(110, "Brian Borowski", "301 URIS", "6:10-7:25");
+  Course econ1105(210, "Waseem Noor", "309 HAV", "2:40-3:55");
+  // 995 sorts after 4995 as a string but before it as a number
+  return {{"COMS", Department("COMS",
+                              {{995, coms4995},
+                               {1004, coms1004},
+                               {3134, coms3134},
+                               {4995, coms4995}},
+                              "Luca Carloni", 2700)},
+          {"ECON", Department("ECON", {{1105, econ1105}}, "Michael Woodford",
+                              2345)},
+          {"EMPTY", Department("EMPTY", {}, "", 0)}};
+}
+
+void writeMappedFile(const std::map<std::string, Department>& mapping,
+                     uint64_t lsn) {
+  std::vector<std::string> blocks;
+  for (const auto& it : mapping) {
+    blocks.push_back(MappedDataFile::encodeDepartment(it.first, it.second));
+  }
+  std::vector<const std::string*> blockPointers;
+  for (const auto& block : blocks) blockPointers.push_back(&block);
+
+  std::ofstream out(kDataPath, std::ios::binary | std::ios::trunc);
+  out << MappedDataFile::encodeIndex(blockPointers, lsn);
+  for (const auto& block : blocks) out << block;
+}
+
+// Rewrites a block in the layout of version 2 or 3, whose course records
+// end before the roster or the waitlist. Every string moves up by the bytes
+// removed.
+std::string toOlderBlock(const std::string& block, uint32_t version) {
+  const size_t kDepartmentRecordSize = 24;
+  const size_t kCourseRecordSize = 56;
+  const size_t olderCourseRecordSize = version == 2 ? 40 : 48;
+  uint32_t courseCount;
+  std::memcpy(&courseCount, block.data() + 20, sizeof(courseCount));
+  const uint32_t removed =
+      courseCount * (kCourseRecordSize - olderCourseRecordSize);
+  auto moveString = [removed](std::string* out, size_t at) {
+    uint32_t offset;
+    std::memcpy(&offset, out->data() + at, sizeof(offset));
+    offset -= removed;
+    std::memcpy(&(*out)[at], &offset, sizeof(offset));
+  };
+
+  std::string out = block.substr(0, kDepartmentRecordSize);
+  moveString(&out, 0);
+  moveString(&out, 8);
+  for (uint32_t i = 0; i < courseCount; ++i) {
+    size_t at = out.size();
+    out.append(block, kDepartmentRecordSize + i * kCourseRecordSize,
+               olderCourseRecordSize);
+    for (size_t field = 0; field < 4; ++field) moveString(&out, at + field * 8);
+    if (version == 3) moveString(&out, at + 40);
+  }
+  out.append(block, kDepartmentRecordSize + courseCount * kCourseRecordSize,
+             std::string::npos);
+  return out;
+}
+
+void writeOlderFile(const std::map<std::string, Department>& mapping,
+                    uint32_t version) {
+  std::vector<std::string> blocks;
+  for (const auto& it : mapping) {
+    blocks.push_back(toOlderBlock(
+        MappedDataFile::encodeDepartment(it.first, it.second), version));
+  }
+  std::vector<const std::string*> blockPointers;
+  for (const auto& block : blocks) blockPointers.push_back(&block);
+
+  // The header checksum covers the version and the directory
+  std::string index = MappedDataFile::encodeIndex(blockPointers, 0);
+  index[8] = static_cast<char>(version);
+  uint32_t checksum = crc32(index.data(), 28);
+  checksum = crc32(index.data() + 32, index.size() - 32, checksum);
+  std::memcpy(&index[28], &checksum, sizeof(checksum));
+
+  std::ofstream out(kDataPath, std::ios::binary | std::ios::trunc);
+  out << index;
+  for (const auto& block : blocks) out << block;
+}
+
+void overwriteByte(long offset, char value) {  // NOLINT(runtime/int)
+  std::FILE* file = std::fopen(kDataPath, "r+b");
+  std::fseek(file, offset, SEEK_SET);
+  std::fputc(value, file);
+  std::fclose(file);
+}
+
+}  // namespace
+
+class MappedDataFileUnitTests : public ::testing::Test {
+ protected:
+  void SetUp() override { writeMappedFile(makeMapping(), 42); }
+  void TearDown() override { std::remove(kDataPath); }
+};
+
+TEST_F(MappedDataFileUnitTests, ReadAllTest) {
+  MappedDataFile file(kDataPath);
+  EXPECT_EQ(file.getCheckpointLsn(), 42u);
+  ASSERT_EQ(file.getDepartmentCount(), 3u);
+  EXPECT_EQ(file.getDepartmentCode(0), "COMS");
+
+  auto mapping = file.readAll();
+  auto expected = makeMapping();
+  ASSERT_EQ(mapping.size(), expected.size());
+  for (const auto& it : expected) {
+    ASSERT_TRUE(mapping.count(it.first));
+    EXPECT_EQ(mapping.at(it.first).display(), it.second.display());
+    EXPECT_EQ(mapping.at(it.first).getNumberOfMajors(),
+              it.second.getNumberOfMajors());
+    EXPECT_EQ(mapping.at(it.first).getDepartmentChair(),
+              it.second.getDepartmentChair());
+  }
+}
+
+TEST_F(MappedDataFileUnitTests, ReadCourseTest) {
+  MappedDataFile file(kDataPath);
+  Course course;
+  ASSERT_TRUE(file.readCourse("COMS", 1004, course));
+  EXPECT_EQ(course.getInstructorName(), "Adam Cannon");
+  EXPECT_EQ(course.getCourseLocation(), "417 IAB");
+  EXPECT_EQ(course.getCourseTimeSlot(), "11:40-12:55");
+  EXPECT_EQ(course.getEnrollmentCapacity(), 400);
+  EXPECT_EQ(course.getEnrolledStudentCount(), 249);
+
+  EXPECT_TRUE(file.readCourse("COMS", 995, course));
+  EXPECT_TRUE(file.readCourse("COMS", 3134, course));
+  EXPECT_TRUE(file.readCourse("COMS", 4995, course));
+  EXPECT_TRUE(file.readCourse("ECON", 1105, course));
+  EXPECT_FALSE(file.readCourse("COMS", 9999, course));
+  EXPECT_FALSE(file.readCourse("EMPTY", 1004, course));
+  EXPECT_FALSE(file.readCourse("MATH", 1004, course));
+
+  Department dept;
+  EXPECT_TRUE(file.readDepartment("ECON", dept));
+  EXPECT_EQ(dept.getNumberOfMajors(), 2345);
+  EXPECT_FALSE(file.readDepartment("AAAA", dept));
+}
+
+TEST_F(MappedDataFileUnitTests, IsMappedFormatTest) {
+  EXPECT_TRUE(MappedDataFile::isMappedFormat(kDataPath));
+  EXPECT_FALSE(MappedDataFile::isMappedFormat("does_not_exist.bin"));
+
+  overwriteByte(0, 'X');
+  EXPECT_FALSE(MappedDataFile::isMappedFormat(kDataPath));
+  EXPECT_THROW(MappedDataFile file(kDataPath), std::runtime_error);
+}
+
+TEST_F(MappedDataFileUnitTests, CorruptHeaderIsRejectedTest) {
+  // Flips a byte of the checkpoint LSN
+  overwriteByte(16, 7);
+  EXPECT_THROW(MappedDataFile file(kDataPath), std::runtime_error);
+}
+
+TEST_F(MappedDataFileUnitTests, CorruptBlockIsRejectedTest) {
+  // The COMS block follows the 32 byte header and three directory entries;
+  // this flips a byte of its first course record
+  overwriteByte(32 + 3 * 16 + 24, 'Z');
+
+  MappedDataFile file(kDataPath);
+  EXPECT_EQ(file.getDepartmentCount(), 3u);
+  Course course;
+  EXPECT_THROW(file.readCourse("COMS", 1004, course), std::runtime_error);
+  EXPECT_TRUE(file.readCourse("ECON", 1105, course));
+}
+
+TEST_F(MappedDataFileUnitTests, RepeatedStringsAreWrittenOnceTest) {
+  auto encode = [](const std::string& secondInstructor) {
+    Course first(10, std::string(200, 'x'), "417 IAB", "1:10");
+    Course second(10, secondInstructor, "417 IAB", "1:10");
+    return MappedDataFile::encodeDepartment(
+        "COMS", Department("COMS", {{1004, first}, {3134, second}}, "Chair", 0));
+  };
+  std::string shared = encode(std::string(200, 'x'));
+  std::string distinct = encode(std::string(200, 'y'));
+  EXPECT_LE(shared.size() + 200, distinct.size());
+}
+
+TEST_F(MappedDataFileUnitTests, RostersRoundTripTest) {
+  Course course(4, "Adam Cannon", "417 IAB", "11:40-12:55");
+  for (uint32_t studentId : {4156u, 17u, 4294967295u}) {
+    ASSERT_TRUE(course.enrollStudent(studentId));
+  }
+  course.enrollStudent();
+  ASSERT_TRUE(course.joinWaitlist(99));
+  ASSERT_TRUE(course.joinWaitlist(5));
+  writeMappedFile({{"COMS", Department("COMS", {{1004, course}}, "", 0)}}, 0);
+
+  MappedDataFile file(kDataPath);
+  Course read;
+  ASSERT_TRUE(file.readCourse("COMS", 1004, read));
+  EXPECT_EQ(read.getRoster().getStudentIds(),
+            (std::vector<uint32_t>{17, 4156, 4294967295u}));
+  EXPECT_EQ(read.getEnrolledStudentCount(), 4);
+  EXPECT_TRUE(read.isStudentEnrolled(4156));
+  EXPECT_FALSE(read.isStudentEnrolled(4157));
+  EXPECT_EQ(read.getWaitlist().getStudentIds(),
+            (std::vector<uint32_t>{99, 5}));
+}
+
+TEST_F(MappedDataFileUnitTests, Version2FileIsReadTest) {
+  writeOlderFile(makeMapping(), 2);
+
+  MappedDataFile file(kDataPath);
+  auto mapping = file.readAll();
+  auto expected = makeMapping();
+  ASSERT_EQ(mapping.size(), expected.size());
+  for (const auto& it : expected) {
+    EXPECT_EQ(mapping.at(it.first).display(), it.second.display());
+  }
+  Course course;
+  ASSERT_TRUE(file.readCourse("COMS", 1004, course));
+  EXPECT_EQ(course.getEnrolledStudentCount(), 249);
+  EXPECT_EQ(course.getRoster().size(), 0u);
+}
+
+TEST_F(MappedDataFileUnitTests, Version3FileIsReadTest) {
+  Course course(1, "Adam Cannon", "417 IAB", "11:40-12:55");
+  course.enrollStudent(4156);
+  writeOlderFile({{"COMS", Department("COMS", {{1004, course}}, "", 0)}}, 3);
+
+  MappedDataFile file(kDataPath);
+  Course read;
+  ASSERT_TRUE(file.readCourse("COMS", 1004, read));
+  EXPECT_TRUE(read.isStudentEnrolled(4156));
+  EXPECT_TRUE(read.getWaitlist().empty());
+}
@@ -0,0 +1,132 @@
+// Copyright 2024 Maria Surani
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Metrics.h"
+
+TEST(MetricsUnitTests, AddRouteTest) {
+  Metrics metrics;
+  EXPECT_EQ(metrics.addRoute("/retrieveDept"), 0);
+  EXPECT_EQ(metrics.addRoute("/retrieveCourse"), 1);
+  EXPECT_EQ(metrics.addRoute("/retrieveDept"), 0);
+  for (int i = 2; i < Metrics::kMaxRoutes; ++i) {
+    metrics.addRoute("/route" + std::to_string(i));
+  }
+  EXPECT_THROW(metrics.addRoute("/oneTooMany"), std::length_error);
+}
+
+TEST(MetricsUnitTests, RecordTest) {
+  Metrics metrics;
+  int dept = metrics.addRoute("/retrieveDept");
+  int course = metrics.addRoute("/retrieveCourse");
+
+  metrics.record(dept, 200, std::chrono::microseconds(30));
+  metrics.record(dept, 200, std::chrono::microseconds(120));
+  metrics.record(dept, 404, std::chrono::seconds(3));
+  metrics.record(dept, 418, std::chrono::microseconds(50));
+
+  EXPECT_EQ(metrics.getRequestCount(dept), 4u);
+  EXPECT_EQ(metrics.getRequestCount(course), 0u);
+  EXPECT_EQ(metrics.getStatusCount(dept, 200), 2u);
+  EXPECT_EQ(metrics.getStatusCount(dept, 404), 1u);
+  EXPECT_EQ(metrics.getStatusCount(dept, 418), 1u);
+  EXPECT_EQ(metrics.getStatusCount(dept, 500), 0u);
+  // Bucket bounds are inclusive, and the last bucket has none
+  EXPECT_EQ(metrics.getBucketCount(dept, 0), 2u);
+  EXPECT_EQ(metrics.getBucketCount(dept, 2), 1u);
+  EXPECT_EQ(metrics.getBucketCount(dept, Metrics::kBucketCount - 1), 1u);
+}
+
+TEST(MetricsUnitTests, RenderTest) {
+  Metrics metrics;
+  int route = metrics.addRoute("/isCourseFull");
+  metrics.addRoute("/idDeptChair");
+  metrics.record(route, 200, std::chrono::microseconds(40));
+  metrics.record(route, 200, std::chrono::microseconds(700));
+  metrics.record(route, 503, std::chrono::microseconds(80));
+
+  std::string text = metrics.render();
+  EXPECT_NE(text.find("# TYPE http_requests_total counter\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("http_requests_total{route=\"/isCourseFull\","
+                      "code=\"200\"} 2\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("http_requests_total{route=\"/isCourseFull\","
+                      "code=\"other\"} 1\n"),
+            std::string::npos);
+  EXPECT_EQ(text.find("http_requests_total{route=\"/idDeptChair\""),
+            std::string::npos);
+
+  EXPECT_NE(text.find("# TYPE http_request_duration_seconds histogram\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("http_request_duration_seconds_bucket{route=\""
+                      "/isCourseFull\",le=\"0.00005\"} 1\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("http_request_duration_seconds_bucket{route=\""
+                      "/isCourseFull\",le=\"0.0001\"} 2\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("http_request_duration_seconds_bucket{route=\""
+                      "/isCourseFull\",le=\"1\"} 3\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("http_request_duration_seconds_bucket{route=\""
+                      "/isCourseFull\",le=\"+Inf\"} 3\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("http_request_duration_seconds_sum{route=\""
+                      "/isCourseFull\"} 0.00082\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("http_request_duration_seconds_count{route=\""
+                      "/idDeptChair\"} 0\n"),
+            std::string::npos);
+}
+
+TEST(MetricsUnitTests, TimerTest) {
+  Metrics metrics;
+  int route = metrics.addRoute("/enrollStudentInCourse");
+  int status = 200;
+  {
+    Metrics::Timer timer(&metrics, route, &status);
+    // The status at the end of the request is the one recorded
+    status = 409;
+  }
+  EXPECT_EQ(metrics.getStatusCount(route, 409), 1u);
+  EXPECT_EQ(metrics.getStatusCount(route, 200), 0u);
+}
+
+TEST(MetricsUnitTests, ConcurrentRecordTest) {
+  const int kThreads = 8;
+  const int kRequests = 10000;
+  Metrics metrics;
+  int route = metrics.addRoute("/retrieveCourse");
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&metrics, route]() {
+      for (int i = 0; i < kRequests; ++i) {
+        metrics.record(route, 200, std::chrono::microseconds(i % 1000));
+      }
+    });
+  }
+  // Scraping while requests are recorded must be safe
+  for (int i = 0; i < 10; ++i) metrics.render();
+  for (auto& thread : threads) thread.join();
+
+  EXPECT_EQ(metrics.getRequestCount(route),
+            static_cast<uint64_t>(kThreads * kRequests));
+  EXPECT_EQ(metrics.getStatusCount(route, 200),
+            static_cast<uint64_t>(kThreads * kRequests));
+}
+
+TEST(MetricsUnitTests, SeparateInstancesTest) {
+  // A thread's shard belongs to one Metrics object only
+  Metrics first;
+  Metrics second;
+  int route = first.addRoute("/retrieveDept");
+  second.addRoute("/retrieveDept");
+  first.record(route, 200, std::chrono::microseconds(10));
+  EXPECT_EQ(first.getRequestCount(route), 1u);
+  EXPECT_EQ(second.getRequestCount(route), 0u);
+}
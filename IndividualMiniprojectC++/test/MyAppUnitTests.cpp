@@ -63,10 +63,10 @@ TEST(MyAppUnitTests, SetupRunTest) {
 TEST(MyAppUnitTests, OverrideDatabaseTest) {
     MyFileDatabase* customDb = new MyFileDatabase{1, ""};
 
-    std::shared_ptr<Course> course = std::make_shared<Course>(5, "Jane Doe", "100 CSP", "2:40-3:55");
-    course->setEnrolledStudentCount(3);
+    Course course(5, "Jane Doe", "100 CSP", "2:40-3:55");
+    course.setEnrolledStudentCount(3);
 
-    std::map<std::string, std::shared_ptr<Course>> coursesList = {{"156", course}};
+    std::map<int, Course> coursesList = {{156, course}};
     
     Department dept("CS", coursesList, "Joe Doe", 3000);
     std::map<std::string, Department> mapping = {{"CS", dept}};
@@ -87,15 +87,11 @@ TEST(MyAppUnitTests, OverrideDatabaseTest) {
     EXPECT_EQ(dbDeptOverriden.getDepartmentChair(), dept.getDepartmentChair());
     EXPECT_EQ(dbDeptOverriden.getNumberOfMajors(), dept.getNumberOfMajors());
 
-    const auto& dbCoursesOverriden = dbDeptOverriden.getCourseSelection();
+    ASSERT_EQ(dbDeptOverriden.getCourses().size(), coursesList.size());
+    const Course* dbCourse = dbDeptOverriden.findCourse(156);
+    ASSERT_NE(dbCourse, nullptr);
 
-    ASSERT_EQ(dbCoursesOverriden.size(), coursesList.size());
-    auto courseIt = dbCoursesOverriden.find("156");
-    ASSERT_NE(courseIt, dbCoursesOverriden.end());
-
-    const auto& dbCourse = courseIt->second;
-
-    EXPECT_EQ(dbCourse->getInstructorName(), course->getInstructorName());
-    EXPECT_EQ(dbCourse->getCourseLocation(), course->getCourseLocation());
-    EXPECT_EQ(dbCourse->getCourseTimeSlot(), course->getCourseTimeSlot());
+    EXPECT_EQ(dbCourse->getInstructorName(), course.getInstructorName());
+    EXPECT_EQ(dbCourse->getCourseLocation(), course.getCourseLocation());
+    EXPECT_EQ(dbCourse->getCourseTimeSlot(), course.getCourseTimeSlot());
 }
\ No newline at end of file
@@ -0,0 +1,418 @@
+// Copyright 2024 Maria Surani
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MyApp.h"
+#include "RouteController.h"
+
+// Build with -DENABLE_TSAN=ON to have ThreadSanitizer check these tests.
+
+namespace {
+
+const int kReaderThreads = 8;
+const int kWriterThreads = 8;
+const int kIterations = 300;
+
+using Handler = void (RouteController::*)(const crow::request&,
+                                          crow::response&);
+
+int sendRequest(RouteController& routeController, Handler handler,
+                const std::string& query) {
+  crow::request req{};
+  crow::response res{};
+  req.url_params = crow::query_string{query};
+  (routeController.*handler)(req, res);
+  return res.code;
+}
+
+}  // namespace
+
+TEST(MyFileDatabaseConcurrencyTests, ConcurrentReadsAndWritesTest) {
+  MyApp::run("setup");
+  MyFileDatabase* db = MyApp::getDatabase();
+  RouteController routeController;
+  routeController.setDatabase(db);
+
+  std::atomic<int> failedRequests{0};
+  std::vector<std::thread> threads;
+
+  for (int t = 0; t < kReaderThreads; ++t) {
+    threads.emplace_back([&]() {
+      for (int i = 0; i < kIterations; ++i) {
+        int codes[] = {
+            sendRequest(routeController, &RouteController::retrieveDepartment,
+                        "?deptCode=COMS"),
+            sendRequest(routeController, &RouteController::retrieveCourse,
+                        "?deptCode=COMS&courseCode=1004"),
+            sendRequest(routeController, &RouteController::isCourseFull,
+                        "?deptCode=PHYS&courseCode=1520"),
+            sendRequest(routeController, &RouteController::findCourseLocation,
+                        "?deptCode=COMS&courseCode=1004"),
+            sendRequest(routeController,
+                        &RouteController::getMajorCountFromDept,
+                        "?deptCode=ECON")};
+        for (int code : codes) {
+          if (code != 200) failedRequests++;
+        }
+      }
+    });
+  }
+
+  for (int t = 0; t < kWriterThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      std::string dept = t % 2 == 0 ? "COMS" : "PHYS";
+      for (int i = 0; i < kIterations; ++i) {
+        int codes[] = {
+            sendRequest(routeController, &RouteController::addMajorToDept,
+                        "?deptCode=" + dept),
+            sendRequest(routeController, &RouteController::setCourseLocation,
+                        "?deptCode=COMS&courseCode=1004&location=Room " +
+                            std::to_string(i)),
+            sendRequest(routeController, &RouteController::setEnrollmentCount,
+                        "?deptCode=PHYS&courseCode=1520&count=" +
+                            std::to_string(i))};
+        for (int code : codes) {
+          if (code != 200) failedRequests++;
+        }
+      }
+    });
+  }
+
+  threads.emplace_back([&]() {
+    for (int i = 0; i < kIterations / 10; ++i) {
+      if (db->display().empty()) failedRequests++;
+    }
+  });
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(failedRequests.load(), 0);
+  const int addsPerDept = kWriterThreads / 2 * kIterations;
+  EXPECT_EQ(db->findDepartment("COMS")->getNumberOfMajors(),
+            2700 + addsPerDept);
+  EXPECT_EQ(db->findDepartment("PHYS")->getNumberOfMajors(),
+            200 + addsPerDept);
+}
+
+TEST(MyFileDatabaseConcurrencyTests, ConcurrentEnrollmentNeverOvershootsTest) {
+  MyApp::run("setup");
+  MyFileDatabase* db = MyApp::getDatabase();
+  RouteController routeController;
+  routeController.setDatabase(db);
+
+  // COMS 1004 starts with 249 of 400 seats taken
+  std::atomic<int> enrolled{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kWriterThreads; ++t) {
+    threads.emplace_back([&]() {
+      for (int i = 0; i < 50; ++i) {
+        if (sendRequest(routeController,
+                        &RouteController::enrollStudentInCourse,
+                        "?deptCode=COMS&courseCode=1004") == 200) {
+          enrolled++;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(enrolled.load(), 151);
+  const Course* course = db->findDepartment("COMS")->findCourse("1004");
+  EXPECT_EQ(course->getEnrolledStudentCount(), 400);
+}
+
+TEST(MyFileDatabaseConcurrencyTests, SetMappingWhileReadingTest) {
+  MyFileDatabase db{1, ""};
+  Course course(5, "Jane Doe", "100 CSP", "2:40-3:55");
+  std::map<std::string, Department> mapping = {
+      {"CS", Department("CS", {{156, course}}, "Joe Doe", 3000)}};
+  db.setMapping(mapping);
+
+  std::atomic<bool> done{false};
+  std::atomic<int> missing{0};
+  std::thread reader([&]() {
+    while (!done) {
+      auto lock = db.acquireReadLock("CS");
+      const Department* dept = db.findDepartment("CS");
+      if (dept == nullptr || dept->findCourse("156") == nullptr) missing++;
+    }
+  });
+
+  for (int i = 0; i < kIterations; ++i) {
+    db.setMapping(mapping);
+  }
+  done = true;
+  reader.join();
+
+  EXPECT_EQ(missing.load(), 0);
+}
+
+TEST(MyFileDatabaseConcurrencyTests, CountsWhileSetMappingTest) {
+  MyFileDatabase db{1, ""};
+  Course course(5, "Jane Doe", "100 CSP", "2:40-3:55");
+  std::map<std::string, Department> one = {
+      {"CS", Department("CS", {{156, course}}, "Joe Doe", 3000)}};
+  std::map<std::string, Department> two = one;
+  two.emplace("MATH", Department("MATH", {{101, course}, {102, course}},
+                                 "Jane Roe", 20));
+  db.setMapping(one);
+
+  // /metrics reports these counts while the mapping may be replaced
+  std::atomic<bool> done{false};
+  std::atomic<int> invalid{0};
+  std::thread reader([&]() {
+    while (!done) {
+      size_t departments = db.getDepartmentCount();
+      size_t courses = db.getCourseCount();
+      if (departments < 1 || departments > 2 || courses < 1 || courses > 3) {
+        invalid++;
+      }
+    }
+  });
+
+  for (int i = 0; i < kIterations; ++i) {
+    db.setMapping(i % 2 == 0 ? two : one);
+  }
+  done = true;
+  reader.join();
+
+  EXPECT_EQ(invalid.load(), 0);
+}
+
+TEST(MyFileDatabaseConcurrencyTests, CachedReadsAreNeverStaleTest) {
+  MyApp::run("setup");
+  RouteController routeController;
+  routeController.setDatabase(MyApp::getDatabase());
+
+  // One writer moves COMS 1004 through rooms 0, 1, 2, ... so each reader
+  // must see the room numbers of the course and department in order.
+  std::atomic<bool> done{false};
+  std::atomic<int> staleReads{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kReaderThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      Handler handler = t % 2 == 0 ? &RouteController::retrieveCourse
+                                   : &RouteController::retrieveDepartment;
+      std::string query = t % 2 == 0 ? "?deptCode=COMS&courseCode=1004"
+                                     : "?deptCode=COMS";
+      int lastRoom = -1;
+      while (!done) {
+        crow::request req{};
+        crow::response res{};
+        req.url_params = crow::query_string{query};
+        (routeController.*handler)(req, res);
+        size_t at = res.body.find("Location: Room ");
+        if (at == std::string::npos) continue;
+        int room = std::stoi(res.body.substr(at + 15));
+        if (room < lastRoom) staleReads++;
+        lastRoom = room;
+        // Leaves the writer a gap: shared locks favour readers, so readers
+        // that never pause can hold off the writer for seconds
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+      }
+    });
+  }
+
+  const int kMoves = kIterations / 10;
+  for (int i = 0; i < kMoves; ++i) {
+    sendRequest(routeController, &RouteController::setCourseLocation,
+                "?deptCode=COMS&courseCode=1004&location=Room " +
+                    std::to_string(i));
+  }
+  done = true;
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(staleReads.load(), 0);
+  crow::request req{};
+  crow::response res{};
+  req.url_params = crow::query_string{"?deptCode=COMS&courseCode=1004"};
+  routeController.retrieveCourse(req, res);
+  EXPECT_NE(res.body.find("Location: Room " + std::to_string(kMoves - 1)),
+            std::string::npos);
+}
+
+TEST(MyFileDatabaseConcurrencyTests, BatchesAreSeenWholeTest) {
+  MyApp::run("setup");
+  MyFileDatabase* db = MyApp::getDatabase();
+  RouteController routeController;
+  routeController.setDatabase(db);
+
+  // Each batch moves COMS 1004 and PHYS 1001 into the same room, so every
+  // batch read of the two must find them in one room.
+  std::atomic<bool> done{false};
+  std::atomic<int> tornReads{0};
+  std::vector<MutationStatus> statuses;
+  db->applyMutations(
+      {{MutationType::ChangeLocation, "PHYS", "1001", "Room"},
+       {MutationType::ChangeLocation, "COMS", "1004", "Room"}},
+      &statuses);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kReaderThreads; ++t) {
+    threads.emplace_back([&]() {
+      while (!done) {
+        crow::request req{};
+        crow::response res{};
+        req.url_params =
+            crow::query_string{"?courses=COMS:1004,PHYS:1001"};
+        routeController.retrieveCourses(req, res);
+        size_t first = res.body.find("Location: ");
+        size_t second = res.body.find("Location: ", first + 1);
+        size_t firstEnd = res.body.find(';', first);
+        size_t secondEnd = res.body.find(';', second);
+        if (res.body.substr(first, firstEnd - first) !=
+            res.body.substr(second, secondEnd - second)) {
+          tornReads++;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+      }
+    });
+  }
+
+  const int kBatches = kIterations / 10;
+  for (int i = 0; i < kBatches; ++i) {
+    std::string room = "Room " + std::to_string(i);
+    EXPECT_TRUE(db->applyMutations(
+        {{MutationType::ChangeLocation, "PHYS", "1001", room},
+         {MutationType::ChangeLocation, "COMS", "1004", room}},
+        &statuses));
+    // Single changes of other departments run alongside
+    sendRequest(routeController, &RouteController::addMajorToDept,
+                "?deptCode=ECON");
+  }
+  done = true;
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(tornReads.load(), 0);
+}
+
+TEST(MyFileDatabaseConcurrencyTests, CatalogExportsAreOneSnapshotTest) {
+  MyApp::run("setup");
+  MyFileDatabase* db = MyApp::getDatabase();
+  RouteController routeController;
+  routeController.setDatabase(db);
+
+  // As above, each batch moves COMS 1004 and PHYS 1001 into the same room,
+  // so every export must find them in one room.
+  auto locationOf = [](const std::string& catalog, const std::string& course) {
+    size_t start = catalog.find("Location: ", catalog.find(course + ": "));
+    return catalog.substr(start, catalog.find(';', start) - start);
+  };
+  std::atomic<bool> done{false};
+  std::atomic<int> exports{0};
+  std::atomic<int> tornReads{0};
+  std::vector<MutationStatus> statuses;
+  db->applyMutations(
+      {{MutationType::ChangeLocation, "PHYS", "1001", "Room"},
+       {MutationType::ChangeLocation, "COMS", "1004", "Room"}},
+      &statuses);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kReaderThreads; ++t) {
+    threads.emplace_back([&]() {
+      while (!done) {
+        crow::request req{};
+        crow::response res{};
+        routeController.exportCatalog(req, res);
+        std::ifstream in(res.file, std::ios::binary);
+        std::ostringstream catalog;
+        catalog << in.rdbuf();
+        if (locationOf(catalog.str(), "COMS 1004") !=
+            locationOf(catalog.str(), "PHYS 1001")) {
+          tornReads++;
+        }
+        exports++;
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+      }
+    });
+  }
+
+  const int kBatches = kIterations / 10;
+  for (int i = 0; i < kBatches; ++i) {
+    std::string room = "Room " + std::to_string(i);
+    EXPECT_TRUE(db->applyMutations(
+        {{MutationType::ChangeLocation, "PHYS", "1001", room},
+         {MutationType::ChangeLocation, "COMS", "1004", room}},
+        &statuses));
+  }
+  done = true;
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_GT(exports.load(), 0);
+  EXPECT_EQ(tornReads.load(), 0);
+}
+
+TEST(MyFileDatabaseConcurrencyTests, WaitlistPromotionUnderLoadTest) {
+  MyApp::run("setup");
+  MyFileDatabase* db = MyApp::getDatabase();
+  RouteController routeController;
+  routeController.setDatabase(db);
+
+  // PHYS 1520 starts with all 400 seats taken by students without an ID.
+  // Students join its waitlist while others drop out.
+  const int kJoinsPerThread = 50;
+  const int kDropsPerThread = 25;
+  std::atomic<int> drops{0};
+  std::vector<std::atomic<bool>> joined(kWriterThreads * kJoinsPerThread);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kWriterThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < kJoinsPerThread; ++i) {
+        if (t % 2 == 0 || i < kDropsPerThread) {
+          int studentId = t * kJoinsPerThread + i;
+          joined[studentId] =
+              sendRequest(routeController, &RouteController::joinWaitlist,
+                          "?deptCode=PHYS&courseCode=1520&studentId=" +
+                              std::to_string(studentId)) == 200;
+        }
+        if (t % 2 == 1 && i < kDropsPerThread &&
+            sendRequest(routeController,
+                        &RouteController::dropStudentFromCourse,
+                        "?deptCode=PHYS&courseCode=1520") == 200) {
+          drops++;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  const Course* course = db->findDepartment("PHYS")->findCourse(1520);
+  const Roster& roster = course->getRoster();
+  const Waitlist& waitlist = course->getWaitlist();
+  // Students without an ID are dropped first, and every freed seat goes to
+  // someone waiting as long as anyone is
+  EXPECT_EQ(drops.load(), (kWriterThreads / 2) * kDropsPerThread);
+  EXPECT_EQ(course->getEnrolledStudentCount(),
+            400 - drops.load() + static_cast<int>(roster.size()));
+  if (!waitlist.empty()) {
+    EXPECT_EQ(course->getEnrolledStudentCount(), 400);
+  }
+  for (size_t studentId = 0; studentId < joined.size(); ++studentId) {
+    bool enrolled = roster.contains(static_cast<uint32_t>(studentId));
+    bool waiting =
+        waitlist.getPosition(static_cast<uint32_t>(studentId)) != 0;
+    EXPECT_FALSE(enrolled && waiting) << studentId;
+    EXPECT_EQ(joined[studentId].load(), enrolled || waiting) << studentId;
+    EXPECT_EQ(
+        db->getStudentIndex().findCourses(static_cast<uint32_t>(studentId))
+            .size(),
+        enrolled ? 1u : 0u);
+  }
+}
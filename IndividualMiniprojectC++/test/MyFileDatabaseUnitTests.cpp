@@ -1,12 +1,19 @@
 // Copyright 2024 Maria Surani
+#include "MappedDataFile.h"
 #include "MyFileDatabase.h"
 #include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
 
-void SetUpDatabase(MyFileDatabase& db, std::shared_ptr<Course>& course) {
-    course = std::make_shared<Course>(5, "Jane Doe", "100 CSP", "2:40-3:55");
-    course->setEnrolledStudentCount(3);
+void SetUpDatabase(MyFileDatabase& db) {
+    Course course(5, "Jane Doe", "100 CSP", "2:40-3:55");
+    course.setEnrolledStudentCount(3);
 
-    std::map<std::string, std::shared_ptr<Course>> coursesList = {{"156", course}};
+    std::map<int, Course> coursesList = {{156, course}};
     
     Department dept("CS", coursesList, "Joe Doe", 3000);
     std::map<std::string, Department> mapping = {{"CS", dept}};
@@ -16,8 +23,8 @@ void SetUpDatabase(MyFileDatabase& db, std::shared_ptr<Course>& course) {
 
 TEST(MyFileDatabaseUnitTests, SerializationTest) {
     MyFileDatabase db {1, "test.bin"};
-    std::shared_ptr<Course> originalCourse;
-    SetUpDatabase(db, originalCourse); 
+    SetUpDatabase(db);
+    const Course* originalCourse = db.findDepartment("CS")->findCourse(156);
     db.saveContentsToFile();
 
     MyFileDatabase deserializedDB {0, "test.bin"};
@@ -30,20 +37,34 @@ TEST(MyFileDatabaseUnitTests, SerializationTest) {
     EXPECT_EQ(deptDeserialized.getDepartmentChair(), "Joe Doe");
     EXPECT_EQ(deptDeserialized.getNumberOfMajors(), 3000);
 
-    auto deserialized_courses = deptDeserialized.getCourseSelection();
-    EXPECT_EQ(deserialized_courses.size(), 1);
+    EXPECT_EQ(deptDeserialized.getCourses().size(), 1);
 
-    auto deserialized_course = deserialized_courses.at("156");
+    const Course* deserialized_course = deptDeserialized.findCourse(156);
+    ASSERT_NE(deserialized_course, nullptr);
 
     EXPECT_EQ(deserialized_course->getInstructorName(), originalCourse->getInstructorName());
     EXPECT_EQ(deserialized_course->getCourseLocation(), originalCourse->getCourseLocation());
     EXPECT_EQ(deserialized_course->getCourseTimeSlot(), originalCourse->getCourseTimeSlot());
 }
 
+TEST(MyFileDatabaseUnitTests, FindDepartmentTest) {
+    MyFileDatabase db {1, "test.bin"};
+    SetUpDatabase(db);
+
+    Department* dept = db.findDepartment("CS");
+    ASSERT_NE(dept, nullptr);
+    EXPECT_EQ(dept, &db.getDepartmentMapping().at("CS"));
+    EXPECT_EQ(dept->findCourse("156"), dept->findCourse(156));
+    EXPECT_EQ(dept->findCourse(156)->getInstructorName(), "Jane Doe");
+    EXPECT_EQ(db.findDepartment("MATH"), nullptr);
+
+    dept->addPersonToMajor();
+    EXPECT_EQ(db.getDepartmentMapping().at("CS").getNumberOfMajors(), 3001);
+}
+
 TEST(MyFileDatabaseUnitTests, DisplayTest) {
     MyFileDatabase db {1, "test.bin"};
-    std::shared_ptr<Course> dummyCourse;
-    SetUpDatabase(db, dummyCourse); 
+    SetUpDatabase(db);
 
     std::string expected = 
     "For the CS department:\n"
@@ -52,3 +73,497 @@ TEST(MyFileDatabaseUnitTests, DisplayTest) {
     
     EXPECT_EQ(db.display(), expected);
 }
+
+TEST(MyFileDatabaseUnitTests, WriteJsonTest) {
+    MyFileDatabase db {1, "test.bin"};
+    SetUpDatabase(db);
+
+    std::string json;
+    JsonWriter writer(&json);
+    db.writeJson(writer);
+    EXPECT_EQ(json,
+        "{\"departments\":[{\"deptCode\":\"CS\",\"courses\":[{\"courseCode\":156,"
+        "\"instructor\":\"Jane Doe\",\"location\":\"100 CSP\",\"time\":\"2:40-3:55\"}]}]}");
+}
+
+TEST(MyFileDatabaseUnitTests, AlignedAllocationTest) {
+    // Lock stripes sit on cache lines of their own, also on the heap
+    EXPECT_EQ(alignof(MyFileDatabase) % 64, 0u);
+    MyFileDatabase* db = new MyFileDatabase{1, ""};
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(db) % alignof(MyFileDatabase), 0u);
+    delete db;
+}
+
+TEST(MyFileDatabaseUnitTests, WriteCatalogTest) {
+    MyFileDatabase db {1, "test.bin"};
+    SetUpDatabase(db);
+    Department other("ECON", {{1105, Course(210, "Waseem Noor", "309 HAV", "2:40-3:55")}}, "Michael Woodford", 2345);
+    std::map<std::string, Department> mapping = db.getDepartmentMapping();
+    mapping.emplace("ECON", other);
+    db.setMapping(mapping);
+
+    std::string json;
+    JsonWriter writer(&json);
+    db.writeJson(writer);
+
+    MyFileDatabase::CatalogSnapshot snapshot;
+    {
+        auto locks = db.acquireAllReadLocks();
+        snapshot = db.snapshotCatalog();
+    }
+    std::ostringstream text;
+    std::ostringstream jsonOut;
+    MyFileDatabase::writeCatalog(text, snapshot, false);
+    MyFileDatabase::writeCatalog(jsonOut, snapshot, true);
+    EXPECT_EQ(text.str(), db.display());
+    EXPECT_EQ(jsonOut.str(), json);
+
+    // After a checkpoint, unchanged departments share its blocks
+    db.saveContentsToFile();
+    {
+        auto locks = db.acquireAllReadLocks();
+        MyFileDatabase::CatalogSnapshot before = db.snapshotCatalog();
+        snapshot = db.snapshotCatalog();
+        ASSERT_EQ(snapshot.size(), before.size());
+        for (size_t i = 0; i < snapshot.size(); ++i) {
+            EXPECT_EQ(snapshot[i].get(), before[i].get());
+        }
+    }
+    EXPECT_EQ(db.applyMutation({MutationType::ChangeLocation, "ECON", "1105", "417 IAB"}),
+              MutationStatus::Applied);
+    {
+        auto locks = db.acquireAllReadLocks();
+        snapshot = db.snapshotCatalog();
+    }
+    std::ostringstream changed;
+    MyFileDatabase::writeCatalog(changed, snapshot, false);
+    EXPECT_EQ(changed.str(), db.display());
+    EXPECT_NE(changed.str().find("417 IAB"), std::string::npos);
+    std::remove("test.bin");
+    std::remove("test.bin.wal");
+}
+
+TEST(MyFileDatabaseUnitTests, RecoverFromWriteAheadLogTest) {
+    std::remove("wal_recovery.bin");
+    std::remove("wal_recovery.bin.wal");
+    {
+        MyFileDatabase db {1, "wal_recovery.bin"};
+        SetUpDatabase(db);
+        db.saveContentsToFile();
+
+        EXPECT_EQ(db.applyMutation({MutationType::ChangeLocation, "CS", "156", "501 NWC"}),
+                  MutationStatus::Applied);
+        EXPECT_EQ(db.applyMutation({MutationType::EnrollStudent, "CS", "156", ""}),
+                  MutationStatus::Applied);
+        EXPECT_EQ(db.applyMutation({MutationType::AddMajor, "CS", "", ""}),
+                  MutationStatus::Applied);
+        EXPECT_EQ(db.applyMutation({MutationType::AddMajor, "MATH", "", ""}),
+                  MutationStatus::DepartmentNotFound);
+        EXPECT_EQ(db.applyMutation({MutationType::ChangeTime, "CS", "999", "1:10-2:25"}),
+                  MutationStatus::CourseNotFound);
+        // Simulated crash: the database is destroyed without saving
+    }
+
+    MyFileDatabase recovered {0, "wal_recovery.bin"};
+    const Department* dept = recovered.findDepartment("CS");
+    ASSERT_NE(dept, nullptr);
+    EXPECT_EQ(dept->getNumberOfMajors(), 3001);
+    const Course* course = dept->findCourse("156");
+    ASSERT_NE(course, nullptr);
+    EXPECT_EQ(course->getCourseLocation(), "501 NWC");
+    EXPECT_EQ(course->getEnrolledStudentCount(), 4);
+
+    // After a save the log is empty and nothing is applied twice
+    recovered.saveContentsToFile();
+    MyFileDatabase reloaded {0, "wal_recovery.bin"};
+    EXPECT_EQ(reloaded.findDepartment("CS")->getNumberOfMajors(), 3001);
+    EXPECT_EQ(reloaded.findDepartment("CS")->findCourse("156")->getEnrolledStudentCount(), 4);
+}
+
+TEST(MyFileDatabaseUnitTests, RejectedMutationIsNotLoggedTest) {
+    std::remove("wal_rejected.bin");
+    std::remove("wal_rejected.bin.wal");
+    {
+        MyFileDatabase db {1, "wal_rejected.bin"};
+        SetUpDatabase(db);
+        db.saveContentsToFile();
+        db.findDepartment("CS")->findCourse(156)->setEnrolledStudentCount(5);
+        EXPECT_EQ(db.applyMutation({MutationType::EnrollStudent, "CS", "156", ""}),
+                  MutationStatus::Rejected);
+    }
+
+    MyFileDatabase recovered {0, "wal_rejected.bin"};
+    EXPECT_EQ(recovered.findDepartment("CS")->findCourse("156")->getEnrolledStudentCount(), 3);
+}
+
+TEST(MyFileDatabaseUnitTests, ApplyMutationsTest) {
+    std::remove("wal_batch.bin");
+    std::remove("wal_batch.bin.wal");
+    {
+        MyFileDatabase db {1, "wal_batch.bin"};
+        SetUpDatabase(db);
+        db.saveContentsToFile();
+
+        std::vector<MutationStatus> statuses;
+        EXPECT_TRUE(db.applyMutations({
+            {MutationType::ChangeLocation, "CS", "156", "501 NWC"},
+            {MutationType::ChangeTime, "CS", "156", "MW 10:10-11:25"},
+            {MutationType::EnrollStudent, "CS", "156", ""},
+            {MutationType::AddMajor, "CS", "", ""}}, &statuses));
+        EXPECT_EQ(statuses, std::vector<MutationStatus>(4, MutationStatus::Applied));
+        // Simulated crash: the database is destroyed without saving
+    }
+
+    MyFileDatabase recovered {0, "wal_batch.bin"};
+    const Course* course = recovered.findDepartment("CS")->findCourse("156");
+    EXPECT_EQ(course->getCourseLocation(), "501 NWC");
+    EXPECT_EQ(course->getCourseTimeSlot(), "MW 10:10-11:25");
+    EXPECT_EQ(course->getEnrolledStudentCount(), 4);
+    EXPECT_EQ(recovered.findDepartment("CS")->getNumberOfMajors(), 3001);
+    EXPECT_EQ(recovered.getRoomIndex().findCourses("501 NWC").size(), 1u);
+}
+
+TEST(MyFileDatabaseUnitTests, FailedMutationsAreRolledBackTest) {
+    std::remove("wal_rollback.bin");
+    std::remove("wal_rollback.bin.wal");
+    {
+        MyFileDatabase db {1, "wal_rollback.bin"};
+        SetUpDatabase(db);
+        db.saveContentsToFile();
+        std::string tag = db.getResponseCache().getCourseTag("CS", 156);
+
+        std::vector<MutationStatus> statuses;
+        EXPECT_FALSE(db.applyMutations({
+            {MutationType::ChangeLocation, "CS", "156", "501 NWC"},
+            {MutationType::ChangeInstructor, "CS", "156", "John Doe"},
+            {MutationType::SetEnrollmentCount, "CS", "156", "1"},
+            {MutationType::RemoveMajor, "CS", "", ""},
+            {MutationType::ChangeTime, "CS", "156", "not a time"},
+            {MutationType::AddMajor, "CS", "", ""}}, &statuses));
+        EXPECT_EQ(statuses, (std::vector<MutationStatus>{
+            MutationStatus::Aborted, MutationStatus::Aborted, MutationStatus::Aborted,
+            MutationStatus::Aborted, MutationStatus::Rejected, MutationStatus::Aborted}));
+
+        const Course* course = db.findDepartment("CS")->findCourse("156");
+        EXPECT_EQ(course->getCourseLocation(), "100 CSP");
+        EXPECT_EQ(course->getInstructorName(), "Jane Doe");
+        EXPECT_EQ(course->getEnrolledStudentCount(), 3);
+        EXPECT_EQ(db.findDepartment("CS")->getNumberOfMajors(), 3000);
+        EXPECT_EQ(db.getRoomIndex().findCourses("100 CSP").size(), 1u);
+        EXPECT_EQ(db.getRoomIndex().findCourses("501 NWC").size(), 0u);
+        EXPECT_EQ(db.getInstructorIndex().findCourses("Jane Doe").size(), 1u);
+        EXPECT_EQ(db.getInstructorIndex().findCourses("John Doe").size(), 0u);
+        EXPECT_NE(db.getResponseCache().getCourseTag("CS", 156), tag);
+
+        EXPECT_FALSE(db.applyMutations({
+            {MutationType::AddMajor, "CS", "", ""},
+            {MutationType::EnrollStudent, "MATH", "101", ""}}, &statuses));
+        EXPECT_EQ(statuses[1], MutationStatus::DepartmentNotFound);
+        EXPECT_EQ(db.findDepartment("CS")->getNumberOfMajors(), 3000);
+    }
+
+    // Nothing of a failed batch was logged
+    MyFileDatabase recovered {0, "wal_rollback.bin"};
+    EXPECT_EQ(recovered.findDepartment("CS")->getNumberOfMajors(), 3000);
+    EXPECT_EQ(recovered.findDepartment("CS")->findCourse("156")->getCourseLocation(), "100 CSP");
+}
+
+TEST(MyFileDatabaseUnitTests, InstructorAndLocationIndexesTest) {
+    std::remove("instructor_index.bin");
+    std::remove("instructor_index.bin.wal");
+    {
+        MyFileDatabase db {1, "instructor_index.bin"};
+        SetUpDatabase(db);
+        db.saveContentsToFile();
+        EXPECT_EQ(db.getInstructorIndex().findCourses("Jane Doe").size(), 1u);
+
+        EXPECT_EQ(db.applyMutation({MutationType::ChangeInstructor, "CS", "156", "John Doe"}),
+                  MutationStatus::Applied);
+        EXPECT_TRUE(db.getInstructorIndex().findCourses("Jane Doe").empty());
+        auto courses = db.getInstructorIndex().findCourses("John Doe");
+        ASSERT_EQ(courses.size(), 1u);
+        EXPECT_EQ(courses[0].deptCode, "CS");
+        EXPECT_EQ(courses[0].courseNumber, 156);
+        EXPECT_TRUE(db.getInstructorSearch().search("jane", 10).empty());
+        EXPECT_EQ(db.getInstructorSearch().search("john", 10).size(), 1u);
+
+        EXPECT_EQ(db.applyMutation({MutationType::ChangeLocation, "CS", "156", "501 NWC"}),
+                  MutationStatus::Applied);
+        EXPECT_TRUE(db.getLocationSearch().search("100 csp", 10).empty());
+        EXPECT_EQ(db.getLocationSearch().search("501", 10).size(), 1u);
+    }
+
+    // The index is rebuilt from the data file and the replayed log
+    MyFileDatabase recovered {0, "instructor_index.bin"};
+    EXPECT_TRUE(recovered.getInstructorIndex().findCourses("Jane Doe").empty());
+    EXPECT_EQ(recovered.getInstructorIndex().findCourses("John Doe").size(), 1u);
+    EXPECT_EQ(recovered.getInstructorSearch().search("john", 10).size(), 1u);
+    EXPECT_EQ(recovered.getLocationSearch().search("501 nwc", 10).size(), 1u);
+}
+
+TEST(MyFileDatabaseUnitTests, EnrollStudentByIdTest) {
+    std::remove("wal_roster.bin");
+    std::remove("wal_roster.bin.wal");
+    {
+        MyFileDatabase db {1, "wal_roster.bin"};
+        SetUpDatabase(db);
+        db.saveContentsToFile();
+
+        EXPECT_EQ(db.applyMutation({MutationType::EnrollStudentById, "CS", "156", "4156"}),
+                  MutationStatus::Applied);
+        EXPECT_EQ(db.applyMutation({MutationType::EnrollStudentById, "CS", "156", "4156"}),
+                  MutationStatus::AlreadyEnrolled);
+        EXPECT_EQ(db.applyMutation({MutationType::EnrollStudentById, "CS", "156", "17"}),
+                  MutationStatus::Applied);
+        // The course is full
+        EXPECT_EQ(db.applyMutation({MutationType::EnrollStudentById, "CS", "156", "18"}),
+                  MutationStatus::Rejected);
+        EXPECT_EQ(db.applyMutation({MutationType::EnrollStudentById, "CS", "156", "x"}),
+                  MutationStatus::Rejected);
+        EXPECT_EQ(db.applyMutation({MutationType::DropStudentById, "CS", "156", "18"}),
+                  MutationStatus::NotEnrolled);
+        EXPECT_EQ(db.applyMutation({MutationType::DropStudentById, "CS", "156", "17"}),
+                  MutationStatus::Applied);
+        // Only the three students enrolled without an ID can be dropped so
+        // or have their count set away
+        EXPECT_EQ(db.applyMutation({MutationType::SetEnrollmentCount, "CS", "156", "0"}),
+                  MutationStatus::Rejected);
+        EXPECT_EQ(db.getStudentIndex().findCourses(4156).size(), 1u);
+        EXPECT_TRUE(db.getStudentIndex().findCourses(17).empty());
+        // Simulated crash: the database is destroyed without saving
+    }
+
+    MyFileDatabase recovered {0, "wal_roster.bin"};
+    const Course* course = recovered.findDepartment("CS")->findCourse(156);
+    EXPECT_EQ(course->getRoster().getStudentIds(), std::vector<uint32_t>{4156});
+    EXPECT_EQ(course->getEnrolledStudentCount(), 4);
+    ASSERT_EQ(recovered.getStudentIndex().findCourses(4156).size(), 1u);
+    EXPECT_EQ(recovered.getStudentIndex().findCourses(4156)[0].deptCode, "CS");
+
+    // The roster is kept by a checkpoint
+    recovered.saveContentsToFile();
+    MyFileDatabase reloaded {0, "wal_roster.bin"};
+    EXPECT_TRUE(reloaded.findDepartment("CS")->findCourse(156)->isStudentEnrolled(4156));
+    EXPECT_EQ(reloaded.getStudentIndex().getStudentCount(), 1u);
+}
+
+TEST(MyFileDatabaseUnitTests, FailedEnrollmentsByIdAreRolledBackTest) {
+    MyFileDatabase db {1, ""};
+    SetUpDatabase(db);
+    EXPECT_EQ(db.applyMutation({MutationType::EnrollStudentById, "CS", "156", "7"}),
+              MutationStatus::Applied);
+
+    std::vector<MutationStatus> statuses;
+    EXPECT_FALSE(db.applyMutations({
+        {MutationType::DropStudentById, "CS", "156", "7"},
+        {MutationType::EnrollStudentById, "CS", "156", "8"},
+        {MutationType::EnrollStudentById, "CS", "156", "8"}}, &statuses));
+    EXPECT_EQ(statuses[2], MutationStatus::AlreadyEnrolled);
+
+    const Course* course = db.findDepartment("CS")->findCourse(156);
+    EXPECT_EQ(course->getRoster().getStudentIds(), std::vector<uint32_t>{7});
+    EXPECT_EQ(course->getEnrolledStudentCount(), 4);
+    EXPECT_EQ(db.getStudentIndex().findCourses(7).size(), 1u);
+    EXPECT_TRUE(db.getStudentIndex().findCourses(8).empty());
+}
+
+TEST(MyFileDatabaseUnitTests, WaitlistPromotionTest) {
+    std::remove("wal_waitlist.bin");
+    std::remove("wal_waitlist.bin.wal");
+    {
+        MyFileDatabase db {1, "wal_waitlist.bin"};
+        SetUpDatabase(db);
+        db.saveContentsToFile();
+
+        EXPECT_EQ(db.applyMutation({MutationType::JoinWaitlist, "CS", "156", "7"}),
+                  MutationStatus::Rejected);
+        EXPECT_EQ(db.applyMutation({MutationType::EnrollStudentById, "CS", "156", "1"}),
+                  MutationStatus::Applied);
+        EXPECT_EQ(db.applyMutation({MutationType::EnrollStudent, "CS", "156", ""}),
+                  MutationStatus::Applied);
+        // The course is full
+        EXPECT_EQ(db.applyMutation({MutationType::JoinWaitlist, "CS", "156", "1"}),
+                  MutationStatus::AlreadyEnrolled);
+        EXPECT_EQ(db.applyMutation({MutationType::JoinWaitlist, "CS", "156", "7"}),
+                  MutationStatus::Applied);
+        EXPECT_EQ(db.applyMutation({MutationType::JoinWaitlist, "CS", "156", "7"}),
+                  MutationStatus::AlreadyWaitlisted);
+        EXPECT_EQ(db.applyMutation({MutationType::JoinWaitlist, "CS", "156", "8"}),
+                  MutationStatus::Applied);
+        EXPECT_EQ(db.applyMutation({MutationType::JoinWaitlist, "CS", "156", "9"}),
+                  MutationStatus::Applied);
+        EXPECT_EQ(db.applyMutation({MutationType::LeaveWaitlist, "CS", "156", "8"}),
+                  MutationStatus::Applied);
+        EXPECT_EQ(db.applyMutation({MutationType::LeaveWaitlist, "CS", "156", "8"}),
+                  MutationStatus::NotWaitlisted);
+
+        // Each drop, with or without an ID, enrolls the next student
+        EXPECT_EQ(db.applyMutation({MutationType::DropStudent, "CS", "156", ""}),
+                  MutationStatus::Applied);
+        EXPECT_EQ(db.applyMutation({MutationType::DropStudentById, "CS", "156", "1"}),
+                  MutationStatus::Applied);
+        const Course* course = db.findDepartment("CS")->findCourse(156);
+        EXPECT_EQ(course->getRoster().getStudentIds(), (std::vector<uint32_t>{7, 9}));
+        EXPECT_TRUE(course->getWaitlist().empty());
+        EXPECT_EQ(course->getEnrolledStudentCount(), 5);
+        EXPECT_EQ(db.getStudentIndex().findCourses(9).size(), 1u);
+        EXPECT_EQ(db.applyMutation({MutationType::JoinWaitlist, "CS", "156", "10"}),
+                  MutationStatus::Applied);
+        // Simulated crash: the database is destroyed without saving
+    }
+
+    MyFileDatabase recovered {0, "wal_waitlist.bin"};
+    const Course* course = recovered.findDepartment("CS")->findCourse(156);
+    EXPECT_EQ(course->getRoster().getStudentIds(), (std::vector<uint32_t>{7, 9}));
+    EXPECT_EQ(course->getWaitlist().getStudentIds(), std::vector<uint32_t>{10});
+    EXPECT_EQ(course->getEnrolledStudentCount(), 5);
+
+    recovered.saveContentsToFile();
+    MyFileDatabase reloaded {0, "wal_waitlist.bin"};
+    EXPECT_EQ(reloaded.findDepartment("CS")->findCourse(156)->getWaitlistPosition(10), 1u);
+}
+
+TEST(MyFileDatabaseUnitTests, FailedPromotionsAreRolledBackTest) {
+    MyFileDatabase db {1, ""};
+    SetUpDatabase(db);
+    db.applyMutation({MutationType::SetEnrollmentCount, "CS", "156", "5"});
+    db.applyMutation({MutationType::JoinWaitlist, "CS", "156", "7"});
+    db.applyMutation({MutationType::JoinWaitlist, "CS", "156", "8"});
+
+    std::vector<MutationStatus> statuses;
+    EXPECT_FALSE(db.applyMutations({
+        {MutationType::LeaveWaitlist, "CS", "156", "8"},
+        {MutationType::SetEnrollmentCount, "CS", "156", "3"},
+        {MutationType::JoinWaitlist, "CS", "156", "9"}}, &statuses));
+    EXPECT_EQ(statuses[2], MutationStatus::Rejected);
+
+    const Course* course = db.findDepartment("CS")->findCourse(156);
+    EXPECT_EQ(course->getWaitlist().getStudentIds(), (std::vector<uint32_t>{7, 8}));
+    EXPECT_EQ(course->getRoster().size(), 0u);
+    EXPECT_EQ(course->getEnrolledStudentCount(), 5);
+    EXPECT_TRUE(db.getStudentIndex().findCourses(7).empty());
+
+    EXPECT_TRUE(db.applyMutations({
+        {MutationType::SetEnrollmentCount, "CS", "156", "3"}}, &statuses));
+    EXPECT_EQ(course->getRoster().getStudentIds(), (std::vector<uint32_t>{7, 8}));
+    EXPECT_EQ(course->getEnrolledStudentCount(), 5);
+}
+
+TEST(MyFileDatabaseUnitTests, IncrementalCheckpointTest) {
+    std::remove("checkpoint.bin");
+    std::remove("checkpoint.bin.wal");
+    MyFileDatabase db {1, "checkpoint.bin"};
+    Course course(5, "Jane Doe", "100 CSP", "2:40-3:55");
+    Course other(90, "Bo Li", "301 URIS", "1:10-2:25");
+    db.setMapping({{"CS", Department("CS", {{156, course}}, "Joe Doe", 3000)},
+                   {"MATH", Department("MATH", {{1101, other}}, "Al Gebra", 400)}});
+    db.checkpoint(false);
+    EXPECT_FALSE(db.hasUnsavedChanges());
+
+    db.applyMutation({MutationType::AddMajor, "MATH", "", ""});
+    EXPECT_TRUE(db.hasUnsavedChanges());
+    db.checkpoint(false);
+    EXPECT_FALSE(db.hasUnsavedChanges());
+    EXPECT_FALSE(std::ifstream("checkpoint.bin.tmp").good());
+    EXPECT_FALSE(std::ifstream("checkpoint.bin.wal.old").good());
+
+    // The data file alone holds both the re-serialized and the cached department
+    std::remove("checkpoint_copy.bin");
+    {
+        std::ifstream src("checkpoint.bin", std::ios::binary);
+        std::ofstream dst("checkpoint_copy.bin", std::ios::binary);
+        dst << src.rdbuf();
+    }
+    MyFileDatabase copy {0, "checkpoint_copy.bin"};
+    ASSERT_NE(copy.findDepartment("CS"), nullptr);
+    ASSERT_NE(copy.findDepartment("MATH"), nullptr);
+    EXPECT_EQ(copy.findDepartment("CS")->getNumberOfMajors(), 3000);
+    EXPECT_EQ(copy.findDepartment("MATH")->getNumberOfMajors(), 401);
+    std::remove("checkpoint_copy.bin");
+    std::remove("checkpoint_copy.bin.wal");
+}
+
+TEST(MyFileDatabaseUnitTests, BackgroundCheckpointTest) {
+    std::remove("background.bin");
+    std::remove("background.bin.wal");
+    MyFileDatabase db {1, "background.bin"};
+    SetUpDatabase(db);
+    db.startCheckpointing(std::chrono::milliseconds(5));
+    db.applyMutation({MutationType::EnrollStudent, "CS", "156", ""});
+    for (int i = 0; i < 400 && db.hasUnsavedChanges(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    db.stopCheckpointing();
+    EXPECT_FALSE(db.hasUnsavedChanges());
+
+    MyFileDatabase reloaded {0, "background.bin"};
+    EXPECT_EQ(reloaded.findDepartment("CS")->findCourse("156")->getEnrolledStudentCount(), 4);
+}
+
+TEST(MyFileDatabaseUnitTests, LegacyFormatIsConvertedTest) {
+    std::remove("legacy.bin");
+    std::remove("legacy.bin.wal");
+    {
+        // The original format: department count, then code and department
+        MyFileDatabase db {1, ""};
+        SetUpDatabase(db);
+        std::ofstream out("legacy.bin", std::ios::binary);
+        size_t mapSize = 1;
+        out.write(reinterpret_cast<const char*>(&mapSize), sizeof(mapSize));
+        size_t keyLen = 2;
+        out.write(reinterpret_cast<const char*>(&keyLen), sizeof(keyLen));
+        out.write("CS", keyLen);
+        db.findDepartment("CS")->serialize(out);
+    }
+    EXPECT_FALSE(MappedDataFile::isMappedFormat("legacy.bin"));
+
+    {
+        MyFileDatabase db {0, "legacy.bin"};
+        ASSERT_NE(db.findDepartment("CS"), nullptr);
+        EXPECT_EQ(db.findDepartment("CS")->findCourse("156")->getEnrolledStudentCount(), 3);
+        db.applyMutation({MutationType::AddMajor, "CS", "", ""});
+        db.saveContentsToFile();
+    }
+    EXPECT_TRUE(MappedDataFile::isMappedFormat("legacy.bin"));
+
+    MyFileDatabase converted {0, "legacy.bin"};
+    EXPECT_EQ(converted.findDepartment("CS")->getNumberOfMajors(), 3001);
+    EXPECT_EQ(converted.findDepartment("CS")->findCourse("156")->getCourseLocation(), "100 CSP");
+}
+
+TEST(MyFileDatabaseUnitTests, ChangesInvalidateResponseCacheTest) {
+    MyFileDatabase db {1, ""};
+    SetUpDatabase(db);
+    ResponseCache& cache = db.getResponseCache();
+    cache.storeDepartment("CS", "department");
+    cache.storeCourse("CS", 156, "course");
+
+    // Enrollment is not part of the rendered bodies
+    EXPECT_EQ(db.applyMutation({MutationType::EnrollStudent, "CS", "156", ""}),
+              MutationStatus::Applied);
+    EXPECT_EQ(db.applyMutation({MutationType::AddMajor, "CS", "", ""}),
+              MutationStatus::Applied);
+    EXPECT_NE(cache.findCourse("CS", 156), nullptr);
+    EXPECT_NE(cache.findDepartment("CS"), nullptr);
+
+    EXPECT_EQ(db.applyMutation({MutationType::ChangeTime, "CS", "156", "nope"}),
+              MutationStatus::Rejected);
+    EXPECT_NE(cache.findCourse("CS", 156), nullptr);
+
+    const MutationType changes[] = {MutationType::ChangeInstructor,
+                                    MutationType::ChangeLocation,
+                                    MutationType::ChangeTime};
+    const char* values[] = {"John Doe", "200 CSP", "4:10-5:25"};
+    for (int i = 0; i < 3; ++i) {
+        cache.storeDepartment("CS", "department");
+        cache.storeCourse("CS", 156, "course");
+        EXPECT_EQ(db.applyMutation({changes[i], "CS", "156", values[i]}),
+                  MutationStatus::Applied);
+        EXPECT_EQ(cache.findCourse("CS", 156), nullptr);
+        EXPECT_EQ(cache.findDepartment("CS"), nullptr);
+    }
+
+    cache.storeCourse("CS", 156, "course");
+    SetUpDatabase(db);
+    EXPECT_EQ(cache.size(), 0u);
+}
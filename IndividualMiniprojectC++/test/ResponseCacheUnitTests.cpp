@@ -0,0 +1,142 @@
+// Copyright 2024 Maria Surani
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ResponseCache.h"
+
+TEST(ResponseCacheUnitTests, StoreAndFindTest) {
+  ResponseCache cache;
+  EXPECT_EQ(cache.findDepartment("COMS"), nullptr);
+  EXPECT_EQ(cache.findCourse("COMS", 1004), nullptr);
+
+  EXPECT_EQ(*cache.storeDepartment("COMS", "department"), "department");
+  EXPECT_EQ(*cache.storeCourse("COMS", 1004, "course"), "course");
+  ASSERT_NE(cache.findDepartment("COMS"), nullptr);
+  EXPECT_EQ(*cache.findDepartment("COMS"), "department");
+  ASSERT_NE(cache.findCourse("COMS", 1004), nullptr);
+  EXPECT_EQ(*cache.findCourse("COMS", 1004), "course");
+  EXPECT_EQ(cache.findCourse("COMS", 3157), nullptr);
+  EXPECT_EQ(cache.findCourse("ECON", 1004), nullptr);
+
+  EXPECT_EQ(cache.size(), 2u);
+  EXPECT_EQ(cache.getHitCount(), 4u);
+  EXPECT_EQ(cache.getMissCount(), 4u);
+}
+
+TEST(ResponseCacheUnitTests, InvalidateCourseTest) {
+  ResponseCache cache;
+  cache.storeDepartment("COMS", "department");
+  cache.storeCourse("COMS", 1004, "1004");
+  cache.storeCourse("COMS", 3157, "3157");
+  cache.storeDepartment("ECON", "economics");
+
+  // A course change also drops the department, but no other course
+  cache.invalidateCourse("COMS", 1004);
+  EXPECT_EQ(cache.findDepartment("COMS"), nullptr);
+  EXPECT_EQ(cache.findCourse("COMS", 1004), nullptr);
+  EXPECT_NE(cache.findCourse("COMS", 3157), nullptr);
+  EXPECT_NE(cache.findDepartment("ECON"), nullptr);
+  EXPECT_EQ(cache.size(), 2u);
+
+  cache.invalidateCourse("CHEM", 1403);
+  EXPECT_EQ(cache.size(), 2u);
+
+  cache.clear();
+  EXPECT_EQ(cache.size(), 0u);
+  EXPECT_EQ(cache.findCourse("COMS", 3157), nullptr);
+}
+
+TEST(ResponseCacheUnitTests, ContentEncodingsTest) {
+  ResponseCache cache;
+  cache.storeDepartment("COMS", "department");
+  cache.storeCourse("COMS", 1004, "course");
+  EXPECT_EQ(cache.findDepartment("COMS", ContentEncoding::Gzip), nullptr);
+  EXPECT_EQ(cache.findCourse("COMS", 1004, ContentEncoding::Deflate), nullptr);
+
+  // Each coding of a body is held alongside the others
+  cache.storeDepartment("COMS", "gzip department", ContentEncoding::Gzip);
+  cache.storeCourse("COMS", 1004, "deflate course", ContentEncoding::Deflate);
+  EXPECT_EQ(*cache.findDepartment("COMS"), "department");
+  EXPECT_EQ(*cache.findDepartment("COMS", ContentEncoding::Gzip),
+            "gzip department");
+  EXPECT_EQ(*cache.findCourse("COMS", 1004, ContentEncoding::Deflate),
+            "deflate course");
+  EXPECT_EQ(cache.findCourse("COMS", 1004, ContentEncoding::Gzip), nullptr);
+  EXPECT_EQ(cache.size(), 4u);
+
+  // and dropped with them
+  cache.invalidateCourse("COMS", 1004);
+  EXPECT_EQ(cache.findDepartment("COMS", ContentEncoding::Gzip), nullptr);
+  EXPECT_EQ(cache.findCourse("COMS", 1004, ContentEncoding::Deflate), nullptr);
+  EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST(ResponseCacheUnitTests, EntityTagTest) {
+  ResponseCache cache;
+  std::string department = cache.getDepartmentTag("COMS");
+  std::string course = cache.getCourseTag("COMS", 1004);
+  std::string other = cache.getCourseTag("COMS", 3157);
+  EXPECT_EQ(department.front(), '"');
+  EXPECT_EQ(department.back(), '"');
+  EXPECT_EQ(cache.getDepartmentTag("COMS"), department);
+
+  // A course change bumps the course and its department, but no other course
+  cache.storeCourse("COMS", 1004, "course");
+  cache.invalidateCourse("COMS", 1004);
+  EXPECT_NE(cache.getDepartmentTag("COMS"), department);
+  EXPECT_NE(cache.getCourseTag("COMS", 1004), course);
+  EXPECT_EQ(cache.getCourseTag("COMS", 3157), other);
+  EXPECT_EQ(cache.size(), 0u);
+
+  // A new catalog never reuses a tag, though its versions start over
+  std::string changed = cache.getCourseTag("COMS", 1004);
+  cache.clear();
+  EXPECT_NE(cache.getCourseTag("COMS", 1004), course);
+  EXPECT_NE(cache.getCourseTag("COMS", 1004), changed);
+  EXPECT_NE(ResponseCache().getCourseTag("COMS", 1004), course);
+}
+
+TEST(ResponseCacheUnitTests, BodyOutlivesInvalidationTest) {
+  ResponseCache cache;
+  ResponseCache::Body body = cache.storeCourse("COMS", 1004, "course");
+  cache.clear();
+  EXPECT_EQ(*body, "course");
+}
+
+TEST(ResponseCacheUnitTests, ConcurrentAccessTest) {
+  ResponseCache cache;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&cache, t]() {
+      std::string deptCode = "D" + std::to_string(t % 2);
+      for (int i = 0; i < 2000; ++i) {
+        int courseNumber = i % 50;
+        if (!cache.findCourse(deptCode, courseNumber)) {
+          cache.storeCourse(deptCode, courseNumber, std::to_string(i));
+        }
+        if (i % 7 == 0) cache.invalidateCourse(deptCode, courseNumber);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  EXPECT_EQ(cache.getHitCount() + cache.getMissCount(), 8000u);
+}
+
+TEST(ResponseCacheUnitTests, CatalogTagTest) {
+  ResponseCache cache;
+  std::string catalog = cache.getCatalogTag();
+  EXPECT_EQ(cache.getCatalogTag(), catalog);
+
+  // Any course change bumps the catalog, as does a new catalog
+  cache.invalidateCourse("COMS", 1004);
+  std::string changed = cache.getCatalogTag();
+  EXPECT_NE(changed, catalog);
+  cache.invalidateCourse("PHYS", 1001);
+  EXPECT_NE(cache.getCatalogTag(), changed);
+  changed = cache.getCatalogTag();
+  cache.clear();
+  EXPECT_NE(cache.getCatalogTag(), changed);
+}
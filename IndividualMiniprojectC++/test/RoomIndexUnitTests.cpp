@@ -0,0 +1,75 @@
+// Copyright 2024 Maria Surani
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "RoomIndex.h"
+
+namespace {
+
+std::vector<std::string> describe(const std::vector<RoomConflict>& conflicts) {
+  std::vector<std::string> result;
+  for (const auto& conflict : conflicts) {
+    result.push_back(conflict.location + ": " + conflict.first.deptCode + " " +
+                     std::to_string(conflict.first.courseNumber) + "/" +
+                     conflict.second.deptCode + " " +
+                     std::to_string(conflict.second.courseNumber));
+  }
+  return result;
+}
+
+RoomIndex::Booking booking(const std::string& location,
+                           const std::string& deptCode, int courseNumber,
+                           const std::string& time) {
+  return {location, {deptCode, courseNumber, TimeSlot(time)}};
+}
+
+}  // namespace
+
+TEST(RoomIndexUnitTests, FindConflictsTest) {
+  RoomIndex index;
+  index.rebuild({booking("310 FAY", "ECON", 3211, "4:10-5:25"),
+                 booking("310 FAY", "IEOR", 3658, "5:00-6:00"),
+                 booking("310 FAY", "ECON", 1105, "10:10-11:25"),
+                 booking("310 FAY", "IEOR", 4106, "TBA"),
+                 booking("417 IAB", "COMS", 1004, "MW 11:40-12:55"),
+                 booking("417 IAB", "COMS", 3157, "TR 11:40-12:55"),
+                 booking("", "COMS", 4995, "11:40-12:55")});
+  EXPECT_EQ(index.getRoomCount(), 2u);
+  EXPECT_EQ(index.findCourses("310 FAY").size(), 4u);
+  EXPECT_TRUE(index.findCourses("501 NWC").empty());
+
+  EXPECT_EQ(describe(index.findConflicts("310 FAY")),
+            (std::vector<std::string>{"310 FAY: ECON 3211/IEOR 3658"}));
+  // Different days share the room without conflict
+  EXPECT_TRUE(index.findConflicts("417 IAB").empty());
+  EXPECT_EQ(describe(index.findAllConflicts()),
+            (std::vector<std::string>{"310 FAY: ECON 3211/IEOR 3658"}));
+}
+
+TEST(RoomIndexUnitTests, UpdateTest) {
+  RoomIndex index;
+  index.rebuild({booking("310 FAY", "ECON", 3211, "4:10-5:25"),
+                 booking("417 IAB", "COMS", 1004, "4:10-5:25")});
+
+  // Moving into a booked room is refused when asked, and nothing changes
+  EXPECT_FALSE(index.update("COMS", 1004, "417 IAB", "310 FAY",
+                            TimeSlot("4:10-5:25"), true));
+  EXPECT_EQ(index.findCourses("417 IAB").size(), 1u);
+  EXPECT_TRUE(index.findAllConflicts().empty());
+
+  EXPECT_TRUE(index.update("COMS", 1004, "417 IAB", "310 FAY",
+                           TimeSlot("4:10-5:25"), false));
+  EXPECT_EQ(index.getRoomCount(), 1u);
+  EXPECT_EQ(index.findAllConflicts().size(), 1u);
+
+  // A course never conflicts with itself when its own time changes
+  EXPECT_TRUE(index.update("ECON", 3211, "310 FAY", "310 FAY",
+                           TimeSlot("4:30-5:25"), false));
+  EXPECT_FALSE(index.update("COMS", 1004, "310 FAY", "310 FAY",
+                            TimeSlot("4:00-5:00"), true));
+  EXPECT_TRUE(index.update("COMS", 1004, "310 FAY", "310 FAY",
+                           TimeSlot("2:40-4:30"), true));
+  EXPECT_TRUE(index.findAllConflicts().empty());
+}
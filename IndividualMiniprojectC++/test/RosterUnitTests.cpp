@@ -0,0 +1,72 @@
+// Copyright 2024 Maria Surani
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Roster.h"
+
+TEST(RosterUnitTests, AddRemoveTest) {
+  Roster roster;
+  EXPECT_TRUE(roster.add(2051));
+  EXPECT_TRUE(roster.add(17));
+  EXPECT_TRUE(roster.add(900000));
+  EXPECT_FALSE(roster.add(17));
+  EXPECT_EQ(roster.size(), 3u);
+  EXPECT_EQ(roster.getStudentIds(),
+            (std::vector<uint32_t>{17, 2051, 900000}));
+
+  EXPECT_TRUE(roster.contains(2051));
+  EXPECT_FALSE(roster.contains(2050));
+  EXPECT_TRUE(roster.remove(2051));
+  EXPECT_FALSE(roster.remove(2051));
+  EXPECT_FALSE(roster.contains(2051));
+  EXPECT_EQ(roster.size(), 2u);
+}
+
+TEST(RosterUnitTests, EncodeDecodeTest) {
+  Roster empty;
+  EXPECT_EQ(empty.encode(), "");
+
+  Roster roster;
+  for (uint32_t id : {0u, 1u, 128u, 50000u, 50001u, UINT32_MAX}) {
+    roster.add(id);
+  }
+  std::string encoded = roster.encode();
+  Roster decoded;
+  ASSERT_TRUE(Roster::decode(encoded.data(), encoded.size(), &decoded));
+  EXPECT_EQ(decoded.getStudentIds(), roster.getStudentIds());
+
+  // Close IDs take one byte each
+  Roster dense;
+  for (uint32_t id = 100000; id < 100100; ++id) dense.add(id);
+  EXPECT_EQ(dense.encode().size(), 3u + 99u);
+}
+
+TEST(RosterUnitTests, DecodeRejectsInvalidRostersTest) {
+  Roster roster;
+  // Truncated varint
+  EXPECT_FALSE(Roster::decode("\x81", 1, &roster));
+  // A repeated ID is a zero gap after the first
+  EXPECT_FALSE(Roster::decode("\x05\x00", 2, &roster));
+  // Past the largest ID
+  EXPECT_FALSE(Roster::decode("\xff\xff\xff\xff\x0f\x01", 6, &roster));
+  // Too many bytes for a 32-bit gap
+  EXPECT_FALSE(Roster::decode("\x80\x80\x80\x80\x80\x01", 6, &roster));
+  EXPECT_EQ(roster.size(), 0u);
+}
+
+TEST(RosterUnitTests, ParseStudentIdTest) {
+  uint32_t studentId = 0;
+  EXPECT_TRUE(Roster::parseStudentId("4156", &studentId));
+  EXPECT_EQ(studentId, 4156u);
+  EXPECT_TRUE(Roster::parseStudentId("4294967295", &studentId));
+  EXPECT_EQ(studentId, UINT32_MAX);
+
+  EXPECT_FALSE(Roster::parseStudentId("", &studentId));
+  EXPECT_FALSE(Roster::parseStudentId("4294967296", &studentId));
+  EXPECT_FALSE(Roster::parseStudentId("-1", &studentId));
+  EXPECT_FALSE(Roster::parseStudentId("12a", &studentId));
+  EXPECT_FALSE(Roster::parseStudentId("12345678901", &studentId));
+}
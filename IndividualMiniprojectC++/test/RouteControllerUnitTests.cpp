@@ -2,6 +2,11 @@
 #include "MyApp.h"
 #include "RouteController.h"
 #include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
 
 // Helper function to set up the database and initialize routes
 void SetUpDatabase(RouteController& routeController) {
@@ -99,6 +104,476 @@ TEST(RouteControllerUnitTests, RetrieveCourseTest) {
     EXPECT_EQ(res.body, "Both department code and course code must be included in the request.");
 }
 
+TEST(RouteControllerUnitTests, RetrieveFromResponseCacheTest) {
+    RouteController routeController;
+    SetUpDatabase(routeController);
+    const ResponseCache& cache = MyApp::getDatabase()->getResponseCache();
+
+    crow::request req{};
+    crow::response res{};
+    req.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1001"};
+    routeController.retrieveCourse(req, res);
+    res.body.clear();
+    routeController.retrieveCourse(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, "\nInstructor: Szabolcs Marka; Location: 301 PUP; Time: 2:40-3:55");
+    EXPECT_EQ(cache.getMissCount(), 1u);
+    EXPECT_EQ(cache.getHitCount(), 1u);
+
+    crow::request change{};
+    crow::response changed{};
+    change.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1001&instructor=Jane Doe"};
+    routeController.setCourseInstructor(change, changed);
+    EXPECT_EQ(changed.code, 200);
+
+    res.body.clear();
+    routeController.retrieveCourse(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, "\nInstructor: Jane Doe; Location: 301 PUP; Time: 2:40-3:55");
+
+    req.url_params = crow::query_string{"?deptCode=PHYS"};
+    res.body.clear();
+    routeController.retrieveDepartment(req, res);
+    res.body.clear();
+    routeController.retrieveDepartment(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_NE(res.body.find("PHYS 1001: \nInstructor: Jane Doe;"), std::string::npos);
+    EXPECT_EQ(cache.getMissCount(), 3u);
+    EXPECT_EQ(cache.getHitCount(), 2u);
+}
+
+TEST(RouteControllerUnitTests, ConditionalRetrieveTest) {
+    RouteController routeController;
+    SetUpDatabase(routeController);
+    const ResponseCache& cache = MyApp::getDatabase()->getResponseCache();
+
+    crow::request req{};
+    crow::response res{};
+    req.url_params = crow::query_string{"?deptCode=PHYS"};
+    routeController.retrieveDepartment(req, res);
+    EXPECT_EQ(res.code, 200);
+    std::string deptTag = res.get_header_value("ETag");
+    EXPECT_FALSE(deptTag.empty());
+
+    // A matching tag is answered without a body or a cache lookup
+    uint64_t lookups = cache.getHitCount() + cache.getMissCount();
+    req.add_header("If-None-Match", "\"other\", W/" + deptTag);
+    crow::response notModified{};
+    routeController.retrieveDepartment(req, notModified);
+    EXPECT_EQ(notModified.code, 304);
+    EXPECT_EQ(notModified.body, "");
+    EXPECT_EQ(notModified.get_header_value("ETag"), deptTag);
+    EXPECT_EQ(cache.getHitCount() + cache.getMissCount(), lookups);
+
+    crow::request courseReq{};
+    crow::response courseRes{};
+    courseReq.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1001"};
+    routeController.retrieveCourse(courseReq, courseRes);
+    std::string courseTag = courseRes.get_header_value("ETag");
+    courseReq.add_header("If-None-Match", courseTag);
+    courseRes = crow::response{};
+    routeController.retrieveCourse(courseReq, courseRes);
+    EXPECT_EQ(courseRes.code, 304);
+
+    // Changing the course changes both tags, so the stale ones get the body
+    crow::request change{};
+    crow::response changed{};
+    change.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1001&location=417 IAB"};
+    routeController.setCourseLocation(change, changed);
+    EXPECT_EQ(changed.code, 200);
+
+    courseRes = crow::response{};
+    routeController.retrieveCourse(courseReq, courseRes);
+    EXPECT_EQ(courseRes.code, 200);
+    EXPECT_EQ(courseRes.body, "\nInstructor: Szabolcs Marka; Location: 417 IAB; Time: 2:40-3:55");
+    EXPECT_NE(courseRes.get_header_value("ETag"), courseTag);
+
+    res = crow::response{};
+    routeController.retrieveDepartment(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_NE(res.get_header_value("ETag"), deptTag);
+
+    // Enrollment is not part of the body, so it keeps the tag
+    crow::request enroll{};
+    crow::response enrolled{};
+    enroll.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1001"};
+    routeController.enrollStudentInCourse(enroll, enrolled);
+    courseReq.headers.clear();
+    courseReq.add_header("If-None-Match", courseRes.get_header_value("ETag"));
+    courseRes = crow::response{};
+    routeController.retrieveCourse(courseReq, courseRes);
+    EXPECT_EQ(courseRes.code, 304);
+
+    // Missing resources have no tag to match
+    crow::request missing{};
+    crow::response notFound{};
+    missing.url_params = crow::query_string{"?deptCode=PHYS&courseCode=9999"};
+    missing.add_header("If-None-Match", "*");
+    routeController.retrieveCourse(missing, notFound);
+    EXPECT_EQ(notFound.code, 404);
+    EXPECT_EQ(notFound.body, "Course Not Found");
+}
+
+TEST(RouteControllerUnitTests, RetrieveCoursesTest) {
+    RouteController routeController;
+    SetUpDatabase(routeController);
+
+    crow::request full{};
+    crow::response fullRes{};
+    full.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1001&count=1000"};
+    routeController.setEnrollmentCount(full, fullRes);
+    EXPECT_EQ(fullRes.code, 200);
+
+    crow::request req{};
+    crow::response res{};
+    req.url_params = crow::query_string{"?courses=PHYS:1001,COMS:1004,PHYS:9999,NONE:1,PHYS:1001"};
+    routeController.retrieveCourses(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body,
+        "PHYS 1001: \nInstructor: Szabolcs Marka; Location: 301 PUP; Time: 2:40-3:55\nFull: true\n"
+        "COMS 1004: \nInstructor: Adam Cannon; Location: 417 IAB; Time: 11:40-12:55\nFull: false\n"
+        "PHYS 9999: Course Not Found\n"
+        "NONE 1: Department Not Found\n"
+        "PHYS 1001: \nInstructor: Szabolcs Marka; Location: 301 PUP; Time: 2:40-3:55\nFull: true\n");
+
+    // The same list as a JSON body gives the same response
+    crow::request post{};
+    crow::response postRes{};
+    post.method = crow::HTTPMethod::POST;
+    post.body = R"({"courses": [
+        {"deptCode": "PHYS", "courseCode": 1001},
+        {"deptCode": "COMS", "courseCode": 1004},
+        {"deptCode": "PHYS", "courseCode": 9999},
+        {"deptCode": "NONE", "courseCode": 1},
+        {"deptCode": "PHYS", "courseCode": 1001}]})";
+    routeController.retrieveCourses(post, postRes);
+    EXPECT_EQ(postRes.code, 200);
+    EXPECT_EQ(postRes.body, res.body);
+
+    const char* malformed[] = {"?courses=", "?courses=PHYS", "?courses=:1001",
+                               "?courses=PHYS:abc", "?courses=PHYS:1001,", "?deptCode=PHYS"};
+    for (const char* query : malformed) {
+        crow::request bad{};
+        crow::response badRes{};
+        bad.url_params = crow::query_string{query};
+        routeController.retrieveCourses(bad, badRes);
+        EXPECT_EQ(badRes.code, 400) << query;
+    }
+    const char* malformedJson[] = {"{", "{\"courses\": []}", "{\"course\": []}",
+                                   "{\"courses\": [{\"deptCode\": \"PHYS\"}]}",
+                                   "{\"courses\": [{\"deptCode\": 1, \"courseCode\": 1001}]}"};
+    for (const char* body : malformedJson) {
+        crow::request bad{};
+        crow::response badRes{};
+        bad.body = body;
+        routeController.retrieveCourses(bad, badRes);
+        EXPECT_EQ(badRes.code, 400) << body;
+    }
+
+    std::string tooMany = "?courses=PHYS:1001";
+    for (int i = 0; i < 100; ++i) tooMany += ",PHYS:1001";
+    crow::request big{};
+    crow::response bigRes{};
+    big.url_params = crow::query_string{tooMany};
+    routeController.retrieveCourses(big, bigRes);
+    EXPECT_EQ(bigRes.code, 413);
+}
+
+TEST(RouteControllerUnitTests, BatchUpdateTest) {
+    RouteController routeController;
+    SetUpDatabase(routeController);
+
+    crow::request req{};
+    crow::response res{};
+    req.method = crow::HTTPMethod::PATCH;
+    req.body = R"({"operations": [
+        {"op": "changeCourseLocation", "deptCode": "PHYS", "courseCode": 1001, "location": "417 IAB"},
+        {"op": "changeCourseTeacher", "deptCode": "PHYS", "courseCode": 1001, "instructor": "Jane Doe"},
+        {"op": "setEnrollmentCount", "deptCode": "COMS", "courseCode": 1004, "count": 10},
+        {"op": "addMajorToDept", "deptCode": "ECON"}]})";
+    routeController.batchUpdate(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, "0: Applied\n1: Applied\n2: Applied\n3: Applied\n");
+
+    crow::request check{};
+    crow::response checked{};
+    check.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1001"};
+    routeController.retrieveCourse(check, checked);
+    EXPECT_EQ(checked.body, "\nInstructor: Jane Doe; Location: 417 IAB; Time: 2:40-3:55");
+
+    // One failure leaves everything as it was
+    crow::request failing{};
+    crow::response failed{};
+    failing.body = R"({"operations": [
+        {"op": "changeCourseTeacher", "deptCode": "PHYS", "courseCode": 1001, "instructor": "John Doe"},
+        {"op": "changeCourseTime", "deptCode": "PHYS", "courseCode": 9999, "time": "1:10-2:25"}]})";
+    routeController.batchUpdate(failing, failed);
+    EXPECT_EQ(failed.code, 404);
+    EXPECT_EQ(failed.body, "0: Not applied\n1: Course Not Found\n");
+    checked = crow::response{};
+    routeController.retrieveCourse(check, checked);
+    EXPECT_EQ(checked.body, "\nInstructor: Jane Doe; Location: 417 IAB; Time: 2:40-3:55");
+
+    const char* malformed[] = {
+        "", "{}", R"({"operations": []})",
+        R"({"operations": [{"op": "renameCourse", "deptCode": "PHYS"}]})",
+        R"({"operations": [{"op": "changeCourseTime", "deptCode": "PHYS", "courseCode": 1001}]})",
+        R"({"operations": [{"op": "setEnrollmentCount", "deptCode": "PHYS", "courseCode": 1001, "count": -1}]})",
+        R"({"operations": [{"op": "addMajorToDept", "deptCode": "PHYS"}, {"op": "addMajorToDept"}]})"};
+    for (const char* body : malformed) {
+        crow::request bad{};
+        crow::response badRes{};
+        bad.body = body;
+        routeController.batchUpdate(bad, badRes);
+        EXPECT_EQ(badRes.code, 400) << body;
+    }
+    crow::request bad{};
+    crow::response badRes{};
+    bad.body = R"({"operations": [{"op": "addMajorToDept", "deptCode": "PHYS"}, {"op": "addMajorToDept"}]})";
+    routeController.batchUpdate(bad, badRes);
+    EXPECT_EQ(badRes.body, "Operation 1 is malformed.");
+}
+
+TEST(RouteControllerUnitTests, RetrieveAsJsonTest) {
+    RouteController routeController;
+    SetUpDatabase(routeController);
+
+    crow::request req{};
+    crow::response res{};
+    req.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1001"};
+    req.add_header("Accept", "text/html, application/json;q=0.9, */*;q=0.1");
+    routeController.retrieveCourse(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.get_header_value("Content-Type"), "application/json");
+    EXPECT_EQ(res.body,
+        "{\"deptCode\":\"PHYS\",\"courseCode\":1001,\"instructor\":\"Szabolcs Marka\","
+        "\"location\":\"301 PUP\",\"time\":\"2:40-3:55\"}");
+    std::string jsonTag = res.get_header_value("ETag");
+
+    // The text form has its own tag, and remains the default
+    crow::request text{};
+    crow::response textRes{};
+    text.url_params = req.url_params;
+    text.add_header("Accept", "*/*");
+    routeController.retrieveCourse(text, textRes);
+    EXPECT_EQ(textRes.body, "\nInstructor: Szabolcs Marka; Location: 301 PUP; Time: 2:40-3:55");
+    EXPECT_NE(textRes.get_header_value("ETag"), jsonTag);
+    text.headers.clear();
+    text.add_header("Accept", "application/json;q=0.5, text/plain");
+    textRes = crow::response{};
+    routeController.retrieveCourse(text, textRes);
+    EXPECT_EQ(textRes.get_header_value("Content-Type"), "");
+
+    req.add_header("If-None-Match", jsonTag);
+    res = crow::response{};
+    routeController.retrieveCourse(req, res);
+    EXPECT_EQ(res.code, 304);
+
+    crow::request dept{};
+    crow::response deptRes{};
+    dept.url_params = crow::query_string{"?deptCode=PHYS"};
+    dept.add_header("Accept", "application/json");
+    routeController.retrieveDepartment(dept, deptRes);
+    EXPECT_EQ(deptRes.code, 200);
+    std::string prefix = "{\"deptCode\":\"PHYS\",\"courses\":[{\"courseCode\":1001,";
+    EXPECT_EQ(deptRes.body.compare(0, prefix.size(), prefix), 0);
+    EXPECT_EQ(deptRes.body.back(), '}');
+
+    crow::request batch{};
+    crow::response batchRes{};
+    batch.url_params = crow::query_string{"?courses=PHYS:1001,PHYS:9999"};
+    batch.add_header("Accept", "application/json");
+    routeController.retrieveCourses(batch, batchRes);
+    EXPECT_EQ(batchRes.body,
+        "{\"courses\":[{\"deptCode\":\"PHYS\",\"courseCode\":1001,\"instructor\":"
+        "\"Szabolcs Marka\",\"location\":\"301 PUP\",\"time\":\"2:40-3:55\",\"full\":false},"
+        "{\"deptCode\":\"PHYS\",\"courseCode\":9999,\"error\":\"Course Not Found\"}]}");
+}
+
+// Reads the file a response streams
+std::string ReadResponseFile(const crow::response& res) {
+    std::ifstream in(res.file, std::ios::binary);
+    std::ostringstream contents;
+    contents << in.rdbuf();
+    return contents.str();
+}
+
+TEST(RouteControllerUnitTests, ExportCatalogTest) {
+    RouteController routeController;
+    SetUpDatabase(routeController);
+    MyFileDatabase* db = MyApp::getDatabase();
+
+    crow::request req{};
+    crow::response res{};
+    routeController.exportCatalog(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, "");
+    EXPECT_EQ(res.get_header_value("Content-Type"), "text/plain");
+    EXPECT_EQ(ReadResponseFile(res), db->display());
+    std::string tag = res.get_header_value("ETag");
+    std::string path = res.file;
+
+    crow::request jsonReq{};
+    crow::response jsonRes{};
+    jsonReq.add_header("Accept", "application/json");
+    routeController.exportCatalog(jsonReq, jsonRes);
+    EXPECT_EQ(jsonRes.code, 200);
+    EXPECT_EQ(jsonRes.get_header_value("Content-Type"), "application/json");
+    std::string json;
+    JsonWriter writer(&json);
+    db->writeJson(writer);
+    EXPECT_EQ(ReadResponseFile(jsonRes), json);
+    EXPECT_NE(jsonRes.get_header_value("ETag"), tag);
+
+    // An unchanged catalog reuses its export and answers its tag with 304
+    res = crow::response{};
+    routeController.exportCatalog(req, res);
+    EXPECT_EQ(res.file, path);
+    req.add_header("If-None-Match", tag);
+    res = crow::response{};
+    routeController.exportCatalog(req, res);
+    EXPECT_EQ(res.code, 304);
+    EXPECT_EQ(res.file, "");
+
+    // A change to any department makes a new export
+    crow::request change{};
+    crow::response changed{};
+    change.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1001&location=417 IAB"};
+    routeController.setCourseLocation(change, changed);
+    res = crow::response{};
+    routeController.exportCatalog(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_NE(res.get_header_value("ETag"), tag);
+    EXPECT_NE(res.file, path);
+    std::string exported = ReadResponseFile(res);
+    EXPECT_EQ(exported, db->display());
+    EXPECT_NE(exported.find("Location: 417 IAB"), std::string::npos);
+
+    // Concurrent exports of both formats each get a complete file
+    change.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1001&location=501 NWC"};
+    routeController.setCourseLocation(change, changed);
+    json.clear();
+    JsonWriter changedWriter(&json);
+    db->writeJson(changedWriter);
+    std::vector<crow::response> responses(8);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < responses.size(); ++i) {
+        threads.emplace_back([&routeController, &responses, &jsonReq, i]() {
+            routeController.exportCatalog(i % 2 == 0 ? crow::request{} : jsonReq, responses[i]);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (size_t i = 0; i < responses.size(); ++i) {
+        EXPECT_EQ(responses[i].code, 200);
+        EXPECT_EQ(ReadResponseFile(responses[i]), i % 2 == 0 ? db->display() : json);
+        EXPECT_EQ(responses[i].file, responses[i % 2].file);
+    }
+    exported = db->display();
+
+    // Exports live in a temporary directory of their own, removed with the
+    // controller
+    std::string directory;
+    {
+        RouteController exporter;
+        exporter.setDatabase(db);
+        crow::response exportRes{};
+        exporter.exportCatalog(crow::request{}, exportRes);
+        EXPECT_EQ(ReadResponseFile(exportRes), exported);
+        directory = exportRes.file.substr(0, exportRes.file.rfind('/'));
+        EXPECT_NE(directory.find("/catalog-export-"), std::string::npos);
+    }
+    struct stat info;
+    EXPECT_NE(stat(directory.c_str(), &info), 0);
+}
+
+TEST(RouteControllerUnitTests, CompressedResponsesTest) {
+    RouteController routeController;
+    SetUpDatabase(routeController);
+    MyFileDatabase* db = MyApp::getDatabase();
+    std::map<std::string, Department> mapping = db->getDepartmentMapping();
+    std::map<int, Course> courses;
+    for (int i = 0; i < 50; ++i) {
+        courses.emplace(1000 + i, Course(100, "Adam Cannon", "417 IAB", "11:40-12:55"));
+    }
+    mapping.emplace("BIG", Department("BIG", courses, "Luca Carloni", 100));
+    db->setMapping(mapping);
+    const ResponseCache& cache = db->getResponseCache();
+
+    crow::request req{};
+    crow::response res{};
+    req.url_params = crow::query_string{"?deptCode=BIG"};
+    routeController.retrieveDepartment(req, res);
+    std::string text = res.body;
+    std::string tag = res.get_header_value("ETag");
+    EXPECT_EQ(res.get_header_value("Content-Encoding"), "");
+    EXPECT_EQ(res.get_header_value("Vary"), "Accept, Accept-Encoding");
+
+    // A large body is compressed once and then served from the cache
+    req.add_header("Accept-Encoding", "deflate;q=0.5, gzip");
+    res = crow::response{};
+    routeController.retrieveDepartment(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.get_header_value("Content-Encoding"), "gzip");
+    EXPECT_EQ(res.body, compress(text, ContentEncoding::Gzip));
+    EXPECT_LT(res.body.size(), text.size() / 5);
+    EXPECT_NE(res.get_header_value("ETag"), tag);
+    size_t cached = cache.size();
+    uint64_t hits = cache.getHitCount();
+    res = crow::response{};
+    routeController.retrieveDepartment(req, res);
+    EXPECT_EQ(res.body, compress(text, ContentEncoding::Gzip));
+    EXPECT_EQ(cache.size(), cached);
+    EXPECT_EQ(cache.getHitCount(), hits + 2);
+
+    req.headers.clear();
+    req.add_header("Accept-Encoding", "GZIP;q=0, *");
+    res = crow::response{};
+    routeController.retrieveDepartment(req, res);
+    EXPECT_EQ(res.get_header_value("Content-Encoding"), "deflate");
+    EXPECT_EQ(res.body, compress(text, ContentEncoding::Deflate));
+    req.headers.clear();
+    req.add_header("Accept-Encoding", "gzip;q=0, *;q=0");
+    res = crow::response{};
+    routeController.retrieveDepartment(req, res);
+    EXPECT_EQ(res.get_header_value("Content-Encoding"), "");
+    EXPECT_EQ(res.body, text);
+
+    // Small bodies are not worth compressing
+    crow::request small{};
+    crow::response smallRes{};
+    small.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1001"};
+    small.add_header("Accept-Encoding", "gzip");
+    routeController.retrieveCourse(small, smallRes);
+    EXPECT_EQ(smallRes.get_header_value("Content-Encoding"), "");
+    EXPECT_EQ(smallRes.body, "\nInstructor: Szabolcs Marka; Location: 301 PUP; Time: 2:40-3:55");
+
+    // Uncached responses are compressed as they are sent
+    crow::request batch{};
+    crow::response batchRes{};
+    std::string list = "?courses=BIG:1000";
+    for (int i = 1; i < 30; ++i) list += ",BIG:" + std::to_string(1000 + i);
+    batch.url_params = crow::query_string{list};
+    batch.add_header("Accept-Encoding", "gzip");
+    batch.add_header("Accept", "application/json");
+    routeController.retrieveCourses(batch, batchRes);
+    EXPECT_EQ(batchRes.code, 200);
+    EXPECT_EQ(batchRes.get_header_value("Content-Encoding"), "gzip");
+    EXPECT_EQ(static_cast<unsigned char>(batchRes.body[0]), 0x1f);
+
+    // So is the catalog export, as it is written
+    crow::request catalog{};
+    crow::response catalogRes{};
+    catalog.add_header("Accept-Encoding", "gzip");
+    routeController.exportCatalog(catalog, catalogRes);
+    EXPECT_EQ(catalogRes.code, 200);
+    EXPECT_EQ(catalogRes.get_header_value("Content-Encoding"), "gzip");
+    std::string exported = ReadResponseFile(catalogRes);
+    EXPECT_EQ(static_cast<unsigned char>(exported[0]), 0x1f);
+    EXPECT_LT(exported.size(), db->display().size() / 5);
+}
+
 TEST(RouteControllerUnitTests, IsCourseFullTest) {
     RouteController routeController;
     SetUpDatabase(routeController);
@@ -270,6 +745,99 @@ TEST(RouteControllerUnitTests, FindCourseTimeTest) {
     EXPECT_EQ(res.body, "Both department code and course code must be included in the request.");
 }
 
+TEST(RouteControllerUnitTests, FindCoursesMeetingAtTest) {
+    RouteController routeController;
+    SetUpDatabase(routeController);
+
+    crow::request req{};
+    crow::response res{};
+    req.url_params = crow::query_string{"?time=9:45"};
+    routeController.findCoursesMeetingAt(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, "CHEM 4071: 8:40-9:55\nECON 4710: 8:40-9:55\nIEOR 4511: 9:00-11:30\n");
+
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    req.url_params = crow::query_string{"?time=21:50"};
+    routeController.findCoursesMeetingAt(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, "No courses meet at 21:50");
+
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    req.url_params = crow::query_string{"?time=9:45&day=X"};
+    routeController.findCoursesMeetingAt(req, res);
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Invalid day.");
+
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    req.url_params = crow::query_string{"?time=noon"};
+    routeController.findCoursesMeetingAt(req, res);
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Invalid time.");
+
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    routeController.findCoursesMeetingAt(req, res);
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Time must be included in the request.");
+}
+
+TEST(RouteControllerUnitTests, FindCourseConflictsTest) {
+    RouteController routeController;
+    SetUpDatabase(routeController);
+
+    crow::request req{};
+    crow::response res{};
+    req.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1221"};
+    routeController.findCourseConflicts(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_NE(res.body.find("PHYS 1520: 4:10-5:25\n"), std::string::npos);
+    EXPECT_NE(res.body.find("PHYS 3801: 4:10-5:25\n"), std::string::npos);
+    EXPECT_EQ(res.body.find("PHYS 1221"), std::string::npos);
+    EXPECT_EQ(res.body.find("PHYS 1001"), std::string::npos);
+
+    // A new time slot is reflected in the next query
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    req.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1001&time=4:30-5:00"};
+    routeController.setCourseTime(req, res);
+    EXPECT_EQ(res.code, 200);
+    req.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1221"};
+    routeController.findCourseConflicts(req, res);
+    EXPECT_NE(res.body.find("PHYS 1001: 4:30-5:00\n"), std::string::npos);
+
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    req.url_params = crow::query_string{"?deptCode=PHYS&courseCode=9999"};
+    routeController.findCourseConflicts(req, res);
+    EXPECT_EQ(res.code, 404);
+    EXPECT_EQ(res.body, "Course Not Found");
+
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    req.url_params = crow::query_string{"?deptCode=none&courseCode=1001"};
+    routeController.findCourseConflicts(req, res);
+    EXPECT_EQ(res.code, 404);
+    EXPECT_EQ(res.body, "Department Not Found");
+
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    req.url_params = crow::query_string{"?deptCode=PHYS"};
+    routeController.findCourseConflicts(req, res);
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Both department code and course code must be included in the request.");
+}
+
 TEST(RouteControllerUnitTests, AddMajorToDeptTest) {
     RouteController routeController;
     SetUpDatabase(routeController);
@@ -297,6 +865,23 @@ TEST(RouteControllerUnitTests, AddMajorToDeptTest) {
     EXPECT_EQ(res.body, "Department code must be included in the request.");
 }
 
+TEST(RouteControllerUnitTests, AddMajorToDeptPersistsTest) {
+    RouteController routeController;
+    SetUpDatabase(routeController);
+
+    crow::request req{};
+    crow::response res{};
+    req.url_params = crow::query_string{"?deptCode=PHYS"};
+    routeController.addMajorToDept(req, res);
+    EXPECT_EQ(res.code, 200);
+
+    res.body.clear();
+    res.code = 0;
+    routeController.getMajorCountFromDept(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, "There are: 201 majors in the department");
+}
+
 TEST(RouteControllerUnitTests, SetEnrollmentCountTest) {
     RouteController routeController;
     SetUpDatabase(routeController);
@@ -323,6 +908,14 @@ TEST(RouteControllerUnitTests, SetEnrollmentCountTest) {
     routeController.setEnrollmentCount(req, res);
     EXPECT_EQ(res.code, 400);
     EXPECT_EQ(res.body, "Department code, course code and new count must ALL be included in the request.");
+
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    req.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1001&count=-1"};
+    routeController.setEnrollmentCount(req, res);
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Count cannot be negative.");
 }
 
 TEST(RouteControllerUnitTests, SetCourseLocationTest) {
@@ -353,6 +946,210 @@ TEST(RouteControllerUnitTests, SetCourseLocationTest) {
     EXPECT_EQ(res.body, "Department code, course code and new location must ALL be included in the request.");
 }
 
+TEST(RouteControllerUnitTests, RejectRoomConflictsTest) {
+    RouteController routeController;
+    SetUpDatabase(routeController);
+
+    // PHYS 1001 meets at 2:40-3:55, while PHYS 2000 uses 402 CHANDLER until 3:40
+    crow::request req{};
+    crow::response res{};
+    req.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1001&location=402 CHANDLER&rejectConflicts=true"};
+    routeController.setCourseLocation(req, res);
+    EXPECT_EQ(res.code, 409);
+    EXPECT_EQ(res.body, "The room is already booked at that time.");
+
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    req.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1001&time=4:30-5:00&rejectConflicts=true"};
+    routeController.setCourseTime(req, res);
+    EXPECT_EQ(res.code, 409);
+    EXPECT_EQ(res.body, "The room is already booked at that time.");
+
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    req.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1001&location=402 CHANDLER"};
+    routeController.setCourseLocation(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, "Attribute was updated successfully.");
+
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    req.url_params = crow::query_string{"?location=402 CHANDLER"};
+    routeController.findRoomConflicts(req, res);
+    EXPECT_NE(res.body.find("402 CHANDLER: PHYS 2000 (1:10-3:40) overlaps PHYS 1001 (2:40-3:55)\n"), std::string::npos);
+}
+
+TEST(RouteControllerUnitTests, FindRoomConflictsTest) {
+    RouteController routeController;
+    SetUpDatabase(routeController);
+
+    crow::request req{};
+    crow::response res{};
+    routeController.findRoomConflicts(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body,
+              "309 HAV: CHEM 1403 (6:10-7:25) overlaps PHYS 4205 (6:10-9:50)\n"
+              "402 CHANDLER: COMS 3251 (1:10-3:40) overlaps PHYS 2000 (1:10-3:40)\n"
+              "501 NWC: COMS 4156 (10:10-11:25) overlaps IEOR 4106 (10:10-11:25)\n");
+
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    req.url_params = crow::query_string{"?location=501 NWC"};
+    routeController.findRoomConflicts(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, "501 NWC: COMS 4156 (10:10-11:25) overlaps IEOR 4106 (10:10-11:25)\n");
+
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    req.url_params = crow::query_string{"?location=417 IAB"};
+    routeController.findRoomConflicts(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, "No room conflicts found.");
+}
+
+TEST(RouteControllerUnitTests, CoursesByInstructorTest) {
+    RouteController routeController;
+    SetUpDatabase(routeController);
+
+    crow::request req{};
+    crow::response res{};
+    req.url_params = crow::query_string{"?instructor=Gail Kaiser"};
+    routeController.coursesByInstructor(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, "COMS 4156\n");
+
+    // Reassigning a course moves it in the index
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    req.url_params = crow::query_string{"?deptCode=IEOR&courseCode=4106&instructor=Gail Kaiser"};
+    routeController.setCourseInstructor(req, res);
+    EXPECT_EQ(res.code, 200);
+
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    req.url_params = crow::query_string{"?instructor=Gail Kaiser"};
+    routeController.coursesByInstructor(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, "COMS 4156\nIEOR 4106\n");
+
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    req.url_params = crow::query_string{"?instructor=Kaizheng Wang"};
+    routeController.coursesByInstructor(req, res);
+    EXPECT_EQ(res.code, 404);
+    EXPECT_EQ(res.body, "Instructor Not Found");
+
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    routeController.coursesByInstructor(req, res);
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Instructor must be included in the request.");
+}
+
+TEST(RouteControllerUnitTests, CoursesByLocationTest) {
+    RouteController routeController;
+    SetUpDatabase(routeController);
+
+    crow::request req{};
+    crow::response res{};
+    req.url_params = crow::query_string{"?location=417 IAB"};
+    routeController.coursesByLocation(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, "COMS 1004: 11:40-12:55\nCOMS 3261: 2:40-3:55\nCOMS 3157: 4:10-5:25\n");
+
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    req.url_params = crow::query_string{"?location=Nowhere"};
+    routeController.coursesByLocation(req, res);
+    EXPECT_EQ(res.code, 404);
+    EXPECT_EQ(res.body, "Location Not Found");
+
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    routeController.coursesByLocation(req, res);
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Location must be included in the request.");
+}
+
+TEST(RouteControllerUnitTests, SearchTest) {
+    RouteController routeController;
+    SetUpDatabase(routeController);
+
+    crow::request req{};
+    crow::response res{};
+    req.url_params = crow::query_string{"?field=instructor&q=gail kaisr"};
+    routeController.search(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, "Gail Kaiser: COMS 4156\n");
+
+    // Renamed instructors are found under their new name
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    req.url_params = crow::query_string{"?deptCode=IEOR&courseCode=4106&instructor=Gail Kaiser"};
+    routeController.setCourseInstructor(req, res);
+    EXPECT_EQ(res.code, 200);
+
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    req.url_params = crow::query_string{"?field=instructor&q=gail k&limit=1"};
+    routeController.search(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, "Gail Kaiser: COMS 4156, IEOR 4106\n");
+
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    req.url_params = crow::query_string{"?field=location&q=501 nw"};
+    routeController.search(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, "501 NWC: COMS 4156, IEOR 4106\n");
+
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    req.url_params = crow::query_string{"?field=instructor&q=zzzz"};
+    routeController.search(req, res);
+    EXPECT_EQ(res.code, 404);
+    EXPECT_EQ(res.body, "No Matches Found");
+
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    req.url_params = crow::query_string{"?field=chair&q=gail"};
+    routeController.search(req, res);
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Field must be instructor or location.");
+
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    req.url_params = crow::query_string{"?field=instructor&q=gail&limit=0"};
+    routeController.search(req, res);
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Limit must be between 1 and 100.");
+
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    req.url_params = crow::query_string{"?q=gail"};
+    routeController.search(req, res);
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Both field and q must be included in the request.");
+}
+
 TEST(RouteControllerUnitTests, SetCourseInstructorTest) {
     RouteController routeController;
     SetUpDatabase(routeController);
@@ -387,11 +1184,19 @@ TEST(RouteControllerUnitTests, SetCourseTimeTest) {
 
     crow::request req{};
     crow::response res{};
-    req.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1001&time=14:10"};
+    req.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1001&time=14:10-15:25"};
     routeController.setCourseTime(req, res);
     EXPECT_EQ(res.code, 200);
     EXPECT_EQ(res.body, "Attribute was updated successfully.");
 
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    req.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1001&time=14:10"};
+    routeController.setCourseTime(req, res);
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Invalid time slot.");
+
     req.url_params.clear();
     res.body.clear();
     res.code = 0;
@@ -465,3 +1270,192 @@ TEST(RouteControllerUnitTests, DropStudentFromCourseTest) {
     EXPECT_EQ(res.code, 400);
     EXPECT_EQ(res.body, "Both department code and course code must be included in the request.");
 }
+
+TEST(RouteControllerUnitTests, EnrollStudentInCourseTest) {
+    RouteController routeController;
+    SetUpDatabase(routeController);
+
+    crow::request req{};
+    crow::response res{};
+    req.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1001"};
+    routeController.enrollStudentInCourse(req, res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, "Student has been enrolled");
+
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    req.url_params = crow::query_string{"?deptCode=PHYS&courseCode=1520"};
+    routeController.enrollStudentInCourse(req, res);
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Student has not been enrolled, the course is full");
+
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    req.url_params = crow::query_string{"?deptCode=PHYS&courseCode=9999"};
+    routeController.enrollStudentInCourse(req, res);
+    EXPECT_EQ(res.code, 404);
+    EXPECT_EQ(res.body, "Course Not Found");
+
+    req.url_params.clear();
+    res.body.clear();
+    res.code = 0;
+    routeController.enrollStudentInCourse(req, res);
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Both department code and course code must be included in the request.");
+}
+
+TEST(RouteControllerUnitTests, EnrollStudentByIdTest) {
+    RouteController routeController;
+    SetUpDatabase(routeController);
+
+    auto call = [&routeController](void (RouteController::*handler)(const crow::request&, crow::response&),
+                                   const std::string& query) {
+        crow::request req{};
+        crow::response res{};
+        req.url_params = crow::query_string{query};
+        (routeController.*handler)(req, res);
+        return res;
+    };
+
+    crow::response res = call(&RouteController::enrollStudentInCourse, "?deptCode=PHYS&courseCode=1001&studentId=4156");
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, "Student has been enrolled");
+    res = call(&RouteController::enrollStudentInCourse, "?deptCode=PHYS&courseCode=1001&studentId=4156");
+    EXPECT_EQ(res.code, 409);
+    EXPECT_EQ(res.body, "Student is already enrolled in the course");
+    res = call(&RouteController::enrollStudentInCourse, "?deptCode=COMS&courseCode=1004&studentId=4156");
+    EXPECT_EQ(res.code, 200);
+    res = call(&RouteController::enrollStudentInCourse, "?deptCode=PHYS&courseCode=1001&studentId=abc");
+    EXPECT_EQ(res.code, 400);
+    EXPECT_EQ(res.body, "Invalid student ID.");
+
+    res = call(&RouteController::isStudentEnrolled, "?deptCode=PHYS&courseCode=1001&studentId=4156");
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, "true");
+    res = call(&RouteController::isStudentEnrolled, "?deptCode=PHYS&courseCode=1001&studentId=17");
+    EXPECT_EQ(res.body, "false");
+    res = call(&RouteController::isStudentEnrolled, "?deptCode=PHYS&courseCode=9999&studentId=17");
+    EXPECT_EQ(res.code, 404);
+    EXPECT_EQ(res.body, "Course Not Found");
+    res = call(&RouteController::isStudentEnrolled, "?deptCode=PHYS&courseCode=1001");
+    EXPECT_EQ(res.code, 400);
+
+    res = call(&RouteController::retrieveStudentCourses, "?studentId=4156");
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, "COMS 1004\nPHYS 1001\n");
+
+    res = call(&RouteController::dropStudentFromCourse, "?deptCode=PHYS&courseCode=1001&studentId=4156");
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, "Student has been dropped");
+    res = call(&RouteController::dropStudentFromCourse, "?deptCode=PHYS&courseCode=1001&studentId=4156");
+    EXPECT_EQ(res.code, 404);
+    EXPECT_EQ(res.body, "Student is not enrolled in the course");
+
+    // Students enrolled by ID are not removed by lowering the count
+    res = call(&RouteController::setEnrollmentCount, "?deptCode=COMS&courseCode=1004&count=0");
+    EXPECT_EQ(res.code, 409);
+    EXPECT_EQ(res.body, "Count cannot be below the number of students enrolled by ID; drop them instead.");
+    res = call(&RouteController::isStudentEnrolled, "?deptCode=COMS&courseCode=1004&studentId=4156");
+    EXPECT_EQ(res.body, "true");
+
+    // Batches name students the same way
+    crow::request batch{};
+    crow::response batched{};
+    batch.body = R"({"operations": [
+        {"op": "dropStudentFromCourse", "deptCode": "COMS", "courseCode": 1004, "studentId": 4156},
+        {"op": "enrollStudentInCourse", "deptCode": "COMS", "courseCode": 1004, "studentId": 17},
+        {"op": "enrollStudentInCourse", "deptCode": "COMS", "courseCode": 1004, "studentId": 17}]})";
+    routeController.batchUpdate(batch, batched);
+    EXPECT_EQ(batched.code, 409);
+    EXPECT_EQ(batched.body, "0: Not applied\n1: Not applied\n2: Student is already enrolled\n");
+
+    res = call(&RouteController::retrieveStudentCourses, "?studentId=4156");
+    EXPECT_EQ(res.body, "COMS 1004\n");
+    res = call(&RouteController::retrieveStudentCourses, "?studentId=17");
+    EXPECT_EQ(res.code, 404);
+    EXPECT_EQ(res.body, "Student Not Found");
+    res = call(&RouteController::retrieveStudentCourses, "?studentId=-1");
+    EXPECT_EQ(res.code, 400);
+}
+
+TEST(RouteControllerUnitTests, WaitlistTest) {
+    RouteController routeController;
+    SetUpDatabase(routeController);
+
+    auto call = [&routeController](void (RouteController::*handler)(const crow::request&, crow::response&),
+                                   const std::string& query) {
+        crow::request req{};
+        crow::response res{};
+        req.url_params = crow::query_string{query};
+        (routeController.*handler)(req, res);
+        return res;
+    };
+
+    // PHYS 1520 is full
+    crow::response res = call(&RouteController::joinWaitlist, "?deptCode=PHYS&courseCode=1520&studentId=17");
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, "Student is number 1 on the waitlist");
+    res = call(&RouteController::joinWaitlist, "?deptCode=PHYS&courseCode=1520&studentId=18");
+    EXPECT_EQ(res.body, "Student is number 2 on the waitlist");
+    res = call(&RouteController::joinWaitlist, "?deptCode=PHYS&courseCode=1520&studentId=18");
+    EXPECT_EQ(res.code, 409);
+    EXPECT_EQ(res.body, "Student is already on the waitlist");
+    res = call(&RouteController::joinWaitlist, "?deptCode=PHYS&courseCode=1001&studentId=18");
+    EXPECT_EQ(res.code, 409);
+    EXPECT_EQ(res.body, "The course is not full, enroll instead");
+    res = call(&RouteController::joinWaitlist, "?deptCode=PHYS&courseCode=1520");
+    EXPECT_EQ(res.code, 400);
+
+    res = call(&RouteController::getWaitlistPosition, "?deptCode=PHYS&courseCode=1520&studentId=18");
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, "2 of 2");
+
+    // A drop enrolls the first student waiting
+    res = call(&RouteController::dropStudentFromCourse, "?deptCode=PHYS&courseCode=1520");
+    EXPECT_EQ(res.code, 200);
+    res = call(&RouteController::getWaitlistPosition, "?deptCode=PHYS&courseCode=1520&studentId=17");
+    EXPECT_EQ(res.body, "Student is enrolled");
+    res = call(&RouteController::getWaitlistPosition, "?deptCode=PHYS&courseCode=1520&studentId=18");
+    EXPECT_EQ(res.body, "1 of 1");
+    res = call(&RouteController::retrieveStudentCourses, "?studentId=17");
+    EXPECT_EQ(res.body, "PHYS 1520\n");
+
+    res = call(&RouteController::leaveWaitlist, "?deptCode=PHYS&courseCode=1520&studentId=18");
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.body, "Student has left the waitlist");
+    res = call(&RouteController::leaveWaitlist, "?deptCode=PHYS&courseCode=1520&studentId=18");
+    EXPECT_EQ(res.code, 404);
+    res = call(&RouteController::getWaitlistPosition, "?deptCode=PHYS&courseCode=1520&studentId=18");
+    EXPECT_EQ(res.code, 404);
+    EXPECT_EQ(res.body, "Student is not on the waitlist");
+
+    crow::request batch{};
+    crow::response batched{};
+    batch.body = R"({"operations": [
+        {"op": "joinWaitlist", "deptCode": "PHYS", "courseCode": 1520, "studentId": 18},
+        {"op": "joinWaitlist", "deptCode": "PHYS", "courseCode": 1520, "studentId": 18}]})";
+    routeController.batchUpdate(batch, batched);
+    EXPECT_EQ(batched.code, 409);
+    EXPECT_EQ(batched.body, "0: Not applied\n1: Student is already on the waitlist\n");
+    batch.body = R"({"operations": [{"op": "leaveWaitlist", "deptCode": "PHYS", "courseCode": 1520}]})";
+    batched = crow::response{};
+    routeController.batchUpdate(batch, batched);
+    EXPECT_EQ(batched.code, 400);
+}
+
+TEST(RouteControllerUnitTests, ExportMetricsTest) {
+    RouteController routeController;
+    SetUpDatabase(routeController);
+
+    crow::response res{};
+    routeController.exportMetrics(res);
+    EXPECT_EQ(res.code, 200);
+    EXPECT_EQ(res.get_header_value("Content-Type"), "text/plain; version=0.0.4");
+    EXPECT_NE(res.body.find("# TYPE http_request_duration_seconds histogram\n"), std::string::npos);
+    EXPECT_NE(res.body.find("http_request_duration_seconds_count{route=\"/retrieveCourse\"} 0\n"), std::string::npos);
+    EXPECT_NE(res.body.find("\ncatalog_departments 5\n"), std::string::npos);
+    EXPECT_NE(res.body.find("\ncatalog_courses 38\n"), std::string::npos);
+    EXPECT_NE(res.body.find("\ncatalog_checkpoints_total 1\n"), std::string::npos);
+}
@@ -0,0 +1,92 @@
+// Copyright 2024 Maria Surani
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "SearchIndex.h"
+
+namespace {
+
+std::vector<std::string> values(
+    const std::vector<SearchIndex::Match>& matches) {
+  std::vector<std::string> result;
+  for (const auto& match : matches) result.push_back(match.value);
+  return result;
+}
+
+void addInstructors(SearchIndex* index) {
+  index->rebuild({"Krzysztof M Choromanski", "Adam Cannon", "Adam Cannon",
+                  "Adam Cannon Jr", "Gail Kaiser", "Kaizheng Wang", ""});
+}
+
+}  // namespace
+
+TEST(SearchIndexUnitTests, PrefixTest) {
+  SearchIndex index;
+  addInstructors(&index);
+  EXPECT_EQ(index.size(), 5u);
+
+  // The last word is matched as a prefix, and shorter values rank first
+  EXPECT_EQ(values(index.search("ad", 10)),
+            (std::vector<std::string>{"Adam Cannon", "Adam Cannon Jr"}));
+  EXPECT_EQ(values(index.search("CHOROM", 10)),
+            (std::vector<std::string>{"Krzysztof M Choromanski"}));
+  EXPECT_EQ(values(index.search("kai", 10)),
+            (std::vector<std::string>{"Gail Kaiser", "Kaizheng Wang"}));
+  EXPECT_EQ(index.search("kai", 1).size(), 1u);
+
+  EXPECT_TRUE(index.search("", 10).empty());
+  EXPECT_TRUE(index.search("-- ", 10).empty());
+  EXPECT_TRUE(index.search("zebra", 10).empty());
+}
+
+TEST(SearchIndexUnitTests, MisspelledTest) {
+  SearchIndex index;
+  addInstructors(&index);
+  auto matches = index.search("Kryzstof Chormanski", 3);
+  ASSERT_FALSE(matches.empty());
+  EXPECT_EQ(matches[0].value, "Krzysztof M Choromanski");
+  EXPECT_GE(matches[0].score, SearchIndex::kMinScore);
+  EXPECT_LT(matches[0].score, 1.0);
+
+  // Counts from one search do not leak into the next, in any index
+  SearchIndex other;
+  other.rebuild({"Krzysztof M Choromanski"});
+  EXPECT_DOUBLE_EQ(other.search("Kryzstof Chormanski", 3)[0].score,
+                   matches[0].score);
+  EXPECT_DOUBLE_EQ(index.search("Kryzstof Chormanski", 3)[0].score,
+                   matches[0].score);
+
+  // A finished word must match as a whole word
+  auto exact = index.search("adam cannon ", 10);
+  ASSERT_EQ(exact.size(), 2u);
+  EXPECT_EQ(exact[0].value, "Adam Cannon");
+  EXPECT_DOUBLE_EQ(exact[0].score, 1.0);
+}
+
+TEST(SearchIndexUnitTests, AddRemoveTest) {
+  SearchIndex index;
+  addInstructors(&index);
+
+  // "Adam Cannon" teaches two courses, so it stays until both are gone
+  index.update("Adam Cannon", "Jae Lee");
+  EXPECT_EQ(values(index.search("cannon ", 10)),
+            (std::vector<std::string>{"Adam Cannon", "Adam Cannon Jr"}));
+  index.remove("Adam Cannon");
+  EXPECT_EQ(values(index.search("cannon ", 10)),
+            (std::vector<std::string>{"Adam Cannon Jr"}));
+  EXPECT_EQ(values(index.search("jae", 10)),
+            (std::vector<std::string>{"Jae Lee"}));
+
+  // Freed slots are reused
+  index.add("Adam Cannon");
+  EXPECT_EQ(index.size(), 6u);
+  EXPECT_EQ(values(index.search("adam c", 10)),
+            (std::vector<std::string>{"Adam Cannon", "Adam Cannon Jr"}));
+
+  // Removing a value no course has changes nothing
+  index.remove("Nobody");
+  index.update("Jae Lee", "Jae Lee");
+  EXPECT_EQ(index.size(), 6u);
+}
@@ -0,0 +1,43 @@
+// Copyright 2024 Maria Surani
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "ShardedCounter.h"
+
+TEST(ShardedCounterUnitTests, AddStoreTest) {
+  ShardedCounter counter(500);
+  EXPECT_EQ(counter.load(), 500);
+  counter.add(3);
+  counter.add(-5);
+  EXPECT_EQ(counter.load(), 498);
+  counter.store(-2);
+  EXPECT_EQ(counter.load(), -2);
+}
+
+TEST(ShardedCounterUnitTests, CopyTest) {
+  ShardedCounter counter(10);
+  counter.add(1);
+  ShardedCounter copy(counter);
+  counter.add(1);
+  EXPECT_EQ(copy.load(), 11);
+  copy = counter;
+  EXPECT_EQ(copy.load(), 12);
+}
+
+TEST(ShardedCounterUnitTests, ConcurrentAddTest) {
+  // More threads than slots, so some threads share a slot
+  const int threadCount = ShardedCounter::kSlots + 4;
+  const int addsPerThread = 10000;
+  ShardedCounter counter;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < threadCount; ++t) {
+    threads.emplace_back([&counter, t]() {
+      for (int i = 0; i < addsPerThread; ++i) counter.add(t % 2 ? 2 : -1);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  // Each pair of threads adds 2 and -1 addsPerThread times
+  EXPECT_EQ(counter.load(), (threadCount / 2) * addsPerThread);
+}
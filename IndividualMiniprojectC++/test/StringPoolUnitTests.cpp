@@ -0,0 +1,87 @@
+// Copyright 2024 Maria Surani
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Course.h"
+#include "StringPool.h"
+
+TEST(StringPoolUnitTests, InternReturnsSameStringTest) {
+  StringPool pool;
+  StringPool::Entry* first = pool.acquire("417 IAB");
+  StringPool::Entry* second = pool.acquire(std::string("417 ") + "IAB");
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(first->first, "417 IAB");
+  EXPECT_EQ(first->second.load(), 2u);
+  StringPool::Entry* other = pool.acquire("309 HAV");
+  EXPECT_NE(other, first);
+  EXPECT_EQ(pool.size(), 2u);
+}
+
+TEST(StringPoolUnitTests, SweepFreesUnusedStringsTest) {
+  StringPool pool;
+  StringPool::Entry* kept = pool.acquire("417 IAB");
+  StringPool::Entry* dropped = pool.acquire("309 HAV");
+  StringPool::release(dropped);
+  EXPECT_EQ(pool.size(), 2u);
+  pool.sweep();
+  EXPECT_EQ(pool.size(), 1u);
+  EXPECT_EQ(pool.acquire("417 IAB"), kept);
+}
+
+TEST(StringPoolUnitTests, InternedStringEqualityTest) {
+  InternedString empty;
+  EXPECT_EQ(empty.str(), "");
+  EXPECT_EQ(empty, InternedString(""));
+  EXPECT_EQ(InternedString("10:10-11:25"), InternedString("10:10-11:25"));
+  EXPECT_NE(InternedString("10:10-11:25"), InternedString("2:40-3:55"));
+}
+
+TEST(StringPoolUnitTests, CoursesShareStringsTest) {
+  Course first(100, "Adam Cannon", "417 IAB", "11:40-12:55");
+  Course second(200, "Adam Cannon", "309 HAV", "11:40-12:55");
+  EXPECT_EQ(&first.getInstructorName(), &second.getInstructorName());
+  EXPECT_EQ(&first.getCourseTimeSlot(), &second.getCourseTimeSlot());
+
+  Course copy = first;
+  EXPECT_EQ(&copy.getCourseLocation(), &first.getCourseLocation());
+  first.reassignLocation("501 NWC");
+  EXPECT_EQ(first.getCourseLocation(), "501 NWC");
+  EXPECT_EQ(copy.getCourseLocation(), "417 IAB");
+}
+
+TEST(StringPoolUnitTests, ReassignedValuesDoNotAccumulateTest) {
+  StringPool& pool = StringPool::global();
+  pool.sweep();
+  size_t before = pool.size();
+  Course course(100, "Adam Cannon", "417 IAB", "11:40-12:55");
+  for (int i = 0; i < 20000; ++i) {
+    course.reassignLocation("Room " + std::to_string(i));
+  }
+  // Sweeps run once the pool gains as many strings as it kept, or 1024
+  EXPECT_LE(pool.size(), 2 * (before + 1024));
+  EXPECT_EQ(course.getCourseLocation(), "Room 19999");
+}
+
+TEST(StringPoolUnitTests, ConcurrentInternTest) {
+  StringPool pool;
+  std::vector<std::thread> threads;
+  std::vector<StringPool::Entry*> results(8);
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&pool, &results, t]() {
+      for (int i = 0; i < 1000; ++i) {
+        pool.acquire("Room " + std::to_string(i));
+      }
+      results[t] = pool.acquire("Room 500");
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(pool.size(), 1000u);
+  for (StringPool::Entry* result : results) {
+    EXPECT_EQ(result, results[0]);
+  }
+}
@@ -0,0 +1,60 @@
+// Copyright 2024 Maria Surani
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "StudentIndex.h"
+
+namespace {
+
+std::vector<std::string> describe(
+    const std::vector<StudentIndex::Enrollment>& courses) {
+  std::vector<std::string> result;
+  for (const auto& course : courses) {
+    result.push_back(course.deptCode + " " +
+                     std::to_string(course.courseNumber));
+  }
+  return result;
+}
+
+}  // namespace
+
+TEST(StudentIndexUnitTests, RebuildTest) {
+  StudentIndex index;
+  index.rebuild({{7, {"COMS", 4156}},
+                 {7, {"ECON", 1105}},
+                 {7, {"COMS", 1004}},
+                 {8, {"COMS", 1004}},
+                 {7, {"COMS", 1004}}});
+  EXPECT_EQ(index.getStudentCount(), 2u);
+  EXPECT_EQ(describe(index.findCourses(7)),
+            (std::vector<std::string>{"COMS 1004", "COMS 4156", "ECON 1105"}));
+  EXPECT_EQ(describe(index.findCourses(8)),
+            (std::vector<std::string>{"COMS 1004"}));
+  EXPECT_TRUE(index.findCourses(9).empty());
+
+  index.rebuild({});
+  EXPECT_EQ(index.getStudentCount(), 0u);
+  EXPECT_TRUE(index.findCourses(7).empty());
+}
+
+TEST(StudentIndexUnitTests, AddRemoveTest) {
+  StudentIndex index;
+  index.add(7, "IEOR", 2500);
+  index.add(7, "CHEM", 1403);
+  EXPECT_EQ(describe(index.findCourses(7)),
+            (std::vector<std::string>{"CHEM 1403", "IEOR 2500"}));
+
+  // Removing a course the student is not in changes nothing
+  index.remove(7, "CHEM", 1500);
+  index.remove(8, "CHEM", 1403);
+  EXPECT_EQ(index.findCourses(7).size(), 2u);
+
+  index.remove(7, "CHEM", 1403);
+  EXPECT_EQ(describe(index.findCourses(7)),
+            (std::vector<std::string>{"IEOR 2500"}));
+  index.remove(7, "IEOR", 2500);
+  EXPECT_TRUE(index.findCourses(7).empty());
+  EXPECT_EQ(index.getStudentCount(), 0u);
+}
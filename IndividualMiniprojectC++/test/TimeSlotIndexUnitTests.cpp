@@ -0,0 +1,111 @@
+// Copyright 2024 Maria Surani
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "TimeSlotIndex.h"
+
+namespace {
+
+std::vector<std::string> describe(const std::vector<ScheduledCourse>& courses) {
+  std::vector<std::string> result;
+  for (const auto& course : courses) {
+    result.push_back(course.deptCode + " " +
+                     std::to_string(course.courseNumber));
+  }
+  return result;
+}
+
+bool catalogOrder(const ScheduledCourse& a, const ScheduledCourse& b) {
+  return a.deptCode != b.deptCode ? a.deptCode < b.deptCode
+                                  : a.courseNumber < b.courseNumber;
+}
+
+std::string randomSlot(std::minstd_rand* random) {
+  int start = 8 * 60 + static_cast<int>((*random)() % (12 * 60));
+  int end = start + 30 + static_cast<int>((*random)() % 150);
+  auto clock = [](int minute) {
+    std::string minutes = std::to_string(minute % 60);
+    return std::to_string(minute / 60) + ":" +
+           (minutes.size() == 1 ? "0" + minutes : minutes);
+  };
+  const char* days[] = {"MW ", "TR ", "F ", ""};
+  return days[(*random)() % 4] + clock(start) + "-" + clock(end);
+}
+
+}  // namespace
+
+TEST(TimeSlotIndexUnitTests, FindMeetingAtTest) {
+  TimeSlotIndex index;
+  index.rebuild({{"COMS", 1004, TimeSlot("11:40-12:55")},
+                 {"COMS", 3134, TimeSlot("4:10-5:25")},
+                 {"ECON", 1105, TimeSlot("MW 11:00-12:00")},
+                 {"CHEM", 1403, TimeSlot("not scheduled")}});
+  EXPECT_EQ(index.size(), 3u);
+
+  int minute;
+  TimeSlot::parseTime("11:45", &minute);
+  // Matches are ordered by start time
+  EXPECT_EQ(describe(index.findMeetingAt(minute, TimeSlot::kEveryDay)),
+            (std::vector<std::string>{"ECON 1105", "COMS 1004"}));
+  uint8_t tuesday;
+  TimeSlot::parseDays("T", &tuesday);
+  EXPECT_EQ(describe(index.findMeetingAt(minute, tuesday)),
+            (std::vector<std::string>{"COMS 1004"}));
+  EXPECT_TRUE(index.findMeetingAt(8 * 60, TimeSlot::kEveryDay).empty());
+}
+
+TEST(TimeSlotIndexUnitTests, UpdateAndEraseTest) {
+  TimeSlotIndex index;
+  index.insert({"COMS", 1004, TimeSlot("11:40-12:55")});
+  index.insert({"COMS", 3134, TimeSlot("11:40-12:55")});
+  index.insert({"IEOR", 2500, TimeSlot("bad")});
+  EXPECT_EQ(index.size(), 2u);
+
+  index.update("COMS", 3134, TimeSlot("11:40-12:55"), TimeSlot("4:10-5:25"));
+  EXPECT_EQ(index.size(), 2u);
+  EXPECT_EQ(describe(index.findOverlapping(TimeSlot("12:00-12:30"))),
+            (std::vector<std::string>{"COMS 1004"}));
+  EXPECT_EQ(describe(index.findOverlapping(TimeSlot("5:00-6:00"))),
+            (std::vector<std::string>{"COMS 3134"}));
+
+  EXPECT_TRUE(index.erase({"COMS", 1004, TimeSlot("11:40-12:55")}));
+  EXPECT_FALSE(index.erase({"COMS", 1004, TimeSlot("11:40-12:55")}));
+  EXPECT_EQ(index.size(), 1u);
+  EXPECT_TRUE(index.findOverlapping(TimeSlot("12:00-12:30")).empty());
+}
+
+TEST(TimeSlotIndexUnitTests, MatchesFullScanTest) {
+  std::minstd_rand random(4156);
+  std::vector<ScheduledCourse> courses;
+  for (int i = 0; i < 2000; ++i) {
+    courses.push_back({"D" + std::to_string(i % 7), i,
+                       TimeSlot(randomSlot(&random))});
+  }
+  TimeSlotIndex index;
+  index.rebuild({courses.begin(), courses.begin() + 1000});
+  for (size_t i = 1000; i < courses.size(); ++i) index.insert(courses[i]);
+  // Moves some courses so the tree mixes built and inserted nodes
+  for (size_t i = 0; i < courses.size(); i += 3) {
+    TimeSlot newSlot(randomSlot(&random));
+    index.update(courses[i].deptCode, courses[i].courseNumber,
+                 courses[i].timeSlot, newSlot);
+    courses[i].timeSlot = newSlot;
+  }
+  ASSERT_EQ(index.size(), courses.size());
+
+  for (int query = 0; query < 200; ++query) {
+    TimeSlot slot(randomSlot(&random));
+    std::vector<ScheduledCourse> expected;
+    for (const auto& course : courses) {
+      if (course.timeSlot.overlaps(slot)) expected.push_back(course);
+    }
+    std::sort(expected.begin(), expected.end(), catalogOrder);
+    auto found = index.findOverlapping(slot);
+    std::sort(found.begin(), found.end(), catalogOrder);
+    EXPECT_EQ(describe(found), describe(expected));
+  }
+}
@@ -0,0 +1,83 @@
+// Copyright 2024 Maria Surani
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "TimeSlot.h"
+
+TEST(TimeSlotUnitTests, ParseCatalogTimesTest) {
+  TimeSlot morning("10:10-11:25");
+  ASSERT_TRUE(morning.isValid());
+  EXPECT_EQ(morning.getStartMinute(), 10 * 60 + 10);
+  EXPECT_EQ(morning.getEndMinute(), 11 * 60 + 25);
+  EXPECT_EQ(morning.getDays(), TimeSlot::kEveryDay);
+  EXPECT_EQ(morning.str(), "10:10-11:25");
+
+  // Hours 1 to 7 are in the afternoon, and an end time follows the start
+  TimeSlot afternoon("4:10-5:25");
+  EXPECT_EQ(afternoon.getStartMinute(), 16 * 60 + 10);
+  EXPECT_EQ(afternoon.getEndMinute(), 17 * 60 + 25);
+  TimeSlot overNoon("11:40-12:55");
+  EXPECT_EQ(overNoon.getEndMinute(), 12 * 60 + 55);
+  TimeSlot evening("7:10-9:40");
+  EXPECT_EQ(evening.getStartMinute(), 19 * 60 + 10);
+  EXPECT_EQ(evening.getEndMinute(), 21 * 60 + 40);
+
+  TimeSlot twentyFourHour("13:00-14:00");
+  EXPECT_EQ(twentyFourHour.getStartMinute(), 13 * 60);
+  EXPECT_EQ(twentyFourHour.getEndMinute(), 14 * 60);
+}
+
+TEST(TimeSlotUnitTests, ParseDaysTest) {
+  TimeSlot slot("MW 11:40-12:55");
+  ASSERT_TRUE(slot.isValid());
+  EXPECT_EQ(slot.str(), "MW 11:40-12:55");
+
+  uint8_t days;
+  ASSERT_TRUE(TimeSlot::parseDays("WM", &days));
+  EXPECT_EQ(slot.getDays(), days);
+  ASSERT_TRUE(TimeSlot::parseDays("U", &days));
+  EXPECT_EQ(days, 1 << 6);
+  EXPECT_FALSE(TimeSlot::parseDays("", &days));
+  EXPECT_FALSE(TimeSlot::parseDays("MX", &days));
+}
+
+TEST(TimeSlotUnitTests, InvalidTimesTest) {
+  const char* invalid[] = {"",         "11:40",      "11:40-",    "x-12:55",
+                           "1:1-2:25", "14:10-13:00", "25:00-26:00",
+                           "10:60-11:00", "XY 10:10-11:25", "10:10-11:25 "};
+  for (const char* text : invalid) {
+    TimeSlot slot(text);
+    EXPECT_FALSE(slot.isValid()) << text;
+    EXPECT_EQ(slot.str(), text);
+  }
+  EXPECT_FALSE(TimeSlot().isValid());
+}
+
+TEST(TimeSlotUnitTests, ParseTimeTest) {
+  int minute;
+  ASSERT_TRUE(TimeSlot::parseTime("11:45", &minute));
+  EXPECT_EQ(minute, 11 * 60 + 45);
+  ASSERT_TRUE(TimeSlot::parseTime("4:10", &minute));
+  EXPECT_EQ(minute, 16 * 60 + 10);
+  ASSERT_TRUE(TimeSlot::parseTime("0:05", &minute));
+  EXPECT_EQ(minute, 5);
+  EXPECT_FALSE(TimeSlot::parseTime("24:00", &minute));
+  EXPECT_FALSE(TimeSlot::parseTime("noon", &minute));
+}
+
+TEST(TimeSlotUnitTests, OverlapsTest) {
+  TimeSlot first("MW 10:10-11:25");
+  EXPECT_TRUE(first.overlaps(TimeSlot("11:00-12:00")));
+  EXPECT_TRUE(first.overlaps(TimeSlot("W 10:30-10:45")));
+  EXPECT_FALSE(first.overlaps(TimeSlot("TR 10:10-11:25")));
+  // Back-to-back courses do not conflict
+  EXPECT_FALSE(first.overlaps(TimeSlot("11:25-12:40")));
+  EXPECT_FALSE(first.overlaps(TimeSlot("sometime")));
+
+  EXPECT_TRUE(first.meetsAt(10 * 60 + 10, TimeSlot::kEveryDay));
+  EXPECT_FALSE(first.meetsAt(11 * 60 + 25, TimeSlot::kEveryDay));
+  uint8_t friday;
+  TimeSlot::parseDays("F", &friday);
+  EXPECT_FALSE(first.meetsAt(10 * 60 + 30, friday));
+}
@@ -0,0 +1,62 @@
+// Copyright 2024 Maria Surani
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Waitlist.h"
+
+TEST(WaitlistUnitTests, JoinLeaveTest) {
+  Waitlist waitlist;
+  EXPECT_TRUE(waitlist.empty());
+  EXPECT_TRUE(waitlist.join(4156));
+  EXPECT_TRUE(waitlist.join(17));
+  EXPECT_TRUE(waitlist.join(900000));
+  EXPECT_FALSE(waitlist.join(17));
+  EXPECT_EQ(waitlist.size(), 3u);
+
+  // Students wait in the order they joined, not by ID
+  EXPECT_EQ(waitlist.getPosition(4156), 1u);
+  EXPECT_EQ(waitlist.getPosition(17), 2u);
+  EXPECT_EQ(waitlist.getPosition(5), 0u);
+
+  EXPECT_TRUE(waitlist.leave(17));
+  EXPECT_FALSE(waitlist.leave(17));
+  EXPECT_EQ(waitlist.getPosition(900000), 2u);
+
+  EXPECT_EQ(waitlist.front(), 4156u);
+  waitlist.popFront();
+  EXPECT_EQ(waitlist.getStudentIds(), std::vector<uint32_t>{900000});
+}
+
+TEST(WaitlistUnitTests, StrParseTest) {
+  Waitlist waitlist;
+  EXPECT_EQ(waitlist.str(), "");
+  waitlist.join(4156);
+  waitlist.join(17);
+  EXPECT_EQ(waitlist.str(), "4156,17");
+
+  Waitlist parsed;
+  ASSERT_TRUE(Waitlist::parse("4156,17", &parsed));
+  EXPECT_EQ(parsed.getStudentIds(), waitlist.getStudentIds());
+  ASSERT_TRUE(Waitlist::parse("", &parsed));
+  EXPECT_TRUE(parsed.empty());
+
+  for (const char* bad : {",", "4156,", ",17", "4156,,17", "17,17", "x"}) {
+    EXPECT_FALSE(Waitlist::parse(bad, &parsed)) << bad;
+  }
+}
+
+TEST(WaitlistUnitTests, EncodeDecodeTest) {
+  Waitlist waitlist;
+  for (uint32_t id : {50000u, 0u, UINT32_MAX, 128u}) waitlist.join(id);
+  std::string encoded = waitlist.encode();
+  Waitlist decoded;
+  ASSERT_TRUE(Waitlist::decode(encoded.data(), encoded.size(), &decoded));
+  EXPECT_EQ(decoded.getStudentIds(), waitlist.getStudentIds());
+
+  EXPECT_FALSE(Waitlist::decode("\x81", 1, &decoded));
+  EXPECT_FALSE(Waitlist::decode("\x05\x05", 2, &decoded));
+  EXPECT_FALSE(Waitlist::decode("\xff\xff\xff\xff\x1f", 5, &decoded));
+}
@@ -0,0 +1,230 @@
+// Copyright 2024 Maria Surani
+#include <gtest/gtest.h>
+#include <sys/resource.h>
+
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "WriteAheadLog.h"
+
+namespace {
+
+const char* kLogPath = "wal_unit_test.wal";
+const char* kRotatedPath = "wal_unit_test.wal.old";
+
+std::vector<Mutation> replayAll(uint64_t afterLsn = 0) {
+  std::vector<Mutation> replayed;
+  WriteAheadLog log(kLogPath);
+  log.replay(afterLsn, [&replayed](const Mutation& mutation) {
+    replayed.push_back(mutation);
+  });
+  return replayed;
+}
+
+size_t logSize() {
+  std::ifstream inFile(kLogPath, std::ios::binary | std::ios::ate);
+  return static_cast<size_t>(inFile.tellg());
+}
+
+}  // namespace
+
+class WriteAheadLogUnitTests : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    std::remove(kLogPath);
+    std::remove(kRotatedPath);
+  }
+  void TearDown() override {
+    std::remove(kLogPath);
+    std::remove(kRotatedPath);
+  }
+};
+
+TEST_F(WriteAheadLogUnitTests, AppendAndReplayTest) {
+  {
+    WriteAheadLog log(kLogPath);
+    uint64_t first = log.append(
+        {MutationType::ChangeLocation, "COMS", "1004", "501 NWC"});
+    uint64_t second = log.append({MutationType::AddMajor, "COMS", "", ""});
+    EXPECT_EQ(first, 1u);
+    EXPECT_EQ(second, 2u);
+    log.waitForDurable(second);
+  }
+
+  auto replayed = replayAll();
+  ASSERT_EQ(replayed.size(), 2u);
+  EXPECT_EQ(replayed[0].type, MutationType::ChangeLocation);
+  EXPECT_EQ(replayed[0].deptCode, "COMS");
+  EXPECT_EQ(replayed[0].courseCode, "1004");
+  EXPECT_EQ(replayed[0].value, "501 NWC");
+  EXPECT_EQ(replayed[1].type, MutationType::AddMajor);
+
+  EXPECT_EQ(replayAll(1).size(), 1u);
+}
+
+TEST_F(WriteAheadLogUnitTests, UnflushedRecordsAreLostTest) {
+  {
+    WriteAheadLog log(kLogPath);
+    log.waitForDurable(log.append({MutationType::AddMajor, "COMS", "", ""}));
+    log.append({MutationType::RemoveMajor, "COMS", "", ""});
+  }
+  EXPECT_EQ(replayAll().size(), 1u);
+}
+
+TEST_F(WriteAheadLogUnitTests, TornRecordIsCutOffTest) {
+  {
+    WriteAheadLog log(kLogPath);
+    log.waitForDurable(log.append({MutationType::AddMajor, "COMS", "", ""}));
+  }
+  {
+    std::ofstream torn(kLogPath, std::ios::binary | std::ios::app);
+    torn.write("\x20\x00\x00\x00garbage", 11);
+  }
+
+  std::vector<Mutation> replayed;
+  {
+    WriteAheadLog log(kLogPath);
+    log.replay(0, [&replayed](const Mutation& m) { replayed.push_back(m); });
+    EXPECT_EQ(log.getLastLsn(), 1u);
+    log.waitForDurable(log.append({MutationType::AddMajor, "ECON", "", ""}));
+  }
+  EXPECT_EQ(replayed.size(), 1u);
+
+  auto afterRepair = replayAll();
+  ASSERT_EQ(afterRepair.size(), 2u);
+  EXPECT_EQ(afterRepair[1].deptCode, "ECON");
+}
+
+TEST_F(WriteAheadLogUnitTests, BatchRecordTest) {
+  {
+    WriteAheadLog log(kLogPath);
+    log.append({MutationType::AddMajor, "COMS", "", ""});
+    uint64_t batch =
+        log.append(std::vector<Mutation>{
+            {MutationType::ChangeLocation, "COMS", "1004", "501 NWC"},
+            {MutationType::SetEnrollmentCount, "ECON", "1105", "12"},
+            {MutationType::RemoveMajor, "ECON", "", ""}});
+    EXPECT_EQ(batch, 2u);
+    log.waitForDurable(log.append({MutationType::AddMajor, "PHYS", "", ""}));
+  }
+
+  auto replayed = replayAll();
+  ASSERT_EQ(replayed.size(), 5u);
+  EXPECT_EQ(replayed[1].type, MutationType::ChangeLocation);
+  EXPECT_EQ(replayed[1].value, "501 NWC");
+  EXPECT_EQ(replayed[2].courseCode, "1105");
+  EXPECT_EQ(replayed[3].type, MutationType::RemoveMajor);
+  EXPECT_EQ(replayed[4].deptCode, "PHYS");
+  // The whole batch has one LSN
+  EXPECT_EQ(replayAll(2).size(), 1u);
+  EXPECT_EQ(replayAll(1).size(), 4u);
+}
+
+TEST_F(WriteAheadLogUnitTests, TornBatchIsDroppedWholeTest) {
+  {
+    WriteAheadLog log(kLogPath);
+    log.waitForDurable(log.append({MutationType::AddMajor, "COMS", "", ""}));
+    log.waitForDurable(log.append(std::vector<Mutation>{
+        {MutationType::AddMajor, "ECON", "", ""},
+        {MutationType::AddMajor, "PHYS", "", ""}}));
+  }
+  {
+    // Lose the last byte of the batch, as a crash mid-write would
+    std::ifstream in(kLogPath, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(in)),
+                         std::istreambuf_iterator<char>());
+    std::ofstream out(kLogPath, std::ios::binary | std::ios::trunc);
+    out.write(contents.data(), contents.size() - 1);
+  }
+  auto replayed = replayAll();
+  ASSERT_EQ(replayed.size(), 1u);
+  EXPECT_EQ(replayed[0].deptCode, "COMS");
+}
+
+TEST_F(WriteAheadLogUnitTests, TruncateTest) {
+  WriteAheadLog log(kLogPath);
+  log.waitForDurable(log.append({MutationType::AddMajor, "COMS", "", ""}));
+  log.truncate();
+  EXPECT_EQ(replayAll().size(), 0u);
+
+  // LSNs keep increasing across a truncation
+  EXPECT_EQ(log.append({MutationType::AddMajor, "COMS", "", ""}), 2u);
+}
+
+TEST_F(WriteAheadLogUnitTests, FailedWriteIsRetriedTest) {
+  WriteAheadLog log(kLogPath);
+  log.waitForDurable(log.append({MutationType::AddMajor, "COMS", "", ""}));
+  size_t goodSize = logSize();
+
+  // Cap the file size so that the next write stops partway through a record
+  rlimit original;
+  ASSERT_EQ(getrlimit(RLIMIT_FSIZE, &original), 0);
+  rlimit capped = original;
+  capped.rlim_cur = goodSize + 20;
+  auto previousHandler = std::signal(SIGXFSZ, SIG_IGN);
+  ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &capped), 0);
+  uint64_t lsn = log.append(
+      {MutationType::ChangeLocation, "COMS", "1004", std::string(100, 'x')});
+  EXPECT_THROW(log.waitForDurable(lsn), std::runtime_error);
+  setrlimit(RLIMIT_FSIZE, &original);
+  std::signal(SIGXFSZ, previousHandler);
+
+  // The torn record was cut off, and the next flush writes it again
+  EXPECT_EQ(logSize(), goodSize);
+  log.waitForDurable(log.append({MutationType::RemoveMajor, "COMS", "", ""}));
+  auto replayed = replayAll();
+  ASSERT_EQ(replayed.size(), 3u);
+  EXPECT_EQ(replayed[1].value, std::string(100, 'x'));
+  EXPECT_EQ(replayed[2].type, MutationType::RemoveMajor);
+}
+
+TEST_F(WriteAheadLogUnitTests, GroupCommitFromManyThreadsTest) {
+  const int kThreads = 8;
+  const int kRecordsPerThread = 50;
+  {
+    WriteAheadLog log(kLogPath);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+      threads.emplace_back([&log]() {
+        for (int i = 0; i < kRecordsPerThread; ++i) {
+          log.waitForDurable(
+              log.append({MutationType::EnrollStudent, "PHYS", "1520", ""}));
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+  EXPECT_EQ(replayAll().size(),
+            static_cast<size_t>(kThreads * kRecordsPerThread));
+}
+
+TEST_F(WriteAheadLogUnitTests, RotateTest) {
+  {
+    WriteAheadLog log(kLogPath);
+    log.append({MutationType::AddMajor, "COMS", "", ""});
+    EXPECT_EQ(log.rotate(), 1u);
+    log.waitForDurable(log.append({MutationType::RemoveMajor, "COMS", "", ""}));
+  }
+
+  // A crash before discardRotated() replays both files in order
+  auto replayed = replayAll();
+  ASSERT_EQ(replayed.size(), 2u);
+  EXPECT_EQ(replayed[0].type, MutationType::AddMajor);
+  EXPECT_EQ(replayed[1].type, MutationType::RemoveMajor);
+  EXPECT_EQ(replayAll(1).size(), 1u);
+
+  {
+    WriteAheadLog log(kLogPath);
+    log.discardRotated();
+  }
+  EXPECT_EQ(std::ifstream(kRotatedPath).good(), false);
+  EXPECT_EQ(replayAll().size(), 1u);
+}
@@ -0,0 +1,44 @@
+// Copyright 2024 Maria Surani
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "MappedDataFile.h"
+#include "MyFileDatabase.h"
+
+/**
+ *  Converts a data file in the original format to the mapped one in place. The
+ *  file's write-ahead log is replayed first, so no logged change is lost.
+ *  The service must not be running on the same file.
+ */
+int main(int argc, char* argv[]) {
+  if (argc != 2) {
+    std::cerr << "Usage: " << argv[0] << " <data file>" << std::endl;
+    return 2;
+  }
+  const std::string path = argv[1];
+  if (!std::ifstream(path)) {
+    std::cerr << "Cannot open " << path << std::endl;
+    return 1;
+  }
+  try {
+    if (MappedDataFile::isMappedFormat(path)) {
+      std::cout << path << " is already in version "
+                << MappedDataFile::kVersion << " format" << std::endl;
+      return 0;
+    }
+    MyFileDatabase database(0, path);
+    size_t departments = database.getDepartmentMapping().size();
+    database.saveContentsToFile();
+
+    MappedDataFile converted(path);
+    std::cout << "Converted " << path << ": " << departments
+              << " departments, checkpoint LSN "
+              << converted.getCheckpointLsn() << std::endl;
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}